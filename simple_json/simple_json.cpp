@@ -2,381 +2,470 @@
 // Copyright John W. Wilkinson 2025
 
 #include "simple_json.h"
+#include "simple_json_detail.h"
+#include "simple_json_parser.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
 #include <charconv>
+#include <cstring>
 #include <iostream>
 #include <optional>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 using namespace simple_json;
 using namespace std;
 
-namespace
+expected<Value, string> simple_json::parse( const std::string& json_str )
+{
+    return detail::Parser<false>( json_str ).parse_completely();
+}
+
+expected<Value, string> simple_json::parse( const std::string& json_str, const ParseOptions& options )
+{
+    return detail::Parser<false>( json_str, options ).parse_completely();
+}
+
+expected<Value, string> simple_json::parse( const std::string& json_str, ParseStats& stats )
+{
+    return parse( json_str, ParseOptions(), stats );
+}
+
+expected<Value, string> simple_json::parse( const std::string& json_str, const ParseOptions& options, ParseStats& stats )
+{
+    detail::Parser<true> parser( json_str, options );
+    auto result = parser.parse_completely();
+    stats = parser.stats();
+    return result;
+}
+
+// An open addressing hash table of the positions of the members of an OrderedObject by name,
+// with only the first member of each name indexed.
+//
+class OrderedObject::Index
 {
-    class Parser
+  public:
+    explicit Index( const vector<value_type>& members )
+        : slots_( std::bit_ceil( 2 * members.size() + 2 ) )
     {
-      public:
-        Parser( const string& json_str )
-            : posn_( json_str.begin() ),
-              end_( json_str.end() )
+        for ( size_t pos = 0; pos < members.size(); ++pos )
         {
+            insert( members, pos );
         }
+    }
 
-        std::expected<Value, std::string> parse_completely()
+    // returns the position of the first member with the name, or members.size() if there is none
+    //
+    size_t find( const vector<value_type>& members, string_view name ) const
+    {
+        for ( size_t slot = first_slot( name );; slot = next_slot( slot ) )
         {
-            auto result = parse_value();
-
-            if ( result )
+            if ( slots_[ slot ] == 0 )
             {
-                // Check that we have consumed the entire input string
-                skip_whitespace();
-                if ( posn_() != end_ )
-                {
-                    return std::unexpected( "unprocessed data" + where() );
-                }
+                return members.size();
+            }
+            if ( members[ slots_[ slot ] - 1 ].first == name )
+            {
+                return slots_[ slot ] - 1;
             }
-
-            return result;
         }
+    }
 
-      private:
-        std::expected<Value, std::string> parse_value()
+    // indexes the member at pos, unless an earlier member has the same name
+    //
+    void insert( const vector<value_type>& members, size_t pos )
+    {
+        if ( 2 * ( used_ + 1 ) > slots_.size() )
         {
-            skip_whitespace();
+            grow( members );
+        }
 
-            if ( posn_() == end_ )
-            {
-                return std::unexpected( "end of string reached while looking for value" + where() );
-            }
-            if ( *posn_() == '{' )
-            {
-                return parse_object();
-            }
-            if ( *posn_() == '[' )
-            {
-                return parse_array();
-            }
-            if ( *posn_() == '"' )
-            {
-                return parse_string();
-            }
-            if ( *posn_() == 't' )
-            {
-                return parse_true();
-            }
-            if ( *posn_() == 'f' )
-            {
-                return parse_false();
-            }
-            if ( *posn_() == 'n' )
-            {
-                return parse_null();
-            }
-            if ( isdigit( *posn_() ) || *posn_() == '-' )
+        size_t slot = first_slot( members[ pos ].first );
+        for ( ; slots_[ slot ] != 0; slot = next_slot( slot ) )
+        {
+            if ( members[ slots_[ slot ] - 1 ].first == members[ pos ].first )
             {
-                return parse_integer();
+                return;
             }
-            return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
         }
+        slots_[ slot ] = static_cast<uint32_t>( pos + 1 );
+        ++used_;
+    }
 
-        std::expected<Array, std::string> parse_array()
-        {
-            Array arr;
+  private:
+    size_t first_slot( string_view name ) const
+    {
+        return hash<string_view>()( name ) & ( slots_.size() - 1 );
+    }
 
-            posn_.incr(); // skip opening '['
+    size_t next_slot( size_t slot ) const
+    {
+        return ( slot + 1 ) & ( slots_.size() - 1 );
+    }
 
-            skip_whitespace();
+    void grow( const vector<value_type>& members )
+    {
+        vector<uint32_t> old_slots( slots_.size() * 2 );
+        old_slots.swap( slots_ );
 
-            if ( posn_() == end_ )
+        for ( const uint32_t entry : old_slots )
+        {
+            if ( entry != 0 )
             {
-                return std::unexpected( "missing closing ']'" + where() );
+                size_t slot = first_slot( members[ entry - 1 ].first );
+                while ( slots_[ slot ] != 0 )
+                {
+                    slot = next_slot( slot );
+                }
+                slots_[ slot ] = entry;
             }
+        }
+    }
 
-            if ( *posn_() == ']' )
-            {
-                posn_.incr(); // end of object, skip closing ']'
-                return arr;
-            }
+    vector<uint32_t> slots_; // the position of a member plus one, or 0 for an empty slot
+    size_t used_ = 0;
+};
 
-            while ( true )
-            {
-                expected<Value, string> value = parse_value();
+namespace
+{
+    // objects up to this size are searched linearly, without building an index
+    //
+    const size_t min_indexed_members = 8;
+} // namespace
 
-                if ( !value )
-                {
-                    return std::unexpected( value.error() );
-                }
+OrderedObject::OrderedObject( std::initializer_list<value_type> members )
+    : members_( members )
+{
+}
 
-                arr.push_back( std::move( *value ) );
+OrderedObject::OrderedObject( const OrderedObject& other )
+    : members_( other.members_ )
+{
+}
 
-                skip_whitespace();
+OrderedObject::OrderedObject( OrderedObject&& other ) noexcept
+    : members_( std::move( other.members_ ) ),
+      index_( other.index_.exchange( nullptr ) )
+{
+}
 
-                if ( posn_() == end_ )
-                {
-                    return std::unexpected( "missing closing ']'" + where() );
-                }
+OrderedObject& OrderedObject::operator=( const OrderedObject& other )
+{
+    if ( this != &other )
+    {
+        members_ = other.members_;
+        delete index_.exchange( nullptr );
+    }
+    return *this;
+}
 
-                if ( *posn_() == ']' )
-                {
-                    posn_.incr();
-                    break; // end of array
-                }
+OrderedObject& OrderedObject::operator=( OrderedObject&& other ) noexcept
+{
+    if ( this != &other )
+    {
+        members_ = std::move( other.members_ );
+        delete index_.exchange( other.index_.exchange( nullptr ) );
+    }
+    return *this;
+}
 
-                if ( *posn_() == ',' )
-                {
-                    posn_.incr(); // skip ','
-                }
-                else
-                {
-                    return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
-                }
-            }
-            return arr;
-        }
+OrderedObject::~OrderedObject()
+{
+    delete index_.load();
+}
 
-        std::expected<Object, std::string> parse_object()
+const OrderedObject::Index* OrderedObject::index() const
+{
+    Index* index = index_.load( std::memory_order_acquire );
+    if ( !index && members_.size() > min_indexed_members )
+    {
+        // another thread may be building the index too, the first one to finish wins
+        Index* new_index = new Index( members_ );
+        if ( index_.compare_exchange_strong( index, new_index, std::memory_order_acq_rel ) )
         {
-            Object obj;
+            index = new_index;
+        }
+        else
+        {
+            delete new_index;
+        }
+    }
+    return index;
+}
 
-            posn_.incr(); // skip opening '{'
+OrderedObject::const_iterator OrderedObject::find( std::string_view name ) const
+{
+    if ( const Index* index = this->index() )
+    {
+        return members_.begin() + index->find( members_, name );
+    }
+    return std::find_if( members_.begin(), members_.end(), [ & ]( const value_type& member ) { return member.first == name; } );
+}
 
-            while ( true )
-            {
-                skip_whitespace();
+OrderedObject::iterator OrderedObject::find( std::string_view name )
+{
+    return members_.begin() + ( std::as_const( *this ).find( name ) - members_.cbegin() );
+}
 
-                if ( posn_() == end_ )
-                {
-                    return std::unexpected( "missing closing '}'" + where() );
-                }
+OrderedObject::value_type& OrderedObject::emplace_back( std::string name, Value value )
+{
+    members_.emplace_back( std::move( name ), std::move( value ) );
+    if ( Index* index = index_.load() )
+    {
+        index->insert( members_, members_.size() - 1 );
+    }
+    return members_.back();
+}
 
-                if ( *posn_() == '}' )
-                {
-                    posn_.incr();
-                    break; // end of object
-                }
+pair<OrderedObject::iterator, bool> OrderedObject::insert_or_assign( std::string_view name, Value value )
+{
+    const auto it = find( name );
+    if ( it != members_.end() )
+    {
+        it->second = std::move( value );
+        return { it, false };
+    }
+    emplace_back( std::string( name ), std::move( value ) );
+    return { members_.end() - 1, true };
+}
 
-                if ( *posn_() == '"' )
-                {
-                    expected<Object::value_type, string> pair = parse_pair();
-                    if ( !pair )
-                    {
-                        return std::unexpected( pair.error() );
-                    }
+OrderedObject::iterator OrderedObject::insert( const_iterator pos, std::string name, Value value )
+{
+    delete index_.exchange( nullptr ); // the positions from pos on change, so the index is rebuilt when next needed
+    return members_.emplace( pos, std::move( name ), std::move( value ) );
+}
 
-                    obj.insert( std::move( *pair ) );
-                }
-                else if ( *posn_() == ',' )
-                {
-                    posn_.incr(); // skip ','
-                }
-                else
-                {
-                    return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
-                }
-            }
+OrderedObject::iterator OrderedObject::erase( const_iterator pos )
+{
+    delete index_.exchange( nullptr ); // the positions after pos change, so the index is rebuilt when next needed
+    return members_.erase( pos );
+}
+
+std::optional<string> OrderedObject::remove_duplicates( bool keep_last )
+{
+    std::optional<string> first_removed;
+    vector<bool> removed;
 
-            return obj;
+    for ( size_t pos = 0; pos < members_.size(); ++pos )
+    {
+        const size_t first = std::as_const( *this ).find( members_[ pos ].first ) - members_.cbegin();
+        if ( first != pos )
+        {
+            if ( !first_removed )
+            {
+                first_removed = members_[ pos ].first;
+                removed.resize( members_.size() );
+            }
+            if ( keep_last )
+            {
+                members_[ first ].second = std::move( members_[ pos ].second );
+            }
+            removed[ pos ] = true;
         }
+    }
 
-        void skip( int ( *pred )( int ) )
+    if ( first_removed )
+    {
+        size_t kept = 0;
+        for ( size_t pos = 0; pos < members_.size(); ++pos )
         {
-            for ( ; posn_() != end_; posn_.incr() )
+            if ( !removed[ pos ] )
             {
-                if ( !pred( *posn_() ) )
+                if ( kept != pos )
                 {
-                    break;
+                    members_[ kept ] = std::move( members_[ pos ] );
                 }
+                ++kept;
             }
         }
+        members_.erase( members_.begin() + kept, members_.end() );
+        delete index_.exchange( nullptr );
+    }
+    return first_removed;
+}
 
-        void skip_whitespace()
+namespace
+{
+    // converts the text of a RawNumber to an integer type, which fails for numbers with a fraction or exponent
+    //
+    template <typename T>
+    expected<T, string> to_integer( const string& text, const char* type_name )
+    {
+        if ( text.find_first_of( ".eE" ) != string::npos )
         {
-            skip( std::isspace );
+            return std::unexpected( "\"" + text + "\" is not an integer" );
         }
 
-        expected<Object::value_type, string> parse_pair()
+        T value;
+        const auto [ ptr, ec ] = std::from_chars( text.data(), text.data() + text.size(), value );
+        if ( ec == std::errc() )
         {
-            expected<string, string> name = parse_string();
+            return value;
+        }
+        return std::unexpected( "\"" + text + "\" is out of range for " + type_name ); // including negative for an unsigned type
+    }
 
-            if ( !name )
-            {
-                return std::unexpected( name.error() );
-            }
+    // true if the absolute value of a valid JSON number is less than one, counting its digits rather than converting it
+    //
+    bool magnitude_below_one( const string& text )
+    {
+        const size_t exponent_posn = std::min( text.find_first_of( "eE" ), text.size() );
+        const size_t point = std::min( text.find( '.' ), exponent_posn );
+        const size_t first_digit = text.find_first_of( "123456789" );
+        if ( first_digit >= exponent_posn )
+        {
+            return true; // zero
+        }
 
-            skip_whitespace();
+        // the power of ten above the first significant digit, before the exponent is applied
+        int64_t order = first_digit < point ? static_cast<int64_t>( point - first_digit ) : static_cast<int64_t>( point ) + 1 - static_cast<int64_t>( first_digit );
 
-            if ( posn_() == end_ || *posn_() != ':' )
+        if ( exponent_posn < text.size() )
+        {
+            const char* exponent_start = text.data() + exponent_posn + 1;
+            const bool negative = *exponent_start == '-';
+            if ( *exponent_start == '+' || negative )
             {
-                return std::unexpected( "missing ':'" + where() );
+                ++exponent_start;
             }
-
-            posn_.incr();
-
-            skip_whitespace();
-
-            if ( posn_() == end_ )
+            int64_t exponent;
+            const auto [ ptr, ec ] = std::from_chars( exponent_start, text.data() + text.size(), exponent );
+            if ( ec != std::errc() )
             {
-                return std::unexpected( "end of string reached while looking for second of pair" + where() );
+                return negative; // the exponent alone is beyond any number of digits
             }
-
-            // Create and return a pair with the parsed name and value.
-            // Note if parse_value() fails, the error will be propagated.
-            return parse_value().transform( [ & ]( const auto& value ) {
-                return Object::value_type{ std::move( *name ), std::move( value ) };
-            } );
+            order += negative ? -exponent : exponent;
         }
+        return order <= 0;
+    }
+} // namespace
 
-        expected<string, string> parse_string()
-        {
-            posn_.incr(); // Skip the opening '"'
-
-            string result;
-
-            bool prev_esc = false;
-
-            for ( ; posn_() != end_; posn_.incr() ) // we don't want to skip whitespace here
-            {
-                if ( prev_esc )
-                {
-                    const char* alph_esc_chars = "bfnrt\"\\/";     // alphabetic escape characters
-                    const char* bin_esc_chars = "\b\f\n\r\t\"\\/"; // their binary equivalents
+expected<int64_t, string> RawNumber::to_int64() const
+{
+    return to_integer<int64_t>( text_, "an int64_t" );
+}
 
-                    const char* esc_pos = strchr( alph_esc_chars, *posn_() );
-                    if ( esc_pos == nullptr )
-                    {
-                        return std::unexpected( string( "invalid escape character '\\" ) + *posn_() + "'" + where() );
-                    }
+expected<uint64_t, string> RawNumber::to_uint64() const
+{
+    return to_integer<uint64_t>( text_, "a uint64_t" );
+}
 
-                    result.push_back( bin_esc_chars[ esc_pos - &alph_esc_chars[ 0 ] ] );
+expected<double, string> RawNumber::to_double() const
+{
+    double value;
+    const auto [ ptr, ec ] = std::from_chars( text_.data(), text_.data() + text_.size(), value );
+    if ( ec == std::errc::result_out_of_range )
+    {
+        if ( !magnitude_below_one( text_ ) )
+        {
+            return std::unexpected( "\"" + text_ + "\" is out of range for a double" );
+        }
+        return text_.front() == '-' ? -0.0 : 0.0; // too small for a double, so rounds to zero
+    }
+    return value;
+}
 
-                    prev_esc = false;
-                }
-                else if ( *posn_() == '"' )
-                {
-                    posn_.incr(); // Skip the closing '"'
+namespace
+{
+    // true if the members, each in name order, have the same names and values
+    //
+    template <typename A, typename B>
+    bool equal_members( const A& a, const B& b )
+    {
+        return std::ranges::equal( a, b, []( const auto& x, const auto& y ) { return x.first == y.first && x.second == y.second; } );
+    }
 
-                    return result;
-                }
-                else if ( *posn_() == '\\' )
-                {
-                    prev_esc = true;
-                }
-                else
-                {
-                    result.push_back( *posn_() );
-                }
-            }
+    bool equal_integer( const RawNumber& n, int64_t i )
+    {
+        const auto n_int = n.to_int64();
+        return n_int && *n_int == i;
+    }
 
-            return std::unexpected( "missing closing '\"'" + where() );
+    bool equal_integer( const Value& value, int64_t i )
+    {
+        if ( const int64_t* value_int = get_if<int64_t>( &value ) )
+        {
+            return *value_int == i;
         }
+        const RawNumber* n = get_if<RawNumber>( &value );
+        return n && equal_integer( *n, i );
+    }
 
-        expected<int64_t, string> parse_integer()
+    // compares the alternatives of two Values as JSON
+    //
+    struct JsonEqual
+    {
+        template <typename T>
+        bool operator()( const T& a, const T& b ) const
         {
-            const string::const_iterator int_start = posn_();
-
-            posn_.incr(); // Skip the first character, possibly a '-'
-
-            skip( isdigit );
+            return a == b;
+        }
 
-            const string::const_iterator int_end = posn_();
+        template <typename T, typename U>
+        bool operator()( const T&, const U& ) const
+        {
+            return false;
+        }
 
-            int64_t value;
-            auto [ ptr, ec ] = std::from_chars( &*int_start, &*int_start + ( int_end - int_start ), value );
-            if ( ec == std::errc() )
-            {
-                return value;
-            }
+        bool operator()( int64_t a, const RawNumber& b ) const
+        {
+            return equal_integer( b, a );
+        }
 
-            return std::unexpected( "could not convert \"" + string( int_start, int_end ) + "\" to an integer" + where() );
+        bool operator()( const RawNumber& a, int64_t b ) const
+        {
+            return equal_integer( a, b );
         }
 
-        expected<void, string> parse_word( const string& word )
+        bool operator()( const RawNumber& a, const RawNumber& b ) const
         {
-            const size_t len = word.length();
-            if ( end_ - posn_() >= len && string( posn_(), posn_() + len ) == word )
+            const auto a_int = a.to_int64();
+            const auto b_int = b.to_int64();
+            if ( a_int && b_int )
             {
-                posn_.incr( len ); // specified word found, skip over it
-                return {};
+                return *a_int == *b_int; // so -0 equals 0, as both equal the integer 0
             }
-            return std::unexpected( "expected \"" + word + "\"" + where() );
+            return a.text() == b.text();
         }
 
-        expected<bool, string> parse_true()
+        bool operator()( const Array& a, const IntArray& b ) const
         {
-            return parse_word( "true" ).transform( []() { return true; } ); // if parse_word() fails, the error will be propagated.
+            return std::ranges::equal( a, b, []( const Value& x, int64_t y ) { return equal_integer( x, y ); } );
         }
 
-        expected<bool, string> parse_false()
+        bool operator()( const IntArray& a, const Array& b ) const
         {
-            return parse_word( "false" ).transform( []() { return false; } ); // if parse_word() fails, the error will be propagated.
+            return ( *this )( b, a );
         }
 
-        expected<Null, string> parse_null()
+        bool operator()( const Object& a, const OrderedObject& b ) const
         {
-            return parse_word( "null" ).transform( []() { return Null(); } ); // if parse_word() fails, the error will be propagated.
+            return equal_members( a, detail::sorted_members( b ) );
         }
 
-        string where() const
+        bool operator()( const OrderedObject& a, const Object& b ) const
         {
-            return posn_.where();
+            return ( *this )( b, a );
         }
-
-        // Helper class to keep track of the current position in the input string
-        // and the line and column numbers.
-        // This is used to provide better error messages.
-        //
-        class Position
-        {
-          public:
-            Position( const string::const_iterator& start )
-                : iter_( start )
-            {
-            }
-
-            void incr()
-            {
-                if ( *iter_ == '\n' )
-                {
-                    ++line_;
-                    column_ = 0;
-                }
-                else
-                {
-                    ++column_;
-                }
-                ++iter_;
-            }
-
-            void incr( size_t num_chars )
-            {
-                for ( int i = 0; i < num_chars; ++i )
-                {
-                    incr();
-                }
-            }
-
-            string::const_iterator operator()() const
-            {
-                return iter_;
-            }
-
-            string where() const
-            {
-                return " at line " + to_string( line_ + 1 ) + " column " + to_string( column_ + 1 );
-            }
-
-          private:
-            string::const_iterator iter_;
-            int line_ = 0;
-            int column_ = 0;
-        };
-
-        Position posn_;              // Current position in the input string
-        string::const_iterator end_; // End of the input string
     };
 } // namespace
 
-expected<Value, string> simple_json::parse( const std::string& json_str )
+bool simple_json::operator==( const Value& a, const Value& b )
 {
-    return Parser( json_str ).parse_completely();
+    return std::visit( JsonEqual(), a, b );
+}
+
+bool OrderedObject::operator==( const OrderedObject& other ) const
+{
+    return equal_members( detail::sorted_members( *this ), detail::sorted_members( other ) );
 }
 
 namespace
@@ -386,6 +475,8 @@ namespace
     class Formatter
     {
       public:
+        Formatter() = default;
+
         Formatter( const Value& value )
         {
             format( value, 0 );
@@ -396,51 +487,41 @@ namespace
             return str_;
         }
 
-      private:
-        void format( const Object::value_type& member, const int level )
+        string& str()
         {
-            format( member.first );
-
-            str_ += " : ";
-
-            format( member.second, level + 1 );
+            return str_;
         }
 
-        void format( const string& s )
+        // Formats a range of the members of an Object or OrderedObject at the given level, exactly as they
+        // would appear within the object. "first" is true if the range starts at the first member.
+        //
+        template <typename Iterator>
+        void format_members( Iterator begin, Iterator end, int level, bool first )
         {
-            const char* alph_esc_chars = "bfnrt";     // alphabetic escape characters
-            const char* bin_esc_chars = "\b\f\n\r\t"; // their binary equivalents
-
-            str_ += '"';
-
-            for ( const char c : s )
+            for ( auto it = begin; it != end; ++it )
             {
-                if ( c == '"' || c == '\\' || c == '/' )
-                {
-                    // add escape quotes and backslashes
-                    str_ += '\\'; 
-                    str_ += c;
-                }
-                else if ( const char* pos = strchr( bin_esc_chars, c ) ) // non-printable characters
+                if ( first )
                 {
-                    str_ += '\\';
-                    str_ += alph_esc_chars[ pos - &bin_esc_chars[ 0 ] ];
+                    first = false;
                 }
                 else
                 {
-                    str_ += c; // printable character
+                    str_ += ",\n";
                 }
-            }
 
-            str_ += '"';
+                indent( level + 1 );
+
+                format( *it, level );
+            }
         }
 
-        void format( const Object& obj, int level )
+        // Formats a range of the elements of an Array or IntArray at the given level, exactly as they
+        // would appear within the Array. "first" is true if the range starts at the first element.
+        //
+        template <typename Iterator>
+        void format_elements( Iterator begin, Iterator end, int level, bool first )
         {
-            str_ += "{\n";
-
-            int first = true;
-            for ( const auto& member : obj )
+            for ( auto it = begin; it != end; ++it )
             {
                 if ( first )
                 {
@@ -448,45 +529,60 @@ namespace
                 }
                 else
                 {
-                    str_ += ",\n";
+                    str_ += ", ";
                 }
 
-                indent( level + 1 );
-
-                format( member, level );
+                format( *it, level + 1 );
             }
+        }
+
+      private:
+        template <typename Name>
+        void format( const std::pair<Name, Value>& member, const int level )
+        {
+            format( member.first );
+
+            str_ += " : ";
+
+            format( member.second, level + 1 );
+        }
+
+        void format( const string& s )
+        {
+            detail::append_quoted( str_, s );
+        }
+
+        template <typename Obj>
+        void format_object( const Obj& obj, int level )
+        {
+            str_ += "{\n";
+
+            format_members( obj.begin(), obj.end(), level, true );
 
             str_ += '\n';
             indent( level );
             str_ += '}';
         }
 
-        void format( const Array& arr, int level )
+        template <typename Container>
+        void format( const Container& arr, int level )
         {
             str_ += "[\n";
 
             indent( level + 1 );
 
-            int first = true;
-            for ( const auto& value : arr )
-            {
-                if ( first )
-                {
-                    first = false;
-                }
-                else
-                {
-                    str_ += ", ";
-                }
-
-                format( value, level + 1 );
-            }
+            format_elements( arr.begin(), arr.end(), level, true );
 
             str_ += '\n';
             indent( level );
             str_ += ']';
         }
 
+        void format( int64_t i, int )
+        {
+            str_ += to_string( i );
+        }
+
         void format( const Value& value, const int level )
         {
             struct Visitor
@@ -499,15 +595,23 @@ namespace
                 }
                 void operator()( const Object& obj )
                 {
-                    formatter->format( obj, level );
+                    formatter->format_object( obj, level );
+                }
+                void operator()( const OrderedObject& obj )
+                {
+                    formatter->format_object( obj, level );
                 }
                 void operator()( const Array& arr )
                 {
                     formatter->format( arr, level );
                 }
+                void operator()( const IntArray& arr )
+                {
+                    formatter->format( arr, level );
+                }
                 void operator()( int64_t i )
                 {
-                    formatter->str_ += to_string( i );
+                    formatter->format( i, level );
                 }
                 void operator()( bool b )
                 {
@@ -517,6 +621,10 @@ namespace
                 {
                     formatter->str_ += "null";
                 }
+                void operator()( const RawNumber& n )
+                {
+                    formatter->str_ += n.text();
+                }
             };
 
             std::visit( Visitor{ this, level }, value );
@@ -524,15 +632,283 @@ namespace
 
         void indent( int level )
         {
-            for ( int i = 0; i < level; ++i )
+            detail::append_spaces( str_, 4 * level );
+        }
+        string str_;
+    };
+} // namespace
+
+namespace
+{
+    // Streaming XXH64, so that a hash can be computed from text as it is generated.
+    //
+    class Hasher
+    {
+      public:
+        explicit Hasher( uint64_t seed = 0 )
+            : acc_{ seed + prime_1 + prime_2, seed + prime_2, seed, seed - prime_1 },
+              seed_( seed )
+        {
+        }
+
+        void push_back( char c )
+        {
+            append( &c, 1 );
+        }
+
+        void append( const char* data, size_t size )
+        {
+            total_size_ += size;
+
+            if ( buffered_ + size < stripe_size )
             {
-                str_ += "    ";
+                memcpy( buffer_ + buffered_, data, size );
+                buffered_ += size;
+                return;
             }
+
+            if ( buffered_ > 0 )
+            {
+                const size_t fill = stripe_size - buffered_;
+                memcpy( buffer_ + buffered_, data, fill );
+                consume( buffer_ );
+                data += fill;
+                size -= fill;
+                buffered_ = 0;
+            }
+
+            for ( ; size >= stripe_size; data += stripe_size, size -= stripe_size )
+            {
+                consume( reinterpret_cast<const unsigned char*>( data ) );
+            }
+
+            memcpy( buffer_, data, size );
+            buffered_ = size;
         }
-        string str_;
+
+        uint64_t digest() const
+        {
+            uint64_t h;
+            if ( total_size_ >= stripe_size )
+            {
+                h = rotl( acc_[ 0 ], 1 ) + rotl( acc_[ 1 ], 7 ) + rotl( acc_[ 2 ], 12 ) + rotl( acc_[ 3 ], 18 );
+                for ( const uint64_t acc : acc_ )
+                {
+                    h = ( h ^ round( 0, acc ) ) * prime_1 + prime_4;
+                }
+            }
+            else
+            {
+                h = seed_ + prime_5;
+            }
+
+            h += total_size_;
+
+            const unsigned char* p = buffer_;
+            size_t remaining = buffered_;
+            for ( ; remaining >= 8; p += 8, remaining -= 8 )
+            {
+                h ^= round( 0, read<uint64_t>( p ) );
+                h = rotl( h, 27 ) * prime_1 + prime_4;
+            }
+            if ( remaining >= 4 )
+            {
+                h ^= read<uint32_t>( p ) * prime_1;
+                h = rotl( h, 23 ) * prime_2 + prime_3;
+                p += 4;
+                remaining -= 4;
+            }
+            for ( ; remaining > 0; ++p, --remaining )
+            {
+                h ^= *p * prime_5;
+                h = rotl( h, 11 ) * prime_1;
+            }
+
+            h ^= h >> 33;
+            h *= prime_2;
+            h ^= h >> 29;
+            h *= prime_3;
+            h ^= h >> 32;
+            return h;
+        }
+
+      private:
+        static constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ULL;
+        static constexpr uint64_t prime_2 = 0xC2B2AE3D27D4EB4FULL;
+        static constexpr uint64_t prime_3 = 0x165667B19E3779F9ULL;
+        static constexpr uint64_t prime_4 = 0x85EBCA77C2B2AE63ULL;
+        static constexpr uint64_t prime_5 = 0x27D4EB2F165667C5ULL;
+        static constexpr size_t stripe_size = 32;
+
+        static uint64_t rotl( uint64_t x, int r )
+        {
+            return ( x << r ) | ( x >> ( 64 - r ) );
+        }
+
+        template <typename T>
+        static T read( const unsigned char* p )
+        {
+            T value;
+            memcpy( &value, p, sizeof( value ) ); // XXH64 is defined for little endian reads
+            return value;
+        }
+
+        static uint64_t round( uint64_t acc, uint64_t input )
+        {
+            return rotl( acc + input * prime_2, 31 ) * prime_1;
+        }
+
+        void consume( const unsigned char* stripe )
+        {
+            for ( int i = 0; i < 4; ++i )
+            {
+                acc_[ i ] = round( acc_[ i ], read<uint64_t>( stripe + 8 * i ) );
+            }
+        }
+
+        uint64_t acc_[ 4 ];
+        uint64_t seed_;
+        uint64_t total_size_ = 0;
+        unsigned char buffer_[ stripe_size ];
+        size_t buffered_ = 0;
+    };
+
+    // Writes a value in canonical form, i.e. without whitespace and with members in name order
+    // (Object already keeps them in that order, an OrderedObject is sorted), to a Sink such as a std::string or a Hasher.
+    //
+    template <typename Sink>
+    class CanonicalFormatter
+    {
+      public:
+        CanonicalFormatter( Sink& sink )
+            : sink_( sink )
+        {
+        }
+
+        void format( const Value& value )
+        {
+            std::visit( *this, value );
+        }
+
+        void operator()( const string& s )
+        {
+            detail::append_quoted( sink_, s );
+        }
+
+        void operator()( const Object& obj )
+        {
+            format_members( obj );
+        }
+
+        void operator()( const OrderedObject& obj )
+        {
+            format_members( detail::sorted_members( obj ) );
+        }
+
+        void operator()( const Array& arr )
+        {
+            format_elements( arr );
+        }
+
+        void operator()( const IntArray& arr )
+        {
+            format_elements( arr );
+        }
+
+        void operator()( int64_t i )
+        {
+            char buffer[ 24 ];
+            const auto [ end, ec ] = std::to_chars( buffer, buffer + sizeof( buffer ), i );
+            sink_.append( buffer, end - buffer );
+        }
+
+        void operator()( bool b )
+        {
+            b ? sink_.append( "true", 4 ) : sink_.append( "false", 5 );
+        }
+
+        void operator()( const Null& )
+        {
+            sink_.append( "null", 4 );
+        }
+
+        void operator()( const RawNumber& n )
+        {
+            if ( const auto i = n.to_int64() )
+            {
+                ( *this )( *i ); // as the integer it equals
+            }
+            else
+            {
+                sink_.append( n.text().data(), n.text().size() );
+            }
+        }
+
+      private:
+        void format( int64_t i )
+        {
+            ( *this )( i );
+        }
+
+        template <typename Members>
+        void format_members( const Members& members )
+        {
+            sink_.push_back( '{' );
+            bool first = true;
+            for ( const auto& member : members )
+            {
+                if ( !first )
+                {
+                    sink_.push_back( ',' );
+                }
+                first = false;
+                detail::append_quoted( sink_, member.first );
+                sink_.push_back( ':' );
+                format( member.second );
+            }
+            sink_.push_back( '}' );
+        }
+
+        template <typename Container>
+        void format_elements( const Container& arr )
+        {
+            sink_.push_back( '[' );
+            for ( auto it = arr.begin(); it != arr.end(); ++it )
+            {
+                if ( it != arr.begin() )
+                {
+                    sink_.push_back( ',' );
+                }
+                format( *it );
+            }
+            sink_.push_back( ']' );
+        }
+
+        Sink& sink_;
     };
 } // namespace
 
+string simple_json::to_canonical_string( const Value& value )
+{
+    string result;
+    CanonicalFormatter( result ).format( value );
+    return result;
+}
+
+uint64_t simple_json::hash_bytes( std::string_view bytes, uint64_t seed )
+{
+    Hasher hasher( seed );
+    hasher.append( bytes.data(), bytes.size() );
+    return hasher.digest();
+}
+
+size_t simple_json::hash_value( const Value& value )
+{
+    Hasher hasher;
+    CanonicalFormatter( hasher ).format( value );
+    return static_cast<size_t>( hasher.digest() );
+}
+
 std::ostream&
 simple_json::operator<<( std::ostream& os, const simple_json::Value& value )
 {
@@ -540,3 +916,160 @@ simple_json::operator<<( std::ostream& os, const simple_json::Value& value )
     os << formatter.str();
     return os;
 }
+
+namespace
+{
+    // Top level containers are only split between threads if each thread gets at least this many elements,
+    // below that the cost of starting a thread outweighs the formatting work.
+    //
+    const size_t min_elements_per_thread = 1024;
+
+    unsigned num_chunks( size_t num_elements, unsigned num_threads )
+    {
+        if ( num_threads == 0 )
+        {
+            num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+        }
+        return static_cast<unsigned>( std::min<size_t>( num_threads, std::max<size_t>( 1, num_elements / min_elements_per_thread ) ) );
+    }
+
+    // Formats each range [bounds[i], bounds[i+1]) on its own thread into its own buffer.
+    // The returned buffers are "open", one per range, then "close".
+    //
+    template <typename Iter, typename Format_range>
+    vector<string> format_ranges( const vector<Iter>& bounds, const char* open, const char* close, Format_range format_range )
+    {
+        vector<string> buffers( bounds.size() + 1 );
+
+        buffers.front() = open;
+        {
+            vector<jthread> threads;
+            for ( size_t i = 1; i + 1 < bounds.size(); ++i )
+            {
+                threads.emplace_back( [ &, i ]() { buffers[ i + 1 ] = format_range( bounds[ i ], bounds[ i + 1 ], false ); } );
+            }
+            buffers[ 1 ] = format_range( bounds[ 0 ], bounds[ 1 ], true ); // the first range on this thread
+
+        } // threads are joined here
+        buffers.back() = close;
+
+        return buffers;
+    }
+
+    // Formats a value into a sequence of buffers which, concatenated in order, are identical to
+    // the output of the Formatter. The elements of a large top level Array or Object are formatted in parallel.
+    //
+    vector<string> format_chunks( const Value& value, unsigned num_threads )
+    {
+        if ( const Array* arr = get_if<Array>( &value ) )
+        {
+            const unsigned n = num_chunks( arr->size(), num_threads );
+            if ( n > 1 )
+            {
+                vector<Array::const_iterator> bounds;
+                for ( unsigned i = 0; i <= n; ++i )
+                {
+                    bounds.push_back( arr->begin() + arr->size() * i / n );
+                }
+
+                return format_ranges( bounds, "[\n    ", "\n]", []( auto begin, auto end, bool first ) {
+                    Formatter formatter;
+                    formatter.format_elements( begin, end, 0, first );
+                    return std::move( formatter.str() );
+                } );
+            }
+        }
+        else if ( const Object* obj = get_if<Object>( &value ) )
+        {
+            const unsigned n = num_chunks( obj->size(), num_threads );
+            if ( n > 1 )
+            {
+                vector<Object::const_iterator> bounds{ obj->begin() };
+                for ( unsigned i = 1; i <= n; ++i )
+                {
+                    bounds.push_back( std::next( bounds.back(), obj->size() * i / n - obj->size() * ( i - 1 ) / n ) );
+                }
+
+                return format_ranges( bounds, "{\n", "\n}", []( auto begin, auto end, bool first ) {
+                    Formatter formatter;
+                    formatter.format_members( begin, end, 0, first );
+                    return std::move( formatter.str() );
+                } );
+            }
+        }
+
+        return { Formatter( value ).str() };
+    }
+} // namespace
+
+string simple_json::format_parallel( const Value& value, unsigned num_threads )
+{
+    const vector<string> buffers = format_chunks( value, num_threads );
+
+    size_t total_size = 0;
+    for ( const string& buffer : buffers )
+    {
+        total_size += buffer.size();
+    }
+
+    string result;
+    result.reserve( total_size );
+    for ( const string& buffer : buffers )
+    {
+        result += buffer;
+    }
+    return result;
+}
+
+expected<void, string> simple_json::write_parallel( int fd, const Value& value, unsigned num_threads )
+{
+    const vector<string> buffers = format_chunks( value, num_threads );
+
+#ifdef _WIN32
+    for ( const string& buffer : buffers )
+    {
+        for ( size_t done = 0; done < buffer.size(); )
+        {
+            const int written = _write( fd, buffer.data() + done, static_cast<unsigned>( buffer.size() - done ) );
+            if ( written < 0 )
+            {
+                return std::unexpected( string( "write failed: " ) + strerror( errno ) );
+            }
+            done += written;
+        }
+    }
+#else
+    vector<iovec> iov;
+    for ( const string& buffer : buffers )
+    {
+        iov.push_back( { const_cast<char*>( buffer.data() ), buffer.size() } );
+    }
+
+    for ( size_t next = 0; next < iov.size(); )
+    {
+        const ssize_t written = ::writev( fd, &iov[ next ], static_cast<int>( std::min<size_t>( iov.size() - next, IOV_MAX ) ) );
+        if ( written < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            return std::unexpected( string( "writev failed: " ) + strerror( errno ) );
+        }
+
+        // skip the buffers written completely, then any part of a buffer written partially
+        size_t remaining = written;
+        for ( ; next < iov.size() && remaining >= iov[ next ].iov_len; ++next )
+        {
+            remaining -= iov[ next ].iov_len;
+        }
+        if ( remaining > 0 )
+        {
+            iov[ next ].iov_base = static_cast<char*>( iov[ next ].iov_base ) + remaining;
+            iov[ next ].iov_len -= remaining;
+        }
+    }
+#endif
+
+    return {};
+}
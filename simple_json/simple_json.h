@@ -2,12 +2,22 @@
 // Copyright John W. Wilkinson 2025
 //
 // Parses and formats JSON.
-// Does not support real numbers. No Unicode support.
+// Numbers are integers, except that real numbers can be kept as text with ParseOptions::raw_numbers. No Unicode support.
 
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
 #include <expected>
 #include <map>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 #include <functional>
@@ -16,12 +26,55 @@ namespace simple_json
 {
     struct Object;
     struct Array;
+    struct IntArray;
+    class OrderedObject;
 
     struct Null // a JSON null value.
     {
+        bool operator==( const Null& ) const = default;
     };
 
-    using Value = std::variant<std::string, bool, int64_t, Null, Array, Object>;
+    // The text of a JSON number, kept as it was in the input and only converted when asked.
+    // parse() only creates these if ParseOptions::raw_numbers is set. Numbers too large for an int64_t, and
+    // real numbers, can be read and written back exactly. A RawNumber formats as its text. As a Value it compares
+    // equal to a RawNumber with the same text or for the same int64_t, or to the integer it is written as, but
+    // 1.0 is not equal to 1. RawNumber's own operator== compares only the text.
+    //
+    class RawNumber
+    {
+      public:
+        // the text must be a JSON number, e.g. not "01", "+1" or "1.", which is not checked
+        explicit RawNumber( std::string text )
+            : text_( std::move( text ) )
+        {
+        }
+
+        // the number exactly, as a decimal string
+        const std::string& text() const noexcept
+        {
+            return text_;
+        }
+
+        // converts the number, failing if it is written with a fraction or exponent, or is out of range
+        std::expected<int64_t, std::string> to_int64() const;
+        std::expected<uint64_t, std::string> to_uint64() const;
+
+        // converts the number to the nearest double, failing if it is too large, or giving zero if it is too small
+        std::expected<double, std::string> to_double() const;
+
+        bool operator==( const RawNumber& ) const = default;
+
+      private:
+        std::string text_;
+    };
+
+    using Value = std::variant<std::string, bool, int64_t, Null, Array, Object, IntArray, OrderedObject, RawNumber>;
+
+    // compares two values as JSON, rather than by the alternative they hold as std::variant's operator== does,
+    // so an IntArray equals the Array of the same integers, and an OrderedObject equals an Object or
+    // OrderedObject with the same members in any order
+    //
+    bool operator==( const Value& a, const Value& b );
 
     // A JSON array is a vector of JSON values.
     //
@@ -36,35 +89,460 @@ namespace simple_json
         using std::vector<Value>::vector; // inherit all constructors
     };
 
+    // A JSON array of integers packed without the overhead of a Value per element.
+    // parse() only creates these if ParseOptions::pack_integer_arrays is set. An IntArray formats
+    // the same as the equivalent Array, and compares equal to it.
+    //
+    struct IntArray : public std::vector<int64_t>
+    {
+        using std::vector<int64_t>::vector; // inherit all constructors
+    };
+
     // A JSON object is a map of string/Values pairs.
+    // The comparator is transparent, so members can be found with a std::string_view or a string literal
+    // without constructing a std::string.
     //
-    struct Object : public std::map<std::string, Value>
+    struct Object : public std::map<std::string, Value, std::less<>>
     {
-        using std::map<std::string, Value>::map; // inherit all constructors
+        using std::map<std::string, Value, std::less<>>::map; // inherit all constructors
+    };
+
+    // A JSON object that keeps its members in the order they were added, in a flat vector.
+    // parse() only creates these if ParseOptions::ordered_objects is set. Adding a member appends it
+    // without rebalancing a tree, and find() uses a hash index of the names that is only built on the
+    // first lookup in an object with more than a few members. An OrderedObject formats with its members
+    // in order, but compares equal to an Object with the same members in any order.
+    //
+    // Member names must not be changed through an iterator, erase the member and add it again instead.
+    //
+    class OrderedObject
+    {
+      public:
+        using value_type = std::pair<std::string, Value>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        OrderedObject() = default;
+        OrderedObject( std::initializer_list<value_type> members );
+        OrderedObject( const OrderedObject& other );
+        OrderedObject( OrderedObject&& other ) noexcept;
+        OrderedObject& operator=( const OrderedObject& other );
+        OrderedObject& operator=( OrderedObject&& other ) noexcept;
+        ~OrderedObject();
+
+        iterator begin() noexcept
+        {
+            return members_.begin();
+        }
+        iterator end() noexcept
+        {
+            return members_.end();
+        }
+        const_iterator begin() const noexcept
+        {
+            return members_.begin();
+        }
+        const_iterator end() const noexcept
+        {
+            return members_.end();
+        }
+        size_t size() const noexcept
+        {
+            return members_.size();
+        }
+        bool empty() const noexcept
+        {
+            return members_.empty();
+        }
+        size_t capacity() const noexcept
+        {
+            return members_.capacity();
+        }
+        void reserve( size_t n )
+        {
+            members_.reserve( n );
+        }
+
+        // finds the first member with a name, safe to call from several threads at once
+        iterator find( std::string_view name );
+        const_iterator find( std::string_view name ) const;
+
+        // appends a member, even if there is already one with that name
+        value_type& emplace_back( std::string name, Value value );
+
+        // replaces the value of the first member with the name, or appends a member if there is none
+        std::pair<iterator, bool> insert_or_assign( std::string_view name, Value value );
+
+        // inserts a member before pos, even if there is already one with that name
+        iterator insert( const_iterator pos, std::string name, Value value );
+
+        iterator erase( const_iterator pos );
+
+        // removes each member with the same name as an earlier one, in one pass over the index for a large object,
+        // moving its value to the earlier member if keep_last is set, and returns the name of the first one removed
+        std::optional<std::string> remove_duplicates( bool keep_last );
+
+        // true if the objects have the same members, in any order
+        bool operator==( const OrderedObject& other ) const;
+
+      private:
+        class Index;
+
+        const Index* index() const;
+
+        std::vector<value_type> members_;
+        mutable std::atomic<Index*> index_ = nullptr; // built by the first find() that needs it
     };
 
     // parses a JSON string and return an Object or an error message
     //
     std::expected<Value, std::string> parse( const std::string& json_str );
 
+    // what parse() does with the members of an object that have the same name as an earlier member
+    //
+    enum class DuplicateKeys
+    {
+        keep_first,
+        keep_last, // the value of the last member is kept, at the position of the first for an OrderedObject
+        error
+    };
+
+    struct ParseOptions
+    {
+        bool pack_integer_arrays = false; // store non-empty arrays that only contain integers as IntArrays
+        bool ordered_objects = false;     // store objects as OrderedObjects, with their members in document order
+        DuplicateKeys duplicate_keys = DuplicateKeys::keep_first;
+        bool raw_numbers = false; // store numbers as RawNumbers, allowing real numbers and integers of any size, and no IntArrays
+
+        // Limits for parsing untrusted input, 0 for none. The parse fails as soon as one is exceeded, with an error
+        // saying which. Limiting the depth also limits the parser's recursion, and so its use of the stack.
+        size_t max_depth = 0;              // of nested arrays and objects
+        size_t max_string_bytes = 0;       // of each string and member name, after unescaping
+        size_t max_container_elements = 0; // elements of each array, or members of each object including duplicates
+        size_t max_memory = 0;             // bytes of strings, array elements and object members, by their capacities
+    };
+
+    // parses a JSON string as above, with options
+    //
+    std::expected<Value, std::string> parse( const std::string& json_str, const ParseOptions& options );
+
+    // statistics about a parse, collected by the overload of parse() that takes a ParseStats
+    //
+    struct ParseStats
+    {
+        size_t bytes_consumed = 0; // up to the end of the value, or to the error
+        size_t strings = 0;        // string values, not including member names
+        size_t member_names = 0;
+        size_t booleans = 0;
+        size_t integers = 0;
+        size_t nulls = 0;
+        size_t arrays = 0;
+        size_t objects = 0;
+        size_t max_depth = 0;            // of nested arrays and objects, 0 for a single scalar value
+        size_t string_bytes_copied = 0;  // characters copied unchanged into strings and member names
+        size_t string_bytes_escaped = 0; // characters produced from escape sequences
+        size_t allocations = 0;          // made by the parser for strings, array elements and object members
+        size_t allocated_bytes = 0;
+        std::chrono::nanoseconds total_time{};
+        std::chrono::nanoseconds string_time{}; // parsing strings and member names
+        std::chrono::nanoseconds integer_time{};
+    };
+
+    // parses a JSON string as above, also filling in statistics about the parse, even if it fails
+    // Collecting the statistics slows parsing, the overload without them is unaffected.
+    //
+    std::expected<Value, std::string> parse( const std::string& json_str, ParseStats& stats );
+
+    std::expected<Value, std::string> parse( const std::string& json_str, const ParseOptions& options, ParseStats& stats );
+
     // formats an Object as a JSON string and writes it to the output stream
     //
     std::ostream& operator<<( std::ostream& os, const Value& value );
 
+    // formats a Value as a JSON string, the same as operator<<, but the elements of a large top level
+    // Array or Object are formatted in parallel on up to num_threads threads, 0 meaning one per core
+    //
+    std::string format_parallel( const Value& value, unsigned num_threads = 0 );
+
+    // formats a Value as format_parallel() does, then writes the per thread buffers in order
+    // to a file descriptor with a single gather write (writev) where possible
+    //
+    std::expected<void, std::string> write_parallel( int fd, const Value& value, unsigned num_threads = 0 );
+
+    // formats a Value in canonical form: compact, without whitespace, and with object members in name order,
+    // so equal values always give the same string
+    //
+    std::string to_canonical_string( const Value& value );
+
+    // returns a hash of a Value, the same as hashing its canonical form but without generating the string
+    //
+    size_t hash_value( const Value& value );
+
+    // returns the XXH64 hash of a sequence of bytes
+    //
+    uint64_t hash_bytes( std::string_view bytes, uint64_t seed = 0 );
+
     // helper to get a value from a JSON object
     template <typename T>
-    std::expected<std::reference_wrapper<const T>, std::string> get_value( const simple_json::Object& obj, const std::string& key )
+    std::expected<std::reference_wrapper<const T>, std::string> get_value( const simple_json::Object& obj, std::string_view key )
+    {
+        auto it = obj.find( key );
+        if ( it == obj.end() )
+        {
+            return std::unexpected( "field \"" + std::string( key ) + "\" not found" );
+        }
+        if ( auto ptr = std::get_if<T>( &( it->second ) ) )
+        {
+            return std::cref( *ptr );
+        }
+        return std::unexpected( "field \"" + std::string( key ) + "\" is not the expected type" );
+    }
+
+    // helper to get a value from an ordered JSON object, the first member with the name
+    template <typename T>
+    std::expected<std::reference_wrapper<const T>, std::string> get_value( const simple_json::OrderedObject& obj, std::string_view key )
     {
         auto it = obj.find( key );
         if ( it == obj.end() )
         {
-            return std::unexpected( "field \"" + key + "\" not found" );
+            return std::unexpected( "field \"" + std::string( key ) + "\" not found" );
         }
         if ( auto ptr = std::get_if<T>( &( it->second ) ) )
         {
             return std::cref( *ptr );
         }
-        return std::unexpected( "field \"" + key + "\" is not the expected type" );
+        return std::unexpected( "field \"" + std::string( key ) + "\" is not the expected type" );
+    }
+
+    // finds several members of a JSON object in one ordered pass, returning a pointer to the value of each,
+    // or nullptr if there is no member with that name
+    // The keys may be in any order, but the pass is fastest if they are sorted.
+    //
+    template <size_t N>
+    std::array<const Value*, N> find_members( const simple_json::Object& obj, const std::array<std::string_view, N>& keys )
+    {
+        std::array<size_t, N> order; // the indexes of the keys in sorted order
+        for ( size_t i = 0; i < N; ++i )
+        {
+            order[ i ] = i;
+        }
+        std::sort( order.begin(), order.end(), [ & ]( size_t a, size_t b ) { return keys[ a ] < keys[ b ]; } );
+
+        std::array<const Value*, N> result{};
+
+        auto it = obj.begin();
+        for ( const size_t i : order )
+        {
+            // step forward from the previous member, unless the next one is far away
+            for ( int steps = 0; it != obj.end() && it->first < keys[ i ]; ++it, ++steps )
+            {
+                if ( steps == 8 )
+                {
+                    it = obj.lower_bound( keys[ i ] );
+                    break;
+                }
+            }
+            if ( it != obj.end() && it->first == keys[ i ] )
+            {
+                result[ i ] = &it->second;
+            }
+        }
+
+        return result;
+    }
+
+    namespace detail
+    {
+        template <typename T>
+        std::expected<T, std::string> convert_element( int64_t i, size_t index )
+        {
+            if constexpr ( std::is_integral_v<T> && !std::is_same_v<T, bool> )
+            {
+                if ( !std::in_range<T>( i ) )
+                {
+                    return std::unexpected( "element " + std::to_string( index ) + " is out of range" );
+                }
+                return static_cast<T>( i );
+            }
+            else if constexpr ( std::is_floating_point_v<T> )
+            {
+                return static_cast<T>( i );
+            }
+            else
+            {
+                return std::unexpected( "element " + std::to_string( index ) + " is not the expected type" );
+            }
+        }
+
+        // converts a RawNumber to an integer or floating point type
+        //
+        template <typename T>
+        std::expected<T, std::string> convert_element( const RawNumber& n, size_t index )
+        {
+            if constexpr ( std::is_floating_point_v<T> )
+            {
+                if ( const auto d = n.to_double() )
+                {
+                    return static_cast<T>( *d );
+                }
+            }
+            else if constexpr ( std::is_same_v<T, uint64_t> )
+            {
+                if ( const auto u = n.to_uint64() )
+                {
+                    return *u;
+                }
+            }
+            else if ( const auto i = n.to_int64() )
+            {
+                return convert_element<T>( *i, index );
+            }
+
+            const bool is_integer = n.text().find_first_of( ".eE" ) == std::string::npos;
+            return std::unexpected( "element " + std::to_string( index ) +
+                                    ( is_integer || std::is_floating_point_v<T> ? " is out of range" : " is not the expected type" ) );
+        }
+
+        template <typename T>
+        std::expected<T, std::string> convert_element( const Value& value, size_t index )
+        {
+            if constexpr ( std::is_arithmetic_v<T> && !std::is_same_v<T, bool> )
+            {
+                if ( const int64_t* i = std::get_if<int64_t>( &value ) )
+                {
+                    return convert_element<T>( *i, index );
+                }
+                if ( const RawNumber* n = std::get_if<RawNumber>( &value ) )
+                {
+                    return convert_element<T>( *n, index );
+                }
+            }
+            else if ( const T* ptr = std::get_if<T>( &value ) )
+            {
+                return *ptr;
+            }
+            return std::unexpected( "element " + std::to_string( index ) + " is not the expected type" );
+        }
+    } // namespace detail
+
+    // converts the elements of an array to a vector of T, where T is an integer or floating point type, bool or std::string,
+    // or returns an error giving the index of the first element that is of the wrong type or out of the range of T
+    // Integers and RawNumbers convert to the number types, a RawNumber with a fraction or exponent only to floating point.
+    //
+    template <typename T, typename Container>
+        requires std::is_same_v<Container, Array> || std::is_same_v<Container, IntArray>
+    std::expected<std::vector<T>, std::string> to_vector( const Container& arr )
+    {
+        if constexpr ( std::is_same_v<Container, IntArray> && std::is_same_v<T, int64_t> )
+        {
+            return std::vector<T>( arr.begin(), arr.end() );
+        }
+        else
+        {
+            std::vector<T> result;
+            result.reserve( arr.size() );
+            for ( size_t i = 0; i < arr.size(); ++i )
+            {
+                auto element = detail::convert_element<T>( arr[ i ], i );
+                if ( !element )
+                {
+                    return std::unexpected( std::move( element.error() ) );
+                }
+                result.push_back( std::move( *element ) );
+            }
+            return result;
+        }
+    }
+
+    // helper to get an array member of a JSON object, packed or not, as a vector of T as to_vector() does
+    //
+    template <typename T>
+    std::expected<std::vector<T>, std::string> get_array_as( const simple_json::Object& obj, std::string_view key )
+    {
+        auto it = obj.find( key );
+        if ( it == obj.end() )
+        {
+            return std::unexpected( "field \"" + std::string( key ) + "\" not found" );
+        }
+
+        std::expected<std::vector<T>, std::string> result;
+        if ( const Array* arr = std::get_if<Array>( &it->second ) )
+        {
+            result = to_vector<T>( *arr );
+        }
+        else if ( const IntArray* ints = std::get_if<IntArray>( &it->second ) )
+        {
+            result = to_vector<T>( *ints );
+        }
+        else
+        {
+            return std::unexpected( "field \"" + std::string( key ) + "\" is not an array" );
+        }
+
+        if ( !result )
+        {
+            return std::unexpected( "field \"" + std::string( key ) + "\" " + result.error() );
+        }
+        return result;
+    }
+
+    // helper to get several values of the expected types from a JSON object, e.g.
+    //
+    //     auto fields = get_values<std::string, int64_t>( obj, { "name", "age" } );
+    //     if ( fields )
+    //     {
+    //         auto [ name, age ] = *fields;
+    //
+    // returns an error for the first of the keys that is missing or of the wrong type
+    //
+    template <typename... T>
+    std::expected<std::tuple<std::reference_wrapper<const T>...>, std::string> get_values( const simple_json::Object& obj,
+                                                                                             const std::array<std::string_view, sizeof...( T )>& keys )
+    {
+        const auto values = find_members( obj, keys );
+
+        for ( size_t i = 0; i < values.size(); ++i )
+        {
+            if ( !values[ i ] )
+            {
+                return std::unexpected( "field \"" + std::string( keys[ i ] ) + "\" not found" );
+            }
+        }
+
+        std::string error;
+        auto check = [ & ]<typename U>( const Value* value, size_t i ) -> const U*
+        {
+            const U* ptr = std::get_if<U>( value );
+            if ( !ptr && error.empty() )
+            {
+                error = "field \"" + std::string( keys[ i ] ) + "\" is not the expected type";
+            }
+            return ptr;
+        };
+
+        const auto ptrs = [ & ]<size_t... I>( std::index_sequence<I...> )
+        {
+            return std::tuple<const T*...>{ check.template operator()<T>( values[ I ], I )... };
+        }( std::index_sequence_for<T...>() );
+
+        if ( !error.empty() )
+        {
+            return std::unexpected( error );
+        }
+
+        return std::apply( []( const T*... ptr ) { return std::tuple<std::reference_wrapper<const T>...>{ std::cref( *ptr )... }; }, ptrs );
     }
 
 } // namespace simple_json
+
+// allows a Value to be used as the key of an unordered container.
+// (Values that compare equal have the same canonical form, so the same hash.)
+//
+template <>
+struct std::hash<simple_json::Value>
+{
+    size_t operator()( const simple_json::Value& value ) const
+    {
+        return simple_json::hash_value( value );
+    }
+};
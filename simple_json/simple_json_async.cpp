@@ -0,0 +1,48 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_async.h"
+
+using namespace simple_json;
+using namespace std;
+
+optional<size_t> detail::ValueEndScanner::scan( std::string_view chunk )
+{
+    for ( size_t i = 0; i < chunk.size(); ++i )
+    {
+        const char c = chunk[ i ];
+
+        if ( in_string_ )
+        {
+            if ( escaped_ )
+            {
+                escaped_ = false;
+            }
+            else if ( c == '\\' )
+            {
+                escaped_ = true;
+            }
+            else if ( c == '"' )
+            {
+                in_string_ = false;
+            }
+        }
+        else if ( c == '"' )
+        {
+            in_string_ = true;
+        }
+        else if ( c == '[' || c == '{' )
+        {
+            ++depth_;
+        }
+        else if ( c == ']' || c == '}' )
+        {
+            if ( depth_ <= 1 )
+            {
+                return i + 1; // the end of the top level container, or a stray bracket for parse() to report
+            }
+            --depth_;
+        }
+    }
+    return nullopt;
+}
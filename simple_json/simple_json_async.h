@@ -0,0 +1,319 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Parses and writes JSON with C++20 coroutines, for I/O layers that must not block a thread while waiting for data.
+//
+// The input and output are pulled and pushed through a reader or writer, whose read_some() and write_some() return
+// awaitables that suspend until data can be transferred, e.g. when a non-blocking socket is ready. The parsing and
+// formatting run on an executor supplied by the caller, anything with a post( std::coroutine_handle<> ) member.
+
+#pragma once
+#include "simple_json.h"
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace simple_json
+{
+    // Something that resumes coroutines, e.g. on a thread pool or an event loop.
+    //
+    template <typename E>
+    concept Executor = requires( E& executor, std::coroutine_handle<> handle ) { executor.post( handle ); };
+
+    // A source of data. co_await reader.read_some( buffer ) gives a std::expected<size_t, std::string>,
+    // the number of chars read into the buffer, 0 at the end of the input, or an error message.
+    //
+    template <typename R>
+    concept AsyncReader = requires( R& reader, std::span<char> buffer ) { reader.read_some( buffer ); };
+
+    // A sink for data. co_await writer.write_some( data ) gives a std::expected<size_t, std::string>,
+    // the number of chars written, at least one, or an error message.
+    //
+    template <typename W>
+    concept AsyncWriter = requires( W& writer, std::span<const char> data ) { writer.write_some( data ); };
+
+    // A lazily started coroutine that produces a T. A Task can be co_awaited by another coroutine,
+    // or started with start() and its result collected with result() once done() is true.
+    //
+    template <typename T>
+    class [[nodiscard]] Task
+    {
+      public:
+        struct promise_type
+        {
+            std::optional<T> value;
+            std::exception_ptr exception;
+            std::coroutine_handle<> continuation;
+
+            Task get_return_object()
+            {
+                return Task( std::coroutine_handle<promise_type>::from_promise( *this ) );
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            auto final_suspend() noexcept
+            {
+                struct Resume_continuation
+                {
+                    bool await_ready() noexcept
+                    {
+                        return false;
+                    }
+
+                    std::coroutine_handle<> await_suspend( std::coroutine_handle<promise_type> handle ) noexcept
+                    {
+                        const auto continuation = handle.promise().continuation;
+                        return continuation ? continuation : std::noop_coroutine();
+                    }
+
+                    void await_resume() noexcept
+                    {
+                    }
+                };
+                return Resume_continuation();
+            }
+
+            template <typename U>
+            void return_value( U&& result )
+            {
+                value.emplace( std::forward<U>( result ) );
+            }
+
+            void unhandled_exception()
+            {
+                exception = std::current_exception();
+            }
+        };
+
+        Task( Task&& other ) noexcept
+            : handle_( std::exchange( other.handle_, nullptr ) )
+        {
+        }
+
+        Task& operator=( Task&& other ) noexcept
+        {
+            std::swap( handle_, other.handle_ );
+            return *this;
+        }
+
+        ~Task()
+        {
+            if ( handle_ )
+            {
+                handle_.destroy();
+            }
+        }
+
+        // runs the coroutine until it first suspends, for a task that is not co_awaited
+        //
+        void start()
+        {
+            handle_.resume();
+        }
+
+        bool done() const
+        {
+            return handle_.done();
+        }
+
+        T& result()
+        {
+            if ( handle_.promise().exception )
+            {
+                std::rethrow_exception( handle_.promise().exception );
+            }
+            return *handle_.promise().value;
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        std::coroutine_handle<> await_suspend( std::coroutine_handle<> continuation ) noexcept
+        {
+            handle_.promise().continuation = continuation;
+            return handle_;
+        }
+
+        T await_resume()
+        {
+            return std::move( result() );
+        }
+
+      private:
+        explicit Task( std::coroutine_handle<promise_type> handle )
+            : handle_( handle )
+        {
+        }
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    // co_await schedule( executor ) continues the coroutine on the executor
+    //
+    template <Executor E>
+    auto schedule( E& executor )
+    {
+        struct Schedule
+        {
+            E& executor;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend( std::coroutine_handle<> handle )
+            {
+                executor.post( handle );
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+        return Schedule{ executor };
+    }
+
+    namespace detail
+    {
+        // Finds where a JSON value in a stream of chunks ends, without parsing it, so that a reader need not
+        // wait for the end of the input when the value is an object or array.
+        //
+        class ValueEndScanner
+        {
+          public:
+            // returns the number of chars of the chunk up to the end of the value, or nullopt if it has not ended yet
+            //
+            std::optional<size_t> scan( std::string_view chunk );
+
+          private:
+            size_t depth_ = 0;
+            bool in_string_ = false;
+            bool escaped_ = false;
+        };
+    } // namespace detail
+
+    // A reader that can take back data read past the end of a value, to give it out again before reading more.
+    //
+    template <typename R>
+    concept PushbackReader = AsyncReader<R> && requires( R& reader, std::string_view data ) { reader.unread( data ); };
+
+    // Wraps a reader to make it a PushbackReader, so that async_parse() can read one value after another from it,
+    // e.g. pipelined messages, however they are split between reads.
+    //
+    template <AsyncReader Reader>
+    class BufferedReader
+    {
+      public:
+        explicit BufferedReader( Reader& reader )
+            : reader_( reader )
+        {
+        }
+
+        Task<std::expected<size_t, std::string>> read_some( std::span<char> buffer )
+        {
+            if ( !pending_.empty() )
+            {
+                const size_t count = std::min( buffer.size(), pending_.size() );
+                std::copy_n( pending_.begin(), count, buffer.begin() );
+                pending_.erase( 0, count );
+                co_return count;
+            }
+            co_return co_await reader_.read_some( buffer );
+        }
+
+        // puts data back, to be read before anything already put back
+        //
+        void unread( std::string_view data )
+        {
+            pending_.insert( 0, data );
+        }
+
+      private:
+        Reader& reader_;
+        std::string pending_; // data put back and not yet read again
+    };
+
+    // reads a JSON value from a reader and parses it on the executor with the options
+    // An object or array is complete at its closing bracket, and no more is read. Whatever the last read returned
+    // after it is given back to a PushbackReader for the next value. From any other reader it must be whitespace,
+    // or parsing fails with "unprocessed data", but later data is never read or checked, so use a PushbackReader
+    // to reject or keep trailing data. Other values are read to the end of the input. The options are copied, as
+    // the task may outlive them.
+    //
+    template <AsyncReader Reader, Executor E>
+    Task<std::expected<Value, std::string>> async_parse( Reader& reader, E& executor, ParseOptions options = ParseOptions(), size_t buffer_size = 64 * 1024 )
+    {
+        co_await schedule( executor );
+
+        std::string json_str;
+        detail::ValueEndScanner scanner;
+
+        while ( true )
+        {
+            const size_t old_size = json_str.size();
+            json_str.resize( old_size + buffer_size );
+
+            const std::expected<size_t, std::string> count = co_await reader.read_some( std::span<char>( json_str.data() + old_size, buffer_size ) );
+            if ( !count )
+            {
+                co_return std::unexpected( count.error() );
+            }
+
+            json_str.resize( old_size + *count );
+
+            if ( *count == 0 )
+            {
+                break; // end of the input
+            }
+
+            if ( const auto end = scanner.scan( std::string_view( json_str ).substr( old_size ) ) )
+            {
+                if constexpr ( PushbackReader<Reader> )
+                {
+                    reader.unread( std::string_view( json_str ).substr( old_size + *end ) );
+                    json_str.resize( old_size + *end );
+                }
+                break;
+            }
+        }
+
+        co_await schedule( executor ); // the reader may have resumed this coroutine elsewhere
+
+        co_return parse( json_str, options );
+    }
+
+    // formats a value on the executor and writes it to a writer
+    // The value, like the writer and executor, must outlive the task.
+    //
+    template <AsyncWriter Writer, Executor E>
+    Task<std::expected<void, std::string>> async_write( Writer& writer, const Value& value, E& executor )
+    {
+        co_await schedule( executor );
+
+        const std::string json_str = format_parallel( value, 1 ); // on this thread, the executor provides any concurrency
+
+        for ( std::span<const char> remaining( json_str ); !remaining.empty(); )
+        {
+            const std::expected<size_t, std::string> count = co_await writer.write_some( remaining );
+            if ( !count )
+            {
+                co_return std::unexpected( count.error() );
+            }
+            remaining = remaining.subspan( *count );
+        }
+
+        co_return std::expected<void, std::string>();
+    }
+
+} // namespace simple_json
@@ -0,0 +1,115 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Builds a Value a piece at a time, adding each value straight into its parent array or object.
+
+#pragma once
+#include "simple_json.h"
+#include <cassert>
+#include <vector>
+
+namespace simple_json
+{
+    // Builds a Value with the same calls as a Writer, e.g.
+    //
+    //     Value value;
+    //     Builder builder( value );
+    //     builder.begin_object().key( "id" ).value( 42 ).key( "tags" ).begin_array().value( "a" ).end_array().end_object();
+    //
+    // Each value is moved into place in its parent as it is added, rather than a child being built and then copied
+    // or moved into its parent, so code that writes JSON through a Writer can build a Value by being given a
+    // Builder. A member added with the name of an existing member replaces it. Debug builds assert that the
+    // calls make a single well-formed value, as a Writer does.
+    //
+    class Builder
+    {
+      public:
+        explicit Builder( Value& root )
+            : root_( root )
+        {
+        }
+
+        Builder& begin_object()
+        {
+            levels_.push_back( &add( Object() ) );
+            return *this;
+        }
+
+        Builder& end_object()
+        {
+            assert( !levels_.empty() && std::holds_alternative<Object>( *levels_.back() ) && "end_object() without begin_object()" );
+            assert( !after_key_ && "end_object() after a key without a value" );
+            levels_.pop_back();
+            return *this;
+        }
+
+        Builder& begin_array()
+        {
+            levels_.push_back( &add( Array() ) );
+            return *this;
+        }
+
+        Builder& end_array()
+        {
+            assert( !levels_.empty() && std::holds_alternative<Array>( *levels_.back() ) && "end_array() without begin_array()" );
+            levels_.pop_back();
+            return *this;
+        }
+
+        // sets the name of the next member of an object, to be followed by its value
+        //
+        Builder& key( std::string name )
+        {
+            assert( !levels_.empty() && std::holds_alternative<Object>( *levels_.back() ) && "key() outside an object" );
+            assert( !after_key_ && "key() after a key without a value" );
+            key_ = std::move( name );
+            after_key_ = true;
+            return *this;
+        }
+
+        // adds a value, which may be a whole array or object, moving it into place
+        //
+        Builder& value( Value v )
+        {
+            add( std::move( v ) );
+            return *this;
+        }
+
+        // returns true once a complete value has been built
+        //
+        bool complete() const
+        {
+            return added_ && levels_.empty();
+        }
+
+      private:
+        // moves a value into the open array or object, or the root, and returns where it now is
+        //
+        Value& add( Value&& v )
+        {
+            if ( levels_.empty() )
+            {
+                assert( !added_ && "more than one value at the top level" );
+                added_ = true;
+                root_ = std::move( v );
+                return root_;
+            }
+
+            if ( Object* obj = std::get_if<Object>( levels_.back() ) )
+            {
+                assert( after_key_ && "a value in an object without a key()" );
+                after_key_ = false;
+                return obj->insert_or_assign( obj->end(), std::move( key_ ), std::move( v ) )->second;
+            }
+
+            return std::get<Array>( *levels_.back() ).emplace_back( std::move( v ) );
+        }
+
+        Value& root_;
+        std::vector<Value*> levels_; // the open arrays and objects, which stay where they are until they are ended
+        std::string key_;
+        bool after_key_ = false;
+        bool added_ = false;
+    };
+
+} // namespace simple_json
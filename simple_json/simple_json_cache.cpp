@@ -0,0 +1,82 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_cache.h"
+
+using namespace simple_json;
+using namespace std;
+
+ParseCache::ParseCache( size_t capacity )
+    : capacity_( capacity )
+{
+    index_.reserve( capacity );
+}
+
+expected<shared_ptr<const Value>, string> ParseCache::parse( const string& json_str )
+{
+    const Key key{ hash_bytes( json_str ), json_str };
+
+    {
+        lock_guard lock( mutex_ );
+        if ( auto it = index_.find( key ); it != index_.end() )
+        {
+            entries_.splice( entries_.begin(), entries_, it->second );
+            ++hits_;
+            return it->second->value;
+        }
+    }
+
+    ++misses_;
+
+    // parse without holding the lock, so that other threads can use the cache meanwhile
+    auto parsed = simple_json::parse( json_str );
+    if ( !parsed )
+    {
+        return std::unexpected( std::move( parsed.error() ) );
+    }
+    auto value = make_shared<const Value>( std::move( *parsed ) );
+
+    if ( capacity_ == 0 )
+    {
+        return value;
+    }
+
+    lock_guard lock( mutex_ );
+
+    // another thread may have added the same input while this one was parsing
+    if ( auto it = index_.find( key ); it != index_.end() )
+    {
+        entries_.splice( entries_.begin(), entries_, it->second );
+        return it->second->value;
+    }
+
+    if ( entries_.size() == capacity_ )
+    {
+        const Entry& oldest = entries_.back();
+        index_.erase( Key{ oldest.hash, oldest.json_str } );
+        entries_.pop_back();
+    }
+
+    entries_.push_front( Entry{ key.hash, json_str, value } );
+    index_.emplace( Key{ key.hash, entries_.front().json_str }, entries_.begin() );
+
+    return value;
+}
+
+ParseCache::Stats ParseCache::stats() const
+{
+    return Stats{ hits_.load(), misses_.load() };
+}
+
+size_t ParseCache::size() const
+{
+    lock_guard lock( mutex_ );
+    return entries_.size();
+}
+
+void ParseCache::clear()
+{
+    lock_guard lock( mutex_ );
+    index_.clear();
+    entries_.clear();
+}
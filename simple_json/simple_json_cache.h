@@ -0,0 +1,83 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// A bounded cache of parse results for inputs that are parsed repeatedly, such as configuration
+// strings. A repeated parse costs a hash of the input and a lookup instead of building a new tree.
+
+#pragma once
+#include "simple_json.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace simple_json
+{
+    class ParseCache
+    {
+      public:
+        struct Stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+        };
+
+        // a cache that holds the results of up to "capacity" distinct inputs, discarding the least recently used
+        //
+        explicit ParseCache( size_t capacity );
+
+        // returns the parsed value of a JSON string, from the cache if the same string has been parsed before
+        // The value is shared with other callers so cannot be modified, copy it to make changes.
+        // Inputs that fail to parse are not cached.
+        // Safe to call from several threads at once.
+        //
+        std::expected<std::shared_ptr<const Value>, std::string> parse( const std::string& json_str );
+
+        Stats stats() const;
+
+        size_t size() const;
+
+        void clear();
+
+      private:
+        struct Entry
+        {
+            uint64_t hash;
+            std::string json_str;
+            std::shared_ptr<const Value> value;
+        };
+
+        // the input text and its hash, the text is owned by the Entry so stays valid while the entry is cached
+        //
+        struct Key
+        {
+            uint64_t hash;
+            std::string_view json_str;
+
+            bool operator==( const Key& other ) const
+            {
+                return hash == other.hash && json_str == other.json_str;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()( const Key& key ) const
+            {
+                return static_cast<size_t>( key.hash );
+            }
+        };
+
+        using Entries = std::list<Entry>; // most recently used first
+
+        size_t capacity_;
+        mutable std::mutex mutex_;
+        Entries entries_;
+        std::unordered_map<Key, Entries::iterator, KeyHash> index_;
+        std::atomic<uint64_t> hits_ = 0;
+        std::atomic<uint64_t> misses_ = 0;
+    };
+
+} // namespace simple_json
@@ -0,0 +1,330 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_columnar.h"
+#include "simple_json_parser.h"
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    const char* const type_names[] = { "null", "integer", "boolean", "string" };
+
+    // Parses the rows with the same grammar as parse(), but stores each member's value straight into its column.
+    //
+    class TableParser : public detail::Parser<false>
+    {
+      public:
+        using Parser::Parser;
+
+        expected<Table, string> parse_table()
+        {
+            skip_whitespace();
+
+            if ( posn_() == end_ || *posn_() != '[' )
+            {
+                return std::unexpected( "expected an array of objects" + where() );
+            }
+
+            posn_.incr(); // skip opening '['
+
+            skip_whitespace();
+
+            if ( posn_() != end_ && *posn_() == ']' )
+            {
+                posn_.incr();
+            }
+            else
+            {
+                while ( true )
+                {
+                    skip_whitespace();
+
+                    if ( posn_() == end_ || *posn_() != '{' )
+                    {
+                        return std::unexpected( "row " + to_string( table_.rows ) + " is not an object" + where() );
+                    }
+
+                    auto row = parse_row();
+                    if ( !row )
+                    {
+                        return std::unexpected( row.error() );
+                    }
+
+                    skip_whitespace();
+
+                    if ( posn_() == end_ )
+                    {
+                        return std::unexpected( "missing closing ']'" + where() );
+                    }
+
+                    if ( *posn_() == ']' )
+                    {
+                        posn_.incr();
+                        break; // end of array
+                    }
+
+                    if ( *posn_() != ',' )
+                    {
+                        return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+                    }
+
+                    posn_.incr(); // skip ','
+                }
+            }
+
+            skip_whitespace();
+            if ( posn_() != end_ )
+            {
+                return std::unexpected( "unprocessed data" + where() );
+            }
+
+            return std::move( table_ );
+        }
+
+      private:
+        expected<void, string> parse_row()
+        {
+            posn_.incr(); // skip opening '{'
+
+            const size_t row = table_.rows++;
+
+            // rows usually have the same members in the same order, so look for each member in the column after the last one
+            size_t predicted = 0;
+
+            while ( true )
+            {
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "missing closing '}'" + where() );
+                }
+
+                if ( *posn_() == '}' )
+                {
+                    posn_.incr();
+                    break; // end of object
+                }
+
+                if ( *posn_() == ',' )
+                {
+                    posn_.incr(); // skip ','
+                    continue;
+                }
+
+                if ( *posn_() != '"' )
+                {
+                    return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+                }
+
+                auto name = parse_string();
+                if ( !name )
+                {
+                    return std::unexpected( name.error() );
+                }
+
+                skip_whitespace();
+
+                if ( posn_() == end_ || *posn_() != ':' )
+                {
+                    return std::unexpected( "missing ':'" + where() );
+                }
+
+                posn_.incr();
+
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "end of string reached while looking for second of pair" + where() );
+                }
+
+                const size_t index = find_column( *name, predicted, row );
+                predicted = index + 1;
+
+                Column& column = table_.columns[ index ];
+                if ( column.nulls.size() > row ) // a duplicate member, ignore it
+                {
+                    auto value = parse_value();
+                    if ( !value )
+                    {
+                        return std::unexpected( value.error() );
+                    }
+                    continue;
+                }
+
+                auto result = parse_member_value( column, row );
+                if ( !result )
+                {
+                    return result;
+                }
+            }
+
+            // rows without some of the members have nulls in those columns
+            for ( Column& column : table_.columns )
+            {
+                if ( column.nulls.size() == row )
+                {
+                    append_null( column );
+                }
+            }
+
+            return {};
+        }
+
+        size_t find_column( const string& name, size_t predicted, size_t row )
+        {
+            auto& columns = table_.columns;
+
+            if ( predicted < columns.size() && columns[ predicted ].name == name )
+            {
+                return predicted;
+            }
+
+            for ( size_t i = 0; i < columns.size(); ++i )
+            {
+                if ( columns[ i ].name == name )
+                {
+                    return i;
+                }
+            }
+
+            // a new member, null in the preceding rows
+            Column& column = columns.emplace_back();
+            column.name = name;
+            column.nulls.resize( row, true );
+            return columns.size() - 1;
+        }
+
+        static void append_null( Column& column )
+        {
+            column.nulls.push_back( true );
+
+            switch ( column.type )
+            {
+            case Column::Type::integer:
+                column.integers.push_back( 0 );
+                break;
+            case Column::Type::boolean:
+                column.booleans.push_back( false );
+                break;
+            case Column::Type::string:
+                column.strings.emplace_back();
+                break;
+            case Column::Type::null:
+                break;
+            }
+        }
+
+        // checks a value's type against its column's, setting the column's type if this is its first value that is not null
+        //
+        expected<void, string> check_type( Column& column, Column::Type type, size_t row )
+        {
+            if ( column.type == type )
+            {
+                return {};
+            }
+
+            if ( column.type != Column::Type::null )
+            {
+                return std::unexpected( "value of \"" + column.name + "\" in row " + to_string( row ) + " is not of type " +
+                                        type_names[ static_cast<int>( column.type ) ] + where() );
+            }
+
+            // give the preceding rows, all null, default values
+            column.type = type;
+            switch ( type )
+            {
+            case Column::Type::integer:
+                column.integers.resize( row );
+                break;
+            case Column::Type::boolean:
+                column.booleans.resize( row );
+                break;
+            case Column::Type::string:
+                column.strings.resize( row );
+                break;
+            case Column::Type::null:
+                break;
+            }
+            return {};
+        }
+
+        expected<void, string> parse_member_value( Column& column, size_t row )
+        {
+            const char c = *posn_();
+
+            if ( c == 'n' )
+            {
+                return parse_null().transform( [ & ]( Null ) { append_null( column ); } );
+            }
+
+            if ( c == 't' || c == 'f' )
+            {
+                auto b = c == 't' ? parse_true() : parse_false();
+                if ( !b )
+                {
+                    return std::unexpected( b.error() );
+                }
+                return check_type( column, Column::Type::boolean, row ).transform( [ & ]() {
+                    column.booleans.push_back( *b );
+                    column.nulls.push_back( false );
+                } );
+            }
+
+            if ( c == '"' )
+            {
+                auto type_checked = check_type( column, Column::Type::string, row );
+                if ( !type_checked )
+                {
+                    return type_checked;
+                }
+                return parse_string().transform( [ & ]( string&& s ) {
+                    column.strings.push_back( std::move( s ) );
+                    column.nulls.push_back( false );
+                } );
+            }
+
+            if ( at_integer() )
+            {
+                auto type_checked = check_type( column, Column::Type::integer, row );
+                if ( !type_checked )
+                {
+                    return type_checked;
+                }
+                return parse_integer().transform( [ & ]( int64_t i ) {
+                    column.integers.push_back( i );
+                    column.nulls.push_back( false );
+                } );
+            }
+
+            if ( c == '{' || c == '[' )
+            {
+                return std::unexpected( "value of \"" + column.name + "\" in row " + to_string( row ) + " is not an integer, boolean, string or null" + where() );
+            }
+
+            return std::unexpected( string( "unexpected character '" ) + c + "'" + where() );
+        }
+
+        Table table_;
+    };
+} // namespace
+
+const Column* Table::find( std::string_view name ) const
+{
+    for ( const Column& column : columns )
+    {
+        if ( column.name == name )
+        {
+            return &column;
+        }
+    }
+    return nullptr;
+}
+
+expected<Table, string> simple_json::parse_table( const std::string& json_str )
+{
+    return TableParser( json_str ).parse_table();
+}
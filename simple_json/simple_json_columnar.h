@@ -0,0 +1,55 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Decodes an array of objects, such as rows of records, directly into columns: one contiguous
+// vector per member name, with a null mask, and without building an Object for each row.
+
+#pragma once
+#include "simple_json.h"
+
+namespace simple_json
+{
+    // The values of one member of each row. The values are in the vector for the column's type,
+    // which is set by the first value that is not null. Where a row's value is null, or the row does not have
+    // the member, the null mask is true and the value is 0, false or an empty string.
+    //
+    struct Column
+    {
+        enum class Type
+        {
+            null, // all the values are null
+            integer,
+            boolean,
+            string
+        };
+
+        std::string name;
+        Type type = Type::null;
+        std::vector<int64_t> integers;
+        std::vector<bool> booleans;
+        std::vector<std::string> strings;
+        std::vector<bool> nulls;
+
+        bool is_null( size_t row ) const
+        {
+            return nulls[ row ];
+        }
+    };
+
+    struct Table
+    {
+        size_t rows = 0;
+        std::vector<Column> columns; // in the order the members first appear
+
+        // returns the column with the given name, or nullptr if no row has that member
+        //
+        const Column* find( std::string_view name ) const;
+    };
+
+    // parses a JSON array of objects into a table
+    // The members' values must be integers, booleans, strings or null, and each member must have values of
+    // only one of those types, plus null, in every row. Duplicate members are ignored, as by parse().
+    //
+    std::expected<Table, std::string> parse_table( const std::string& json_str );
+
+} // namespace simple_json
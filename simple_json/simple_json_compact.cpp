@@ -0,0 +1,642 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_compact.h"
+#include "simple_json_parser.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    char* heap_pointer( const unsigned char* bytes )
+    {
+        char* ptr;
+        memcpy( &ptr, bytes, sizeof( ptr ) );
+        return ptr;
+    }
+} // namespace
+
+CompactString::CompactString( string_view s )
+{
+    if ( s.size() <= max_inline_size )
+    {
+        memcpy( bytes_, s.data(), s.size() );
+        bytes_[ tag_index ] = static_cast<unsigned char>( s.size() );
+    }
+    else
+    {
+        const size_t size = s.size();
+        char* ptr = new char[ sizeof( size ) + size ];
+        memcpy( ptr, &size, sizeof( size ) );
+        memcpy( ptr + sizeof( size ), s.data(), size );
+        memcpy( bytes_, &ptr, sizeof( ptr ) );
+        bytes_[ tag_index ] = heap_tag;
+    }
+}
+
+CompactString::CompactString( const CompactString& other )
+    : CompactString( other.view() )
+{
+}
+
+CompactString::CompactString( CompactString&& other ) noexcept
+{
+    memcpy( bytes_, other.bytes_, sizeof( bytes_ ) );
+    other.bytes_[ tag_index ] = 0; // leave other empty, it no longer owns any heap memory
+}
+
+CompactString& CompactString::operator=( const CompactString& other )
+{
+    if ( this != &other )
+    {
+        *this = CompactString( other );
+    }
+    return *this;
+}
+
+CompactString& CompactString::operator=( CompactString&& other ) noexcept
+{
+    if ( this != &other )
+    {
+        this->~CompactString();
+        new ( this ) CompactString( std::move( other ) );
+    }
+    return *this;
+}
+
+CompactString::~CompactString()
+{
+    if ( !is_inline() )
+    {
+        delete[] heap_pointer( bytes_ );
+    }
+}
+
+string_view CompactString::view() const noexcept
+{
+    if ( is_inline() )
+    {
+        return { reinterpret_cast<const char*>( bytes_ ), bytes_[ tag_index ] };
+    }
+
+    const char* ptr = heap_pointer( bytes_ );
+    size_t size;
+    memcpy( &size, ptr, sizeof( size ) );
+    return { ptr + sizeof( size ), size };
+}
+
+CompactValue::CompactValue() noexcept
+    : CompactValue( Null() )
+{
+}
+
+CompactValue::CompactValue( Null ) noexcept
+    : scalar_{}
+{
+    static_assert( offsetof( Scalar, tag ) == CompactString::tag_index, "the tag must be in the same byte as a CompactString's" );
+
+    scalar_.tag = null_tag;
+}
+
+CompactValue::CompactValue( bool b ) noexcept
+    : scalar_{}
+{
+    scalar_.boolean = b;
+    scalar_.tag = bool_tag;
+}
+
+CompactValue::CompactValue( int64_t i ) noexcept
+    : scalar_{}
+{
+    scalar_.integer = i;
+    scalar_.tag = int_tag;
+}
+
+CompactValue::CompactValue( int i ) noexcept
+    : CompactValue( static_cast<int64_t>( i ) )
+{
+}
+
+CompactValue::CompactValue( const char* s )
+    : string_( s )
+{
+}
+
+CompactValue::CompactValue( string_view s )
+    : string_( s )
+{
+}
+
+CompactValue::CompactValue( const string& s )
+    : string_( s )
+{
+}
+
+CompactValue::CompactValue( CompactString s ) noexcept
+    : string_( std::move( s ) )
+{
+}
+
+CompactValue::CompactValue( CompactArray arr )
+    : scalar_{}
+{
+    scalar_.array = new CompactArray( std::move( arr ) );
+    scalar_.tag = array_tag;
+}
+
+CompactValue::CompactValue( CompactObject obj )
+    : scalar_{}
+{
+    scalar_.object = new CompactObject( std::move( obj ) );
+    scalar_.tag = object_tag;
+}
+
+CompactValue::CompactValue( RawNumber n )
+    : scalar_{}
+{
+    scalar_.number = new RawNumber( std::move( n ) );
+    scalar_.tag = number_tag;
+}
+
+CompactValue::CompactValue( const Value& value )
+    : CompactValue()
+{
+    struct Visitor
+    {
+        CompactValue* compact;
+        void operator()( const string& s )
+        {
+            *compact = CompactValue( s );
+        }
+        void operator()( const Object& obj )
+        {
+            CompactObject compact_obj;
+            compact_obj.reserve( obj.size() );
+            for ( const auto& member : obj )
+            {
+                compact_obj.emplace( member.first, CompactValue( member.second ) ); // appended, obj is sorted already
+            }
+            *compact = std::move( compact_obj );
+        }
+        void operator()( const OrderedObject& obj )
+        {
+            CompactObject compact_obj;
+            compact_obj.reserve( obj.size() );
+            for ( const auto& member : obj )
+            {
+                compact_obj.emplace( member.first, CompactValue( member.second ) ); // sorted, keeping the first of any duplicates
+            }
+            *compact = std::move( compact_obj );
+        }
+        void operator()( const Array& arr )
+        {
+            CompactArray compact_arr;
+            compact_arr.reserve( arr.size() );
+            for ( const Value& element : arr )
+            {
+                compact_arr.emplace_back( element );
+            }
+            *compact = std::move( compact_arr );
+        }
+        void operator()( const IntArray& arr )
+        {
+            *compact = CompactArray( arr.begin(), arr.end() );
+        }
+        void operator()( int64_t i )
+        {
+            *compact = i;
+        }
+        void operator()( bool b )
+        {
+            *compact = b;
+        }
+        void operator()( const Null& )
+        {
+        }
+        void operator()( const RawNumber& n )
+        {
+            // kept inline as an integer if it is one, else out of line
+            if ( const auto i = n.to_int64() )
+            {
+                *compact = *i;
+            }
+            else
+            {
+                *compact = n;
+            }
+        }
+    };
+
+    std::visit( Visitor{ this }, value );
+}
+
+CompactValue::CompactValue( const CompactValue& other )
+    : CompactValue()
+{
+    if ( const CompactString* s = other.get_if<CompactString>() )
+    {
+        *this = CompactValue( *s );
+    }
+    else if ( const CompactArray* arr = other.get_if<CompactArray>() )
+    {
+        *this = CompactValue( *arr );
+    }
+    else if ( const CompactObject* obj = other.get_if<CompactObject>() )
+    {
+        *this = CompactValue( *obj );
+    }
+    else if ( const RawNumber* n = other.get_if<RawNumber>() )
+    {
+        *this = CompactValue( *n );
+    }
+    else
+    {
+        scalar_ = other.scalar_;
+    }
+}
+
+CompactValue::CompactValue( CompactValue&& other ) noexcept
+{
+    if ( other.tag() <= CompactString::heap_tag )
+    {
+        new ( &string_ ) CompactString( std::move( other.string_ ) );
+    }
+    else
+    {
+        new ( &scalar_ ) Scalar( other.scalar_ );
+        other.scalar_.tag = null_tag; // other no longer owns any array or object
+    }
+}
+
+CompactValue& CompactValue::operator=( const CompactValue& other )
+{
+    if ( this != &other )
+    {
+        *this = CompactValue( other );
+    }
+    return *this;
+}
+
+CompactValue& CompactValue::operator=( CompactValue&& other ) noexcept
+{
+    if ( this != &other )
+    {
+        destroy();
+        new ( this ) CompactValue( std::move( other ) );
+    }
+    return *this;
+}
+
+CompactValue::~CompactValue()
+{
+    destroy();
+}
+
+void CompactValue::destroy() noexcept
+{
+    if ( tag() <= CompactString::heap_tag )
+    {
+        string_.~CompactString();
+    }
+    else if ( tag() == array_tag )
+    {
+        delete scalar_.array;
+    }
+    else if ( tag() == object_tag )
+    {
+        delete scalar_.object;
+    }
+    else if ( tag() == number_tag )
+    {
+        delete scalar_.number;
+    }
+}
+
+size_t CompactValue::index() const noexcept
+{
+    switch ( tag() )
+    {
+    case bool_tag:
+        return 1;
+    case int_tag:
+        return 2;
+    case null_tag:
+        return 3;
+    case array_tag:
+        return 4;
+    case object_tag:
+        return 5;
+    case number_tag:
+        return 8;
+    default:
+        return 0; // a string
+    }
+}
+
+CompactObject::CompactObject( initializer_list<value_type> members )
+{
+    for ( const value_type& member : members )
+    {
+        emplace( member.first, member.second );
+    }
+}
+
+CompactObject::iterator CompactObject::find( string_view key )
+{
+    const auto it = std::lower_bound( members_.begin(), members_.end(), key, []( const value_type& member, string_view key ) {
+        return member.first.view() < key;
+    } );
+    return ( it != members_.end() && it->first.view() == key ) ? it : members_.end();
+}
+
+CompactObject::const_iterator CompactObject::find( string_view key ) const
+{
+    return const_cast<CompactObject*>( this )->find( key );
+}
+
+pair<CompactObject::iterator, bool> CompactObject::emplace( string_view key, CompactValue value )
+{
+    // members usually arrive in order, e.g. when converted from an Object, so check for appending first
+    if ( members_.empty() || members_.back().first.view() < key )
+    {
+        members_.emplace_back( key, std::move( value ) );
+        return { members_.end() - 1, true };
+    }
+
+    const auto it = std::lower_bound( members_.begin(), members_.end(), key, []( const value_type& member, string_view key ) {
+        return member.first.view() < key;
+    } );
+    if ( it->first.view() == key )
+    {
+        return { it, false };
+    }
+    return { members_.emplace( it, key, std::move( value ) ), true };
+}
+
+CompactValue& CompactObject::operator[]( string_view key )
+{
+    return emplace( key, CompactValue() ).first->second;
+}
+
+namespace
+{
+    // Parses with the same grammar as parse(), building CompactValues directly rather than Values to convert.
+    //
+    class CompactParser : public detail::Parser<false>
+    {
+      public:
+        explicit CompactParser( const string& json_str )
+            : Parser( json_str )
+        {
+        }
+
+        expected<CompactValue, string> parse_document()
+        {
+            CompactValue value;
+            Result result = parse_compact_value( value );
+            if ( result )
+            {
+                skip_whitespace();
+                if ( posn_() != end_ )
+                {
+                    result = std::unexpected( "unprocessed data" + where() );
+                }
+            }
+            if ( !result )
+            {
+                return std::unexpected( std::move( result.error() ) );
+            }
+            return value;
+        }
+
+      private:
+        Result parse_compact_value( CompactValue& value )
+        {
+            skip_whitespace();
+
+            if ( posn_() == end_ )
+            {
+                return std::unexpected( "end of string reached while looking for value" + where() );
+            }
+            if ( *posn_() == '{' || *posn_() == '[' )
+            {
+                return parse_compact_container( value );
+            }
+            if ( *posn_() == '"' )
+            {
+                string_.clear();
+                return parse_string( string_ ).transform( [ & ]() { value = CompactValue( string_view( string_ ) ); } );
+            }
+            if ( *posn_() == 't' )
+            {
+                return parse_true().transform( [ & ]( bool b ) { value = b; } );
+            }
+            if ( *posn_() == 'f' )
+            {
+                return parse_false().transform( [ & ]( bool b ) { value = b; } );
+            }
+            if ( *posn_() == 'n' )
+            {
+                return parse_null().transform( [ & ]( Null ) { value = Null(); } );
+            }
+            if ( at_integer() )
+            {
+                return parse_integer().transform( [ & ]( int64_t i ) { value = i; } );
+            }
+            return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+        }
+
+        Result parse_compact_container( CompactValue& value )
+        {
+            if ( depth_ == max_depth_ )
+            {
+                return std::unexpected( "nesting deeper than the maximum depth of " + to_string( max_depth_ ) + where() );
+            }
+
+            ++depth_;
+
+            const bool is_object = *posn_() == '{';
+            posn_.incr(); // skip the opening bracket
+
+            Result result;
+            if ( is_object )
+            {
+                CompactObject obj;
+                result = parse_compact_members( obj );
+                value = std::move( obj );
+            }
+            else
+            {
+                CompactArray arr;
+                result = parse_compact_elements( arr );
+                value = std::move( arr );
+            }
+
+            --depth_;
+            return result;
+        }
+
+        Result parse_compact_elements( CompactArray& arr )
+        {
+            skip_whitespace();
+
+            if ( posn_() == end_ )
+            {
+                return std::unexpected( "missing closing ']'" + where() );
+            }
+
+            if ( *posn_() == ']' )
+            {
+                posn_.incr();
+                return {};
+            }
+
+            while ( true )
+            {
+                if ( arr.size() == max_elements_ )
+                {
+                    return too_many_elements();
+                }
+
+                Result result = parse_compact_value( arr.emplace_back() );
+                if ( !result )
+                {
+                    return result;
+                }
+
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "missing closing ']'" + where() );
+                }
+
+                if ( *posn_() == ']' )
+                {
+                    posn_.incr();
+                    return {}; // end of array
+                }
+
+                if ( *posn_() != ',' )
+                {
+                    return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+                }
+
+                posn_.incr(); // skip ','
+            }
+        }
+
+        // Members are collected in document order and then sorted by name, keeping the first of any duplicates as
+        // parse() does, so that an object whose members are not in order takes one sort rather than an insertion each.
+        //
+        Result parse_compact_members( CompactObject& obj )
+        {
+            vector<CompactObject::value_type> members;
+
+            while ( true )
+            {
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "missing closing '}'" + where() );
+                }
+
+                if ( *posn_() == '}' )
+                {
+                    posn_.incr();
+                    break; // end of object
+                }
+
+                if ( *posn_() == '"' )
+                {
+                    if ( members.size() == max_elements_ )
+                    {
+                        return std::unexpected( "object with more than the maximum of " + to_string( max_elements_ ) + " members" + where() );
+                    }
+
+                    string_.clear();
+
+                    Result result = parse_name( string_ );
+                    if ( result )
+                    {
+                        auto& member = members.emplace_back( CompactString( string_ ), CompactValue() );
+                        result = parse_compact_value( member.second );
+                    }
+                    if ( !result )
+                    {
+                        return result;
+                    }
+                }
+                else if ( *posn_() == ',' )
+                {
+                    posn_.incr(); // skip ','
+                }
+                else
+                {
+                    return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+                }
+            }
+
+            std::stable_sort( members.begin(), members.end(), []( const auto& a, const auto& b ) { return a.first < b.first; } );
+
+            obj.reserve( members.size() );
+            for ( auto& member : members )
+            {
+                obj.emplace( member.first, std::move( member.second ) ); // appended, or dropped if a duplicate
+            }
+            return {};
+        }
+
+        string string_; // the string being parsed, reused for each one
+    };
+} // namespace
+
+expected<CompactValue, string> simple_json::parse_compact( const string& json_str )
+{
+    return CompactParser( json_str ).parse_document();
+}
+
+Value simple_json::to_value( const CompactValue& value )
+{
+    if ( const CompactString* s = value.get_if<CompactString>() )
+    {
+        return string( s->view() );
+    }
+    if ( const bool* b = value.get_if<bool>() )
+    {
+        return *b;
+    }
+    if ( const int64_t* i = value.get_if<int64_t>() )
+    {
+        return *i;
+    }
+    if ( const CompactArray* compact_arr = value.get_if<CompactArray>() )
+    {
+        Array arr;
+        arr.reserve( compact_arr->size() );
+        for ( const CompactValue& element : *compact_arr )
+        {
+            arr.push_back( to_value( element ) );
+        }
+        return arr;
+    }
+    if ( const CompactObject* compact_obj = value.get_if<CompactObject>() )
+    {
+        Object obj;
+        for ( const auto& member : *compact_obj )
+        {
+            obj.emplace_hint( obj.end(), member.first.view(), to_value( member.second ) );
+        }
+        return obj;
+    }
+    if ( const RawNumber* n = value.get_if<RawNumber>() )
+    {
+        return *n;
+    }
+    return Null();
+}
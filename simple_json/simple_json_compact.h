@@ -0,0 +1,305 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// A compact alternative to simple_json::Value for holding large documents in memory.
+// Every CompactValue is 16 bytes: scalars and strings of up to 15 chars are stored inline,
+// longer strings, arrays, objects and RawNumbers are stored out of line.
+
+#pragma once
+#include "simple_json.h"
+#include <string_view>
+
+namespace simple_json
+{
+    class CompactValue;
+    struct CompactArray;
+    class CompactObject;
+
+    // A string of up to 15 chars is stored inline, a longer string is stored on the heap.
+    //
+    class CompactString
+    {
+      public:
+        static constexpr size_t max_inline_size = 15;
+
+        CompactString() noexcept
+        {
+            bytes_[ tag_index ] = 0;
+        }
+
+        CompactString( std::string_view s );
+        CompactString( const char* s )
+            : CompactString( std::string_view( s ) )
+        {
+        }
+        CompactString( const std::string& s )
+            : CompactString( std::string_view( s ) )
+        {
+        }
+        CompactString( const CompactString& other );
+        CompactString( CompactString&& other ) noexcept;
+        CompactString& operator=( const CompactString& other );
+        CompactString& operator=( CompactString&& other ) noexcept;
+        ~CompactString();
+
+        std::string_view view() const noexcept;
+
+        operator std::string_view() const noexcept
+        {
+            return view();
+        }
+
+        size_t size() const noexcept
+        {
+            return view().size();
+        }
+
+        bool is_inline() const noexcept
+        {
+            return bytes_[ tag_index ] != heap_tag;
+        }
+
+        friend bool operator==( const CompactString& a, const CompactString& b ) noexcept
+        {
+            return a.view() == b.view();
+        }
+
+        friend auto operator<=>( const CompactString& a, const CompactString& b ) noexcept
+        {
+            return a.view() <=> b.view();
+        }
+
+      private:
+        friend class CompactValue;
+
+        static constexpr size_t tag_index = 15;
+        static constexpr unsigned char heap_tag = max_inline_size + 1; // tags 0 to 15 are inline lengths
+
+        // Inline, bytes 0 to 14 hold the chars and the tag byte their number.
+        // On the heap, bytes 0 to 7 hold a pointer to the string's size followed by its chars.
+        alignas( 8 ) unsigned char bytes_[ 16 ];
+    };
+
+    // A JSON value in 16 bytes, holding the same alternatives as a Value in the same order:
+    // CompactString, bool, int64_t, Null, CompactArray, CompactObject and RawNumber.
+    //
+    class CompactValue
+    {
+      public:
+        CompactValue() noexcept; // a null value
+        CompactValue( Null ) noexcept;
+        CompactValue( bool b ) noexcept;
+        CompactValue( int64_t i ) noexcept;
+        CompactValue( int i ) noexcept;
+        CompactValue( const char* s );
+        CompactValue( std::string_view s );
+        CompactValue( const std::string& s );
+        CompactValue( CompactString s ) noexcept;
+        CompactValue( CompactArray arr );
+        CompactValue( CompactObject obj );
+        CompactValue( RawNumber n );
+        explicit CompactValue( const Value& value ); // a RawNumber becomes an integer if it is one that fits
+
+        CompactValue( const CompactValue& other );
+        CompactValue( CompactValue&& other ) noexcept;
+        CompactValue& operator=( const CompactValue& other );
+        CompactValue& operator=( CompactValue&& other ) noexcept;
+        ~CompactValue();
+
+        // the index of the alternative held, the same as Value::index() for the equivalent Value
+        size_t index() const noexcept;
+
+        template <typename T>
+        const T* get_if() const noexcept;
+
+        template <typename T>
+        T* get_if() noexcept
+        {
+            return const_cast<T*>( static_cast<const CompactValue*>( this )->get_if<T>() );
+        }
+
+      private:
+        enum Tag : unsigned char
+        {
+            null_tag = CompactString::heap_tag + 1,
+            bool_tag,
+            int_tag,
+            array_tag,
+            object_tag,
+            number_tag
+        };
+
+        struct Scalar
+        {
+            union
+            {
+                int64_t integer;
+                bool boolean;
+                CompactArray* array;
+                CompactObject* object;
+                RawNumber* number;
+            };
+            unsigned char padding[ 7 ];
+            unsigned char tag;
+        };
+
+        unsigned char tag() const noexcept
+        {
+            return reinterpret_cast<const unsigned char*>( this )[ CompactString::tag_index ];
+        }
+
+        void destroy() noexcept;
+
+        union
+        {
+            CompactString string_; // active if tag() <= CompactString::heap_tag
+            Scalar scalar_;
+        };
+    };
+
+    static_assert( sizeof( CompactString ) == 16 );
+    static_assert( sizeof( CompactValue ) == 16 );
+
+    // A compact JSON array is a vector of compact values.
+    //
+    struct CompactArray : public std::vector<CompactValue>
+    {
+        using std::vector<CompactValue>::vector; // inherit all constructors
+    };
+
+    // A compact JSON object is a vector of name/value pairs kept sorted by name, so it
+    // holds its members in the same order as an Object but without a tree node per member.
+    //
+    class CompactObject
+    {
+      public:
+        using value_type = std::pair<CompactString, CompactValue>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        CompactObject() = default;
+        CompactObject( std::initializer_list<value_type> members );
+
+        iterator begin() noexcept
+        {
+            return members_.begin();
+        }
+        iterator end() noexcept
+        {
+            return members_.end();
+        }
+        const_iterator begin() const noexcept
+        {
+            return members_.begin();
+        }
+        const_iterator end() const noexcept
+        {
+            return members_.end();
+        }
+        size_t size() const noexcept
+        {
+            return members_.size();
+        }
+        bool empty() const noexcept
+        {
+            return members_.empty();
+        }
+        void reserve( size_t n )
+        {
+            members_.reserve( n );
+        }
+
+        iterator find( std::string_view key );
+        const_iterator find( std::string_view key ) const;
+
+        // inserts a member if there is not already one with that name, as std::map::emplace() does
+        std::pair<iterator, bool> emplace( std::string_view key, CompactValue value );
+
+        CompactValue& operator[]( std::string_view key );
+
+      private:
+        std::vector<value_type> members_;
+    };
+
+    template <typename T>
+    const T* CompactValue::get_if() const noexcept
+    {
+        if constexpr ( std::is_same_v<T, CompactString> )
+        {
+            return tag() <= CompactString::heap_tag ? &string_ : nullptr;
+        }
+        else if constexpr ( std::is_same_v<T, bool> )
+        {
+            return tag() == bool_tag ? &scalar_.boolean : nullptr;
+        }
+        else if constexpr ( std::is_same_v<T, int64_t> )
+        {
+            return tag() == int_tag ? &scalar_.integer : nullptr;
+        }
+        else if constexpr ( std::is_same_v<T, Null> )
+        {
+            static const Null null;
+            return tag() == null_tag ? &null : nullptr;
+        }
+        else if constexpr ( std::is_same_v<T, CompactArray> )
+        {
+            return tag() == array_tag ? scalar_.array : nullptr;
+        }
+        else if constexpr ( std::is_same_v<T, CompactObject> )
+        {
+            return tag() == object_tag ? scalar_.object : nullptr;
+        }
+        else
+        {
+            static_assert( std::is_same_v<T, RawNumber>, "not a CompactValue alternative" );
+            return tag() == number_tag ? scalar_.number : nullptr;
+        }
+    }
+
+    // the equivalents of std::get_if() and std::holds_alternative() for a CompactValue
+    //
+    template <typename T>
+    const T* get_if( const CompactValue* value ) noexcept
+    {
+        return value ? value->get_if<T>() : nullptr;
+    }
+
+    template <typename T>
+    T* get_if( CompactValue* value ) noexcept
+    {
+        return value ? value->get_if<T>() : nullptr;
+    }
+
+    template <typename T>
+    bool holds_alternative( const CompactValue& value ) noexcept
+    {
+        return value.get_if<T>() != nullptr;
+    }
+
+    // parses a JSON string into a compact value or returns an error message
+    // It accepts the same JSON as parse(), with the same errors, and builds the compact value directly, so the
+    // memory it needs is that of the compact value rather than of the equivalent Value.
+    //
+    std::expected<CompactValue, std::string> parse_compact( const std::string& json_str );
+
+    // converts a compact value to the equivalent Value, e.g. for formatting
+    //
+    Value to_value( const CompactValue& value );
+
+    // helper to get a value from a compact JSON object
+    template <typename T>
+    std::expected<std::reference_wrapper<const T>, std::string> get_value( const simple_json::CompactObject& obj, std::string_view key )
+    {
+        auto it = obj.find( key );
+        if ( it == obj.end() )
+        {
+            return std::unexpected( "field \"" + std::string( key ) + "\" not found" );
+        }
+        if ( auto ptr = it->second.get_if<T>() )
+        {
+            return std::cref( *ptr );
+        }
+        return std::unexpected( "field \"" + std::string( key ) + "\" is not the expected type" );
+    }
+
+} // namespace simple_json
@@ -0,0 +1,873 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_compress.h"
+#include "simple_json_parser.h"
+#include "simple_json_writer.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <thread>
+#include <zlib.h>
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    const char* const no_zstd = "zstd support is not built in";
+
+    string where( int line, int column )
+    {
+        return " at line " + to_string( line + 1 ) + " column " + to_string( column + 1 );
+    }
+
+    // A bounded queue of the chunks passed from a stage on one thread to the next stage on another.
+    //
+    class ChunkQueue
+    {
+      public:
+        explicit ChunkQueue( size_t max_chunks )
+            : max_chunks_( std::max<size_t>( max_chunks, 1 ) )
+        {
+        }
+
+        // adds a chunk, waiting while the queue is full, returning false if the consumer has stopped
+        //
+        bool push( string&& chunk )
+        {
+            unique_lock lock( mutex_ );
+            not_full_.wait( lock, [ this ] { return chunks_.size() < max_chunks_ || stopped_; } );
+            if ( stopped_ )
+            {
+                return false;
+            }
+            chunks_.push_back( std::move( chunk ) );
+            not_empty_.notify_one();
+            return true;
+        }
+
+        // called by the producer after its last chunk, with an error message if it failed
+        //
+        void finish( string error = string() )
+        {
+            lock_guard lock( mutex_ );
+            finished_ = true;
+            error_ = std::move( error );
+            not_empty_.notify_one();
+        }
+
+        // called by the consumer to stop the producer, if it has not already finished
+        //
+        void stop()
+        {
+            lock_guard lock( mutex_ );
+            stopped_ = true;
+            not_full_.notify_one();
+        }
+
+        // removes the next chunk, waiting while the queue is empty, or returns nullopt once the producer has finished
+        //
+        optional<string> pop()
+        {
+            unique_lock lock( mutex_ );
+            not_empty_.wait( lock, [ this ] { return !chunks_.empty() || finished_; } );
+            if ( chunks_.empty() )
+            {
+                return nullopt;
+            }
+            string chunk = std::move( chunks_.front() );
+            chunks_.pop_front();
+            not_full_.notify_one();
+            return chunk;
+        }
+
+        // the producer's error, empty if none, once pop() has returned nullopt
+        //
+        const string& error() const
+        {
+            return error_;
+        }
+
+      private:
+        mutex mutex_;
+        condition_variable not_full_;
+        condition_variable not_empty_;
+        deque<string> chunks_;
+        const size_t max_chunks_;
+        bool finished_ = false;
+        bool stopped_ = false;
+        string error_;
+    };
+
+    // stops a queue's producer when destroyed, so that the producer's thread can be joined however the consumer returns
+    //
+    class StopOnExit
+    {
+      public:
+        explicit StopOnExit( ChunkQueue& queue )
+            : queue_( queue )
+        {
+        }
+
+        ~StopOnExit()
+        {
+            queue_.stop();
+        }
+
+      private:
+        ChunkQueue& queue_;
+    };
+
+    // A Sink for a Writer that passes what is written to the next stage in chunks, finishing when destroyed.
+    //
+    class ChunkSink
+    {
+      public:
+        ChunkSink( ChunkQueue& queue, size_t chunk_size )
+            : queue_( queue ),
+              chunk_size_( chunk_size )
+        {
+            chunk_.reserve( chunk_size_ );
+        }
+
+        ~ChunkSink()
+        {
+            flush();
+            queue_.finish();
+        }
+
+        void push_back( char c )
+        {
+            chunk_.push_back( c );
+            if ( chunk_.size() >= chunk_size_ )
+            {
+                flush();
+            }
+        }
+
+        void append( const char* s, size_t n )
+        {
+            chunk_.append( s, n );
+            if ( chunk_.size() >= chunk_size_ )
+            {
+                flush();
+            }
+        }
+
+      private:
+        void flush()
+        {
+            if ( !chunk_.empty() )
+            {
+                queue_.push( std::move( chunk_ ) );
+                chunk_ = string();
+                chunk_.reserve( chunk_size_ );
+            }
+        }
+
+        ChunkQueue& queue_;
+        const size_t chunk_size_;
+        string chunk_;
+    };
+
+    // Parses one element of a top level array, positioning errors within the whole document and sharing the
+    // document's depth and memory budget.
+    //
+    class ElementParser : public detail::Parser<false>
+    {
+      public:
+        ElementParser( const string& element, const ParseOptions& options, int line, int column, size_t memory_left )
+            : Parser( element, options )
+        {
+            posn_.continue_from( line, column );
+            depth_ = 1; // within the top level array
+            memory_left_ = memory_left;
+        }
+
+        size_t memory_left() const
+        {
+            return memory_left_;
+        }
+    };
+
+    // Parses JSON given in chunks. A top level array is parsed an element at a time, as soon as the text of each
+    // element is complete, so only one element's text is held. Any other value is parsed once all of its text is in.
+    //
+    class ChunkedParser
+    {
+      public:
+        explicit ChunkedParser( const ParseOptions& options )
+            : options_( options ),
+              max_elements_( options.max_container_elements == 0 ? SIZE_MAX : options.max_container_elements ),
+              memory_left_( options.max_memory == 0 ? SIZE_MAX : options.max_memory )
+        {
+        }
+
+        expected<void, string> add( string_view chunk )
+        {
+            for ( size_t i = 0; i < chunk.size(); ++i )
+            {
+                const char c = chunk[ i ];
+
+                if ( state_ == State::whole )
+                {
+                    text_.append( chunk.substr( i ) );
+                    return {};
+                }
+
+                if ( state_ == State::start )
+                {
+                    if ( c == '[' )
+                    {
+                        state_ = State::in_array;
+                        advance( c );
+                        start_element();
+                    }
+                    else if ( isspace( static_cast<unsigned char>( c ) ) )
+                    {
+                        text_.push_back( c );
+                        advance( c );
+                    }
+                    else
+                    {
+                        state_ = State::whole;
+                        --i; // append this char with the rest of the chunk
+                    }
+                    continue;
+                }
+
+                if ( state_ == State::ended )
+                {
+                    if ( !isspace( static_cast<unsigned char>( c ) ) )
+                    {
+                        return std::unexpected( "unprocessed data" + where( line_, column_ ) );
+                    }
+                    advance( c );
+                    continue;
+                }
+
+                // within the top level array, finding where its elements end without parsing them
+                if ( in_string_ )
+                {
+                    if ( escaped_ )
+                    {
+                        escaped_ = false;
+                    }
+                    else if ( c == '\\' )
+                    {
+                        escaped_ = true;
+                    }
+                    else if ( c == '"' )
+                    {
+                        in_string_ = false;
+                    }
+                }
+                else if ( c == '"' )
+                {
+                    in_string_ = true;
+                }
+                else if ( c == '[' || c == '{' )
+                {
+                    ++depth_;
+                }
+                else if ( ( c == ']' || c == '}' ) && depth_ > 0 )
+                {
+                    --depth_;
+                }
+                else if ( depth_ == 0 && ( c == ',' || c == ']' ) )
+                {
+                    if ( auto result = end_element( c ); !result )
+                    {
+                        return result;
+                    }
+
+                    advance( c );
+
+                    if ( c == ']' )
+                    {
+                        state_ = State::ended;
+                    }
+                    else
+                    {
+                        start_element();
+                    }
+                    continue;
+                }
+
+                element_.push_back( c );
+                advance( c );
+            }
+
+            return {};
+        }
+
+        // returns the value once all of the chunks have been added
+        //
+        expected<Value, string> finish()
+        {
+            if ( state_ == State::start || state_ == State::whole )
+            {
+                return parse( text_, options_ );
+            }
+
+            if ( state_ == State::in_array )
+            {
+                return std::unexpected( ( in_string_ ? "missing closing '\"'" : "missing closing ']'" ) + where( line_, column_ ) );
+            }
+
+            if ( options_.pack_integer_arrays && !options_.raw_numbers && !array_.empty() &&
+                 std::ranges::all_of( array_, []( const Value& v ) { return std::holds_alternative<int64_t>( v ); } ) )
+            {
+                IntArray ints;
+                ints.reserve( array_.size() );
+                for ( const Value& v : array_ )
+                {
+                    ints.push_back( std::get<int64_t>( v ) );
+                }
+                return ints;
+            }
+
+            return std::move( array_ );
+        }
+
+      private:
+        enum class State
+        {
+            start,    // before the first non-whitespace
+            whole,    // collecting the text of a value that is not an array
+            in_array, // within the top level array
+            ended     // after the top level array
+        };
+
+        void advance( char c )
+        {
+            if ( c == '\n' )
+            {
+                ++line_;
+                column_ = 0;
+            }
+            else
+            {
+                ++column_;
+            }
+        }
+
+        void start_element()
+        {
+            element_.clear();
+            element_line_ = line_;
+            element_column_ = column_;
+        }
+
+        // parses the element ended by the delimiter, a ',' or the closing ']'
+        //
+        expected<void, string> end_element( char delimiter )
+        {
+            if ( std::ranges::all_of( element_, []( char c ) { return isspace( static_cast<unsigned char>( c ) ) != 0; } ) )
+            {
+                if ( delimiter == ']' && array_.empty() )
+                {
+                    return {}; // an empty array
+                }
+                return std::unexpected( string( "unexpected character '" ) + delimiter + "'" + where( line_, column_ ) );
+            }
+
+            if ( array_.size() == max_elements_ )
+            {
+                return std::unexpected( "array with more than the maximum of " + to_string( max_elements_ ) + " elements" +
+                                        where( element_line_, element_column_ ) );
+            }
+
+            ElementParser parser( element_, options_, element_line_, element_column_, memory_left_ );
+            expected<Value, string> value = parser.parse_completely();
+            if ( !value )
+            {
+                return std::unexpected( std::move( value.error() ) );
+            }
+            memory_left_ = parser.memory_left();
+
+            const size_t capacity = array_.capacity();
+
+            array_.push_back( std::move( *value ) );
+
+            const size_t growth = ( array_.capacity() - capacity ) * sizeof( Value );
+            if ( growth > memory_left_ )
+            {
+                return std::unexpected( "memory budget of " + to_string( options_.max_memory ) + " bytes exceeded" + where( line_, column_ ) );
+            }
+            memory_left_ -= growth;
+
+            return {};
+        }
+
+        const ParseOptions options_;
+        const size_t max_elements_;
+        size_t memory_left_;
+
+        State state_ = State::start;
+        string text_;    // of a value that is not an array
+        string element_; // the text of the current element of an array
+        Array array_;
+
+        int line_ = 0; // of the next char
+        int column_ = 0;
+        int element_line_ = 0; // of the start of the current element
+        int element_column_ = 0;
+
+        size_t depth_ = 0; // within the current element
+        bool in_string_ = false;
+        bool escaped_ = false;
+    };
+} // namespace
+
+class Decompressor::Impl
+{
+  public:
+    Impl( istream& in, Compression compression, size_t chunk_size )
+        : in_( in ),
+          compression_( compression ),
+          input_( chunk_size, '\0' )
+    {
+        if ( compression_ == Compression::gzip )
+        {
+            if ( inflateInit2( &zstream_, 15 + 16 ) != Z_OK ) // 16 for a gzip header
+            {
+                error_ = "could not start gzip decompression";
+            }
+        }
+        else
+        {
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+            dstream_ = ZSTD_createDStream();
+            if ( dstream_ == nullptr )
+            {
+                error_ = "could not start zstd decompression";
+            }
+#else
+            error_ = no_zstd;
+#endif
+        }
+    }
+
+    ~Impl()
+    {
+        if ( compression_ == Compression::gzip )
+        {
+            inflateEnd( &zstream_ );
+        }
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+        ZSTD_freeDStream( dstream_ );
+#endif
+    }
+
+    expected<size_t, string> read_some( span<char> buffer )
+    {
+        while ( error_.empty() && !buffer.empty() )
+        {
+            if ( pending_.empty() )
+            {
+                in_.read( input_.data(), input_.size() );
+                if ( in_.bad() )
+                {
+                    error_ = "read failed";
+                    break;
+                }
+
+                pending_ = string_view( input_.data(), in_.gcount() );
+                if ( pending_.empty() )
+                {
+                    if ( !at_end_of_frame_ )
+                    {
+                        error_ = "truncated compressed data";
+                        break;
+                    }
+                    return 0;
+                }
+            }
+
+            const size_t count = compression_ == Compression::gzip ? inflate_some( buffer ) : decompress_some( buffer );
+            if ( count > 0 )
+            {
+                return count;
+            }
+        }
+
+        if ( !error_.empty() )
+        {
+            return std::unexpected( error_ );
+        }
+        return 0;
+    }
+
+  private:
+    size_t inflate_some( span<char> buffer )
+    {
+        if ( at_end_of_frame_ )
+        {
+            inflateReset( &zstream_ ); // another gzip member follows
+            at_end_of_frame_ = false;
+        }
+
+        zstream_.next_in = reinterpret_cast<Bytef*>( const_cast<char*>( pending_.data() ) );
+        zstream_.avail_in = static_cast<uInt>( pending_.size() );
+        zstream_.next_out = reinterpret_cast<Bytef*>( buffer.data() );
+        zstream_.avail_out = static_cast<uInt>( buffer.size() );
+
+        const int ret = inflate( &zstream_, Z_NO_FLUSH );
+
+        pending_.remove_prefix( pending_.size() - zstream_.avail_in );
+
+        if ( ret == Z_STREAM_END )
+        {
+            at_end_of_frame_ = true;
+        }
+        else if ( ret != Z_OK && ret != Z_BUF_ERROR )
+        {
+            error_ = string( "invalid gzip data: " ) + ( zstream_.msg ? zstream_.msg : "error " + to_string( ret ) );
+        }
+
+        return buffer.size() - zstream_.avail_out;
+    }
+
+    size_t decompress_some( [[maybe_unused]] span<char> buffer )
+    {
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+        ZSTD_inBuffer input{ pending_.data(), pending_.size(), 0 };
+        ZSTD_outBuffer output{ buffer.data(), buffer.size(), 0 };
+
+        const size_t ret = ZSTD_decompressStream( dstream_, &output, &input );
+
+        pending_.remove_prefix( input.pos );
+
+        if ( ZSTD_isError( ret ) )
+        {
+            error_ = string( "invalid zstd data: " ) + ZSTD_getErrorName( ret );
+        }
+        at_end_of_frame_ = ret == 0; // any following frame is decompressed as a continuation
+
+        return output.pos;
+#else
+        return 0;
+#endif
+    }
+
+    istream& in_;
+    const Compression compression_;
+    string input_;        // compressed data read from the stream
+    string_view pending_; // the part of it not yet decompressed
+    bool at_end_of_frame_ = false;
+    string error_;
+    z_stream zstream_{};
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+    ZSTD_DStream* dstream_ = nullptr;
+#endif
+};
+
+Decompressor::Decompressor( istream& in, Compression compression, size_t chunk_size )
+    : impl_( make_unique<Impl>( in, compression, chunk_size ) )
+{
+}
+
+Decompressor::~Decompressor() = default;
+
+expected<size_t, string> Decompressor::read_some( span<char> buffer )
+{
+    return impl_->read_some( buffer );
+}
+
+class Compressor::Impl
+{
+  public:
+    Impl( ostream& out, Compression compression, size_t chunk_size )
+        : out_( out ),
+          compression_( compression ),
+          chunk_size_( chunk_size ),
+          output_( chunk_size, '\0' )
+    {
+        input_.reserve( chunk_size_ );
+
+        if ( compression_ == Compression::gzip )
+        {
+            if ( deflateInit2( &zstream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY ) != Z_OK ) // 16 for a gzip header
+            {
+                error_ = "could not start gzip compression";
+            }
+        }
+        else
+        {
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+            cstream_ = ZSTD_createCCtx();
+            if ( cstream_ == nullptr )
+            {
+                error_ = "could not start zstd compression";
+            }
+#else
+            error_ = no_zstd;
+#endif
+        }
+    }
+
+    ~Impl()
+    {
+        if ( compression_ == Compression::gzip )
+        {
+            deflateEnd( &zstream_ );
+        }
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+        ZSTD_freeCCtx( cstream_ );
+#endif
+    }
+
+    void push_back( char c )
+    {
+        input_.push_back( c );
+        if ( input_.size() >= chunk_size_ )
+        {
+            compress( false );
+        }
+    }
+
+    void append( const char* s, size_t n )
+    {
+        while ( n > 0 )
+        {
+            const size_t count = std::min( n, chunk_size_ - input_.size() );
+            input_.append( s, count );
+            s += count;
+            n -= count;
+
+            if ( input_.size() >= chunk_size_ )
+            {
+                compress( false );
+            }
+        }
+    }
+
+    expected<void, string> finish()
+    {
+        if ( !finished_ )
+        {
+            finished_ = true;
+            compress( true );
+            out_.flush();
+            if ( !out_ && error_.empty() )
+            {
+                error_ = "write failed";
+            }
+        }
+
+        if ( !error_.empty() )
+        {
+            return std::unexpected( error_ );
+        }
+        return {};
+    }
+
+  private:
+    // compresses the buffered input, and at the end anything held back by the compressor
+    //
+    void compress( bool end )
+    {
+        if ( error_.empty() )
+        {
+            if ( compression_ == Compression::gzip )
+            {
+                deflate_input( end );
+            }
+            else
+            {
+                compress_input( end );
+            }
+        }
+        input_.clear();
+    }
+
+    void deflate_input( bool end )
+    {
+        zstream_.next_in = reinterpret_cast<Bytef*>( input_.data() );
+        zstream_.avail_in = static_cast<uInt>( input_.size() );
+
+        do
+        {
+            zstream_.next_out = reinterpret_cast<Bytef*>( output_.data() );
+            zstream_.avail_out = static_cast<uInt>( output_.size() );
+
+            if ( deflate( &zstream_, end ? Z_FINISH : Z_NO_FLUSH ) == Z_STREAM_ERROR )
+            {
+                error_ = "gzip compression failed";
+                return;
+            }
+
+            write( output_.size() - zstream_.avail_out );
+        } while ( zstream_.avail_out == 0 && error_.empty() ); // the output was full, so there may be more
+    }
+
+    void compress_input( [[maybe_unused]] bool end )
+    {
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+        ZSTD_inBuffer input{ input_.data(), input_.size(), 0 };
+
+        while ( error_.empty() )
+        {
+            ZSTD_outBuffer output{ output_.data(), output_.size(), 0 };
+
+            const size_t remaining = ZSTD_compressStream2( cstream_, &output, &input, end ? ZSTD_e_end : ZSTD_e_continue );
+            if ( ZSTD_isError( remaining ) )
+            {
+                error_ = string( "zstd compression failed: " ) + ZSTD_getErrorName( remaining );
+                return;
+            }
+
+            write( output.pos );
+
+            if ( end ? remaining == 0 : input.pos == input.size )
+            {
+                return;
+            }
+        }
+#endif
+    }
+
+    void write( size_t count )
+    {
+        if ( !out_.write( output_.data(), count ) )
+        {
+            error_ = "write failed";
+        }
+    }
+
+    ostream& out_;
+    const Compression compression_;
+    const size_t chunk_size_;
+    string input_;  // waiting to be compressed
+    string output_; // compressed, to be written
+    bool finished_ = false;
+    string error_; // the first error, reported by finish()
+    z_stream zstream_{};
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+    ZSTD_CCtx* cstream_ = nullptr;
+#endif
+};
+
+Compressor::Compressor( ostream& out, Compression compression, size_t chunk_size )
+    : impl_( make_unique<Impl>( out, compression, chunk_size ) )
+{
+}
+
+Compressor::~Compressor() = default;
+
+void Compressor::push_back( char c )
+{
+    impl_->push_back( c );
+}
+
+void Compressor::append( const char* s, size_t n )
+{
+    impl_->append( s, n );
+}
+
+expected<void, string> Compressor::finish()
+{
+    return impl_->finish();
+}
+
+expected<Value, string> simple_json::parse_compressed( istream& in, Compression compression, const ParseOptions& options,
+                                                       const StreamOptions& stream_options )
+{
+    Decompressor decompressor( in, compression, stream_options.chunk_size );
+    ChunkedParser parser( options );
+
+    if ( !stream_options.threaded )
+    {
+        string chunk( stream_options.chunk_size, '\0' );
+        while ( true )
+        {
+            const expected<size_t, string> count = decompressor.read_some( chunk );
+            if ( !count )
+            {
+                return std::unexpected( count.error() );
+            }
+            if ( *count == 0 )
+            {
+                return parser.finish();
+            }
+            if ( auto added = parser.add( string_view( chunk ).substr( 0, *count ) ); !added )
+            {
+                return std::unexpected( std::move( added.error() ) );
+            }
+        }
+    }
+
+    ChunkQueue queue( stream_options.max_queued_chunks );
+
+    jthread decompressing( [ & ]() {
+        while ( true )
+        {
+            string chunk( stream_options.chunk_size, '\0' );
+            const expected<size_t, string> count = decompressor.read_some( chunk );
+            if ( !count || *count == 0 )
+            {
+                queue.finish( count ? string() : count.error() );
+                return;
+            }
+            chunk.resize( *count );
+            if ( !queue.push( std::move( chunk ) ) )
+            {
+                return; // the parse failed
+            }
+        }
+    } );
+
+    const StopOnExit stop( queue );
+
+    while ( const optional<string> chunk = queue.pop() )
+    {
+        if ( auto added = parser.add( *chunk ); !added )
+        {
+            return std::unexpected( std::move( added.error() ) );
+        }
+    }
+
+    if ( !queue.error().empty() )
+    {
+        return std::unexpected( queue.error() );
+    }
+    return parser.finish();
+}
+
+expected<void, string> simple_json::write_compressed( ostream& out, const Value& value, Compression compression, const StreamOptions& stream_options )
+{
+    Compressor compressor( out, compression, stream_options.chunk_size );
+
+    if ( !stream_options.threaded )
+    {
+        Writer<Compressor> writer( compressor );
+        writer.value( value );
+        return compressor.finish();
+    }
+
+    {
+        ChunkQueue queue( stream_options.max_queued_chunks );
+
+        jthread compressing( [ & ]() {
+            while ( const optional<string> chunk = queue.pop() )
+            {
+                compressor.append( chunk->data(), chunk->size() );
+            }
+        } );
+
+        ChunkSink sink( queue, stream_options.chunk_size ); // finishes the queue when destroyed, before the thread is joined
+        Writer<ChunkSink> writer( sink );
+        writer.value( value );
+    }
+
+    return compressor.finish();
+}
@@ -0,0 +1,90 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Reads and writes gzip or zstd compressed JSON as a pipeline of stages that pass bounded chunks to each other,
+// optionally on separate threads, so that the compressed data is never held in memory as a whole.
+//
+// Built when zlib is found, which defines SIMPLE_JSON_HAVE_ZLIB, with zstd support when libzstd is also found,
+// which defines SIMPLE_JSON_HAVE_ZSTD.
+
+#pragma once
+#include "simple_json.h"
+#include <iosfwd>
+#include <memory>
+#include <span>
+
+namespace simple_json
+{
+    enum class Compression
+    {
+        gzip,
+        zstd
+    };
+
+    struct StreamOptions
+    {
+        bool threaded = true;           // run the decompression or compression on a thread of its own
+        size_t chunk_size = 64 * 1024;  // of the data passed from one stage to the next
+        size_t max_queued_chunks = 4;   // waiting between threaded stages
+    };
+
+    // A stage that reads compressed data from a stream and decompresses it a chunk at a time. Concatenated
+    // compressed streams, e.g. from appending to a .gz file, decompress as one.
+    //
+    class Decompressor
+    {
+      public:
+        Decompressor( std::istream& in, Compression compression, size_t chunk_size = StreamOptions().chunk_size );
+        ~Decompressor();
+
+        // decompresses data into the buffer, returning the number of chars, 0 at the end of the data, or an error
+        //
+        std::expected<size_t, std::string> read_some( std::span<char> buffer );
+
+      private:
+        class Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+    // A stage that compresses data a chunk at a time and writes it to a stream. It is a Sink for a Writer, e.g.
+    //
+    //     Compressor compressor( file, Compression::gzip );
+    //     Writer writer( compressor );
+    //     ...
+    //     auto result = compressor.finish();
+    //
+    class Compressor
+    {
+      public:
+        Compressor( std::ostream& out, Compression compression, size_t chunk_size = StreamOptions().chunk_size );
+        ~Compressor();
+
+        void push_back( char c );
+
+        void append( const char* s, size_t n );
+
+        // compresses what is left, ends the compressed data and flushes the stream, returning the first error of any
+        // of the writes
+        //
+        std::expected<void, std::string> finish();
+
+      private:
+        class Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+    // parses compressed JSON from a stream as it is decompressed
+    // A top level array is parsed an element at a time as the text of each is complete, so that only one element's
+    // text is held rather than the whole document's, and when threaded the parsing overlaps the decompression.
+    // Errors and limits are as for parse() on the decompressed text.
+    //
+    std::expected<Value, std::string> parse_compressed( std::istream& in, Compression compression, const ParseOptions& options = ParseOptions(),
+                                                        const StreamOptions& stream_options = StreamOptions() );
+
+    // formats a value in compact form and writes it compressed to a stream as it is formatted, when threaded
+    // compressing each chunk while the next is formatted
+    //
+    std::expected<void, std::string> write_compressed( std::ostream& out, const Value& value, Compression compression,
+                                                       const StreamOptions& stream_options = StreamOptions() );
+
+} // namespace simple_json
@@ -0,0 +1,96 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Implementation details shared by the simple_json source files, not part of the API.
+
+#pragma once
+#include "simple_json.h"
+#include <algorithm>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+namespace simple_json::detail
+{
+    // returns the two char escape sequence a char is written as, or nullptr if it is written as it is
+    //
+    inline const char* escape_sequence( char c )
+    {
+        switch ( c )
+        {
+        case '"':
+            return "\\\"";
+        case '\\':
+            return "\\\\";
+        case '/':
+            return "\\/";
+        case '\b':
+            return "\\b";
+        case '\f':
+            return "\\f";
+        case '\n':
+            return "\\n";
+        case '\r':
+            return "\\r";
+        case '\t':
+            return "\\t";
+        default:
+            return nullptr;
+        }
+    }
+
+    // writes a string in quotes, escaping any special chars
+    // The Sink, e.g. std::string, needs push_back( char ) and append( const char*, size_t ).
+    //
+    template <typename Sink>
+    void append_quoted( Sink& sink, std::string_view s )
+    {
+        sink.push_back( '"' );
+
+        size_t unescaped_start = 0; // chars that need no escaping are appended in runs
+
+        for ( size_t i = 0; i < s.size(); ++i )
+        {
+            if ( const char* escaped = escape_sequence( s[ i ] ) )
+            {
+                sink.append( s.data() + unescaped_start, i - unescaped_start );
+                sink.append( escaped, 2 );
+                unescaped_start = i + 1;
+            }
+        }
+        sink.append( s.data() + unescaped_start, s.size() - unescaped_start );
+
+        sink.push_back( '"' );
+    }
+
+    // appends num_spaces spaces, copied from a precomputed run of spaces rather than one at a time
+    //
+    template <typename Sink>
+    void append_spaces( Sink& sink, size_t num_spaces )
+    {
+        static constexpr std::string_view spaces = "                                                                "; // 64
+
+        for ( ; num_spaces > spaces.size(); num_spaces -= spaces.size() )
+        {
+            sink.append( spaces.data(), spaces.size() );
+        }
+        sink.append( spaces.data(), num_spaces );
+    }
+
+    // returns the members of an OrderedObject sorted by name, keeping members with the same name in order,
+    // as a range of references to them like the members of an Object
+    //
+    inline auto sorted_members( const OrderedObject& obj )
+    {
+        std::vector<const OrderedObject::value_type*> members;
+        members.reserve( obj.size() );
+        for ( const auto& member : obj )
+        {
+            members.push_back( &member );
+        }
+        std::stable_sort( members.begin(), members.end(), []( const auto* a, const auto* b ) { return a->first < b->first; } );
+
+        return std::move( members ) | std::views::transform( []( const auto* member ) -> const auto& { return *member; } );
+    }
+
+} // namespace simple_json::detail
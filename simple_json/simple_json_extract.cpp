@@ -0,0 +1,218 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_extract.h"
+#include "simple_json_parser.h"
+#include <algorithm>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    // Scans the members of the top-level object, parsing the values of the requested ones with the grammar of
+    // parse() and stepping over the others.
+    //
+    class ExtractParser : public detail::Parser<false>
+    {
+      public:
+        ExtractParser( const string& json_str, const ParseOptions& options )
+            : Parser( json_str, options )
+        {
+        }
+
+        Result extract( span<const string_view> names, span<optional<Value>> values )
+        {
+            skip_whitespace();
+
+            if ( posn_() == end_ || *posn_() != '{' )
+            {
+                return std::unexpected( "expected an object" + where() );
+            }
+
+            posn_.incr();
+            depth_ = 1; // the values are inside the object
+
+            for ( size_t remaining = names.size(); remaining > 0; )
+            {
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "missing closing '}'" + where() );
+                }
+
+                if ( *posn_() == '}' )
+                {
+                    posn_.incr();
+                    skip_whitespace();
+                    if ( posn_() != end_ )
+                    {
+                        return std::unexpected( "unprocessed data" + where() );
+                    }
+                    return {}; // some names not found
+                }
+
+                if ( *posn_() == '"' )
+                {
+                    name_.clear();
+
+                    Result result = parse_name( name_ );
+                    if ( !result )
+                    {
+                        return result;
+                    }
+
+                    const size_t i = find( names.begin(), names.end(), name_ ) - names.begin();
+
+                    if ( i < names.size() && !values[ i ] )
+                    {
+                        Value value;
+                        result = parse_value( value );
+                        if ( result )
+                        {
+                            values[ i ] = std::move( value );
+                            --remaining;
+                        }
+                    }
+                    else
+                    {
+                        result = skip_value();
+                    }
+
+                    if ( !result )
+                    {
+                        return result;
+                    }
+                }
+                else if ( *posn_() == ',' )
+                {
+                    posn_.incr(); // skip ','
+                }
+                else
+                {
+                    return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+                }
+            }
+
+            return {};
+        }
+
+      private:
+        // steps over a value without decoding it, checking scalars as parse() does, but arrays and objects only for
+        // balanced brackets and closed strings
+        //
+        Result skip_value()
+        {
+            switch ( *posn_() )
+            {
+            case '{':
+            case '[':
+                return skip_container();
+            case '"':
+                return skip_string();
+            case 't':
+                return parse_true().transform( []( bool ) {} );
+            case 'f':
+                return parse_false().transform( []( bool ) {} );
+            case 'n':
+                return parse_null().transform( []( Null ) {} );
+            }
+            if ( at_integer() )
+            {
+                return parse_number().transform( []( string_view ) {} );
+            }
+            return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+        }
+
+        Result skip_string()
+        {
+            const auto close = string_end( posn_() + 1 );
+            posn_.skip_to( close );
+
+            if ( close == end_ )
+            {
+                return std::unexpected( "missing closing '\"'" + where() );
+            }
+
+            posn_.incr(); // skip the closing '"'
+            return {};
+        }
+
+        // steps over an array or object by scanning for brackets, keeping the closing bracket expected at each level
+        //
+        Result skip_container()
+        {
+            closers_.clear();
+
+            for ( auto p = posn_(); p != end_; ++p )
+            {
+                switch ( *p )
+                {
+                case '"':
+                    p = string_end( p + 1 );
+                    if ( p == end_ )
+                    {
+                        posn_.skip_to( p );
+                        return std::unexpected( "missing closing '\"'" + where() );
+                    }
+                    break;
+                case '[':
+                case '{':
+                    if ( depth_ + closers_.size() == max_depth_ )
+                    {
+                        posn_.skip_to( p );
+                        return std::unexpected( "nesting deeper than the maximum depth of " + to_string( max_depth_ ) + where() );
+                    }
+                    closers_.push_back( *p == '[' ? ']' : '}' );
+                    break;
+                case ']':
+                case '}':
+                    if ( *p != closers_.back() )
+                    {
+                        posn_.skip_to( p );
+                        return std::unexpected( string( "unexpected character '" ) + *p + "'" + where() );
+                    }
+                    closers_.pop_back();
+                    if ( closers_.empty() )
+                    {
+                        posn_.skip_to( p + 1 );
+                        return {};
+                    }
+                    break;
+                }
+            }
+
+            posn_.skip_to( end_ );
+            return std::unexpected( string( "missing closing '" ) + closers_.back() + "'" + where() );
+        }
+
+        // returns the position of the '"' closing a string, or the end of the input
+        //
+        string::const_iterator string_end( string::const_iterator p ) const
+        {
+            while ( ( p = std::find( p, end_, '"' ) ) != end_ )
+            {
+                auto backslash = p;
+                while ( *( backslash - 1 ) == '\\' )
+                {
+                    --backslash;
+                }
+                if ( ( p - backslash ) % 2 == 0 )
+                {
+                    return p; // not escaped
+                }
+                ++p;
+            }
+            return p;
+        }
+
+        string name_;     // of the member being scanned, reused for each one
+        string closers_;  // the closing brackets of the containers being stepped over
+    };
+} // namespace
+
+expected<void, string> detail::extract( const string& json_str, span<const string_view> names, span<optional<Value>> values, const ParseOptions& options )
+{
+    return ExtractParser( json_str, options ).extract( names, values );
+}
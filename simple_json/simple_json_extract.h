@@ -0,0 +1,48 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Extracts a few members of a JSON object without parsing the rest of it, e.g. to route messages, as in
+//
+//     const auto fields = extract( json, { "type", "tenant" } );
+//
+//     if ( fields && ( *fields )[ 0 ] == Value( "order.created" ) ) ...
+//
+// Only the top level of the object is scanned. The values of the requested members are parsed into Values, the
+// values of the others are stepped over without being decoded, and the scan stops as soon as every requested member
+// has been found, so the cost depends on where the members are rather than on the size of the message.
+
+#pragma once
+#include "simple_json.h"
+#include <array>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace simple_json
+{
+    namespace detail
+    {
+        std::expected<void, std::string> extract( const std::string& json_str, std::span<const std::string_view> names,
+                                                  std::span<std::optional<Value>> values, const ParseOptions& options );
+    }
+
+    // returns the values of the first members of a JSON object with the names, or nullopt for each one not found
+    // Malformed JSON is reported, with the same errors as parse(), up to where the scan stops. Values that are
+    // stepped over are checked only for balanced brackets and closed strings, and the text after the last member
+    // found is not checked at all. The options apply to the values returned, and their maximum depth also to the
+    // values stepped over.
+    //
+    template <size_t N>
+    std::expected<std::array<std::optional<Value>, N>, std::string> extract( const std::string& json_str, const std::string_view ( &names )[ N ],
+                                                                            const ParseOptions& options = ParseOptions() )
+    {
+        std::array<std::optional<Value>, N> values;
+
+        if ( auto result = detail::extract( json_str, names, values, options ); !result )
+        {
+            return std::unexpected( std::move( result.error() ) );
+        }
+        return values;
+    }
+
+} // namespace simple_json
@@ -0,0 +1,84 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_many.h"
+#include "simple_json_parser.h"
+#include <algorithm>
+
+using namespace simple_json;
+using namespace std;
+
+// Parses one document after another, keeping its position and line count between them.
+//
+class detail::ManyParser : public detail::Parser<false>
+{
+  public:
+    ManyParser( const string& json_str, const ParseOptions& options )
+        : Parser( json_str, options ),
+          begin_( json_str.begin() ),
+          start_( json_str.begin() )
+    {
+    }
+
+    // parses the next document, returning false if there are none left
+    //
+    bool next( ParsedDocument& document )
+    {
+        if ( failed_ )
+        {
+            // a truncated document runs on into the ones after it, so go back to the line after the one it started on
+            posn_ = start_;
+            const auto newline = std::find( posn_(), end_, '\n' );
+            posn_.skip_to( newline == end_ ? end_ : newline + 1 );
+            failed_ = false;
+        }
+
+        skip_whitespace();
+
+        if ( posn_() == end_ )
+        {
+            return false;
+        }
+
+        // each document has the whole of the limits, whatever an earlier one used or left unfinished
+        depth_ = 0;
+        memory_left_ = limit( options_.max_memory );
+
+        start_ = posn_;
+        document.offset = posn_() - begin_;
+
+        Result result = parse_value( document.value.emplace() );
+        if ( !result )
+        {
+            document.value = std::unexpected( std::move( result.error() ) );
+            failed_ = true;
+        }
+
+        document.size = posn_() - begin_ - document.offset;
+        return true;
+    }
+
+  private:
+    const string::const_iterator begin_;
+    Position start_;      // of the document being parsed
+    bool failed_ = false; // so the next document starts on the line after its start
+};
+
+DocumentStream::DocumentStream( const string& json_str, const ParseOptions& options )
+    : parser_( make_unique<detail::ManyParser>( json_str, options ) )
+{
+}
+
+DocumentStream::DocumentStream( DocumentStream&& other ) noexcept = default;
+
+DocumentStream::~DocumentStream() = default;
+
+void DocumentStream::next()
+{
+    at_end_ = !parser_->next( document_ );
+}
+
+DocumentStream simple_json::parse_many( const string& json_str, const ParseOptions& options )
+{
+    return DocumentStream( json_str, options );
+}
@@ -0,0 +1,114 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Parses a string of concatenated JSON documents, such as a log with one document per line, e.g.
+//
+//     for ( ParsedDocument& document : parse_many( log ) )
+//     {
+//         if ( document.value ) replay( *document.value ); else report( document.offset, document.value.error() );
+//     }
+//
+// The documents may be separated by whitespace or follow each other directly where that is unambiguous, as in
+// {"a":1}{"b":2} or "a"[1]. One parser works through the whole string, so its state is set up once rather than for
+// each document, and errors give the line and column in the whole string.
+
+#pragma once
+#include "simple_json.h"
+#include <iterator>
+#include <memory>
+
+namespace simple_json
+{
+    namespace detail
+    {
+        class ManyParser;
+    }
+
+    // A document parsed by parse_many(), or the error that stopped it, and where it is in the string.
+    //
+    struct ParsedDocument
+    {
+        std::expected<Value, std::string> value;
+        size_t offset = 0; // of the document's first char
+        size_t size = 0;   // chars up to the end of the document, or up to the error
+    };
+
+    // The documents of a string, parsed one at a time as it is iterated over, which must not outlive the string.
+    // After a malformed document, parsing carries on at the start of the line after the one the document started
+    // on, so a truncated line loses only itself, though what is left of a malformed document spread over several
+    // lines may then be parsed as documents or errors of its own.
+    //
+    class DocumentStream
+    {
+      public:
+        class Iterator
+        {
+          public:
+            using value_type = ParsedDocument;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+
+            explicit Iterator( DocumentStream* stream )
+                : stream_( stream )
+            {
+            }
+
+            // the document, whose value may be moved out of before moving on to the next one
+            //
+            ParsedDocument& operator*() const
+            {
+                return stream_->document_;
+            }
+
+            Iterator& operator++()
+            {
+                stream_->next();
+                return *this;
+            }
+
+            void operator++( int )
+            {
+                ++*this;
+            }
+
+            bool operator==( std::default_sentinel_t ) const
+            {
+                return stream_->at_end_;
+            }
+
+          private:
+            DocumentStream* stream_ = nullptr;
+        };
+
+        DocumentStream( const std::string& json_str, const ParseOptions& options );
+        DocumentStream( DocumentStream&& other ) noexcept;
+        ~DocumentStream();
+
+        // parses the first document, so may only be called once
+        //
+        Iterator begin()
+        {
+            next();
+            return Iterator( this );
+        }
+
+        std::default_sentinel_t end() const
+        {
+            return std::default_sentinel;
+        }
+
+      private:
+        void next();
+
+        std::unique_ptr<detail::ManyParser> parser_;
+        ParsedDocument document_;
+        bool at_end_ = false;
+    };
+
+    // returns the documents of a string of concatenated JSON, each parsed as parse() would with the options, the
+    // limits applying to each document separately
+    //
+    DocumentStream parse_many( const std::string& json_str, const ParseOptions& options = ParseOptions() );
+
+} // namespace simple_json
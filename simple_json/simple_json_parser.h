@@ -0,0 +1,960 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// The parser used by parse(), shared with the other parsers in the library that build
+// different representations from the same grammar. Not part of the public interface.
+
+#pragma once
+#include "simple_json.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+namespace simple_json::detail
+{
+    // Parses a JSON string. If collect_stats is true the parser also fills in a ParseStats,
+    // otherwise all the code that does so is discarded at compile time.
+    //
+    template <bool collect_stats>
+    class Parser
+    {
+      public:
+        Parser( const std::string& json_str, const ParseOptions& options = ParseOptions() )
+            : posn_( json_str.begin() ),
+              end_( json_str.end() ),
+              options_( options ),
+              max_depth_( limit( options.max_depth ) ),
+              max_string_bytes_( limit( options.max_string_bytes ) ),
+              max_elements_( limit( options.max_container_elements ) ),
+              memory_left_( limit( options.max_memory ) )
+        {
+            if constexpr ( collect_stats )
+            {
+                stats_.begin = json_str.begin();
+            }
+        }
+
+        const ParseStats& stats() const
+            requires collect_stats
+        {
+            return stats_.stats;
+        }
+
+        std::expected<Value, std::string> parse_completely()
+        {
+            [[maybe_unused]] auto timer = time( &ParseStats::total_time );
+
+            Value value;
+            Result result = parse_value( value );
+
+            if ( result )
+            {
+                // Check that we have consumed the entire input string
+                skip_whitespace();
+                if ( posn_() != end_ )
+                {
+                    result = std::unexpected( "unprocessed data" + where() );
+                }
+            }
+
+            if constexpr ( collect_stats )
+            {
+                stats_.stats.bytes_consumed = posn_() - stats_.begin;
+            }
+
+            if ( !result )
+            {
+                return std::unexpected( std::move( result.error() ) );
+            }
+            return value;
+        }
+
+      protected:
+        // The parse functions build the tree in place, each parsing into a value, element or member that its
+        // caller has already added to the tree, so nothing is moved or copied up the levels of the tree.
+        //
+        using Result = std::expected<void, std::string>;
+
+        class Position;
+
+        Result parse_value( Value& value )
+        {
+            skip_whitespace();
+
+            if ( posn_() == end_ )
+            {
+                return std::unexpected( "end of string reached while looking for value" + where() );
+            }
+            if ( *posn_() == '{' || *posn_() == '[' )
+            {
+                return parse_container( value );
+            }
+            if ( *posn_() == '"' )
+            {
+                count( &ParseStats::strings );
+                return parse_string( value.emplace<std::string>() );
+            }
+            if ( *posn_() == 't' )
+            {
+                count( &ParseStats::booleans );
+                return parse_true().transform( [ & ]( bool b ) { value = b; } );
+            }
+            if ( *posn_() == 'f' )
+            {
+                count( &ParseStats::booleans );
+                return parse_false().transform( [ & ]( bool b ) { value = b; } );
+            }
+            if ( *posn_() == 'n' )
+            {
+                count( &ParseStats::nulls );
+                return parse_null().transform( [ & ]( Null n ) { value = n; } );
+            }
+            if ( at_integer() )
+            {
+                count( &ParseStats::integers );
+                if ( options_.raw_numbers )
+                {
+                    return parse_number().and_then( [ & ]( std::string_view text ) -> Result {
+                        if ( text.size() > small_string_capacity )
+                        {
+                            if ( !charge( text.size() + 1 ) )
+                            {
+                                return over_budget();
+                            }
+                            if constexpr ( collect_stats )
+                            {
+                                count_growth( 0, text.size(), 1, 1 ); // one extra byte for the terminating null
+                            }
+                        }
+                        value.emplace<RawNumber>( std::string( text ) );
+                        return {};
+                    } );
+                }
+                return parse_integer().transform( [ & ]( int64_t i ) { value = i; } );
+            }
+            return std::unexpected( std::string( "unexpected character '" ) + *posn_() + "'" + where() );
+        }
+
+        // returns a value on its own, for parsers that keep values outside a Value tree
+        //
+        std::expected<Value, std::string> parse_value()
+        {
+            Value value;
+            return parse_value( value ).transform( [ & ]() { return std::move( value ); } );
+        }
+
+        // parses an array or object, one level deeper
+        //
+        Result parse_container( Value& value )
+        {
+            if ( depth_ == max_depth_ )
+            {
+                return std::unexpected( "nesting deeper than the maximum depth of " + std::to_string( max_depth_ ) + where() );
+            }
+
+            ++depth_;
+
+            Result result;
+            if ( *posn_() == '[' )
+            {
+                result = parse_array( value );
+            }
+            else if ( options_.ordered_objects )
+            {
+                result = parse_object( value.emplace<OrderedObject>() );
+            }
+            else
+            {
+                result = parse_object( value.emplace<Object>() );
+            }
+
+            --depth_;
+            return result;
+        }
+
+        bool at_integer() const
+        {
+            return posn_() != end_ && ( isdigit( *posn_() ) || *posn_() == '-' );
+        }
+
+        Result parse_array( Value& value )
+        {
+            [[maybe_unused]] auto level = nest( &ParseStats::arrays );
+
+            posn_.incr(); // skip opening '['
+
+            skip_whitespace();
+
+            if ( posn_() == end_ )
+            {
+                return std::unexpected( "missing closing ']'" + where() );
+            }
+
+            if ( *posn_() == ']' )
+            {
+                posn_.incr(); // end of object, skip closing ']'
+                value.emplace<Array>();
+                return {};
+            }
+
+            IntArray ints;
+
+            if ( options_.pack_integer_arrays && !options_.raw_numbers )
+            {
+                while ( at_integer() )
+                {
+                    if ( ints.size() == max_elements_ )
+                    {
+                        return too_many_elements();
+                    }
+
+                    count( &ParseStats::integers );
+
+                    std::expected<int64_t, std::string> i = parse_integer();
+                    if ( !i )
+                    {
+                        return std::unexpected( i.error() );
+                    }
+
+                    const size_t capacity = ints.capacity();
+
+                    ints.push_back( *i );
+
+                    if ( ints.capacity() != capacity && !charge( ( ints.capacity() - capacity ) * sizeof( int64_t ) ) )
+                    {
+                        return over_budget();
+                    }
+
+                    if constexpr ( collect_stats )
+                    {
+                        count_growth( capacity, ints.capacity(), sizeof( int64_t ) );
+                    }
+
+                    skip_whitespace();
+
+                    if ( posn_() == end_ )
+                    {
+                        return std::unexpected( "missing closing ']'" + where() );
+                    }
+
+                    if ( *posn_() == ']' )
+                    {
+                        posn_.incr();
+                        value.emplace<IntArray>( std::move( ints ) );
+                        return {}; // end of array
+                    }
+
+                    if ( *posn_() != ',' )
+                    {
+                        return std::unexpected( std::string( "unexpected character '" ) + *posn_() + "'" + where() );
+                    }
+
+                    posn_.incr(); // skip ','
+                    skip_whitespace();
+                }
+            }
+
+            // if packing, found an element that is not an integer, so continue with the integers so far as Values
+            Array& arr = value.emplace<Array>( ints.begin(), ints.end() );
+
+            if ( !charge( arr.capacity() * sizeof( Value ) ) )
+            {
+                return over_budget();
+            }
+
+            if constexpr ( collect_stats )
+            {
+                count_growth( 0, arr.capacity(), sizeof( Value ) );
+            }
+
+            while ( true )
+            {
+                if ( arr.size() == max_elements_ )
+                {
+                    return too_many_elements();
+                }
+
+                const size_t capacity = arr.capacity();
+
+                Value& element = arr.emplace_back();
+
+                if ( arr.capacity() != capacity && !charge( ( arr.capacity() - capacity ) * sizeof( Value ) ) )
+                {
+                    return over_budget();
+                }
+
+                if constexpr ( collect_stats )
+                {
+                    count_growth( capacity, arr.capacity(), sizeof( Value ) );
+                }
+
+                Result result = parse_value( element );
+                if ( !result )
+                {
+                    return result;
+                }
+
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "missing closing ']'" + where() );
+                }
+
+                if ( *posn_() == ']' )
+                {
+                    posn_.incr();
+                    break; // end of array
+                }
+
+                if ( *posn_() == ',' )
+                {
+                    posn_.incr(); // skip ','
+                }
+                else
+                {
+                    return std::unexpected( std::string( "unexpected character '" ) + *posn_() + "'" + where() );
+                }
+            }
+            return {};
+        }
+
+        template <typename Obj>
+        Result parse_object( Obj& obj )
+        {
+            [[maybe_unused]] auto level = nest( &ParseStats::objects );
+
+            [[maybe_unused]] std::vector<Position> member_starts; // of the members not checked for duplicates as they are added
+
+            posn_.incr(); // skip opening '{'
+
+            size_t num_members = 0;
+
+            while ( true )
+            {
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "missing closing '}'" + where() );
+                }
+
+                if ( *posn_() == '}' )
+                {
+                    posn_.incr();
+                    break; // end of object
+                }
+
+                if ( *posn_() == '"' )
+                {
+                    if ( num_members++ == max_elements_ )
+                    {
+                        return std::unexpected( "object with more than the maximum of " + std::to_string( max_elements_ ) + " members" + where() );
+                    }
+
+                    const Position start = posn_;
+
+                    std::string name;
+
+                    Result result = parse_name( name );
+                    if ( result )
+                    {
+                        if constexpr ( std::is_same_v<Obj, OrderedObject> )
+                        {
+                            if ( options_.duplicate_keys == DuplicateKeys::error && obj.size() >= max_searched_members )
+                            {
+                                member_starts.push_back( start );
+                            }
+                        }
+                        result = parse_member( obj, std::move( name ), start );
+                    }
+                    if ( !result )
+                    {
+                        return result;
+                    }
+                }
+                else if ( *posn_() == ',' )
+                {
+                    posn_.incr(); // skip ','
+                }
+                else
+                {
+                    return std::unexpected( std::string( "unexpected character '" ) + *posn_() + "'" + where() );
+                }
+            }
+
+            if constexpr ( std::is_same_v<Obj, OrderedObject> )
+            {
+                return remove_duplicates( obj, member_starts );
+            }
+            return {};
+        }
+
+        // adds a member to an object and parses its value into it, applying the duplicate key option
+        // Members usually arrive in name order, so they are inserted at the end of the map first, which needs
+        // no search if the name is greater than all those so far.
+        //
+        Result parse_member( Object& obj, std::string&& name, const Position& start )
+        {
+            const size_t old_size = obj.size();
+
+            const auto it = obj.try_emplace( obj.end(), std::move( name ) );
+
+            if ( obj.size() == old_size )
+            {
+                return parse_duplicate( it->first, it->second, start ); // try_emplace() does not move a duplicate's name
+            }
+
+            if ( !charge( map_node_size ) )
+            {
+                return over_budget();
+            }
+
+            if constexpr ( collect_stats )
+            {
+                ++stats_.stats.allocations;
+                stats_.stats.allocated_bytes += map_node_size;
+            }
+            return parse_value( it->second );
+        }
+
+        // Only the first few members are checked for duplicates as they are added, by searching the ones before
+        // them, so that no index is built for a large object while it is parsed. remove_duplicates() checks the
+        // rest once the object is complete.
+        //
+        Result parse_member( OrderedObject& obj, std::string&& name, const Position& start )
+        {
+            if ( obj.size() < max_searched_members )
+            {
+                const auto it = obj.find( name );
+
+                if ( it != obj.end() )
+                {
+                    return parse_duplicate( it->first, it->second, start );
+                }
+            }
+
+            const size_t capacity = obj.capacity();
+
+            Value& value = obj.emplace_back( std::move( name ), Value() ).second;
+
+            if ( obj.capacity() != capacity && !charge( ( obj.capacity() - capacity ) * sizeof( OrderedObject::value_type ) ) )
+            {
+                return over_budget();
+            }
+
+            if constexpr ( collect_stats )
+            {
+                count_growth( capacity, obj.capacity(), sizeof( OrderedObject::value_type ) );
+            }
+            return parse_value( value );
+        }
+
+        // applies the duplicate key option to the members of a complete ordered object that were not checked as they
+        // were added, building its index once to find them
+        // For the error option, member_starts has the position of each of those members, to report the first duplicate.
+        //
+        Result remove_duplicates( OrderedObject& obj, const std::vector<Position>& member_starts )
+        {
+            if ( obj.size() <= max_searched_members )
+            {
+                return {};
+            }
+
+            if ( options_.duplicate_keys == DuplicateKeys::error )
+            {
+                const OrderedObject& members = obj;
+                for ( size_t pos = max_searched_members; pos < members.size(); ++pos )
+                {
+                    const auto it = members.begin() + pos;
+                    if ( members.find( it->first ) != it )
+                    {
+                        return std::unexpected( "duplicate member \"" + it->first + "\"" + member_starts[ pos - max_searched_members ].where() );
+                    }
+                }
+                return {};
+            }
+
+            obj.remove_duplicates( options_.duplicate_keys == DuplicateKeys::keep_last );
+            return {};
+        }
+
+        Result parse_duplicate( std::string_view name, Value& existing, const Position& start )
+        {
+            Value value;
+
+            Result result = parse_value( value );
+            if ( !result )
+            {
+                return result;
+            }
+
+            switch ( options_.duplicate_keys )
+            {
+            case DuplicateKeys::keep_first:
+                break;
+            case DuplicateKeys::keep_last:
+                existing = std::move( value );
+                break;
+            case DuplicateKeys::error:
+                return std::unexpected( "duplicate member \"" + std::string( name ) + "\"" + start.where() );
+            }
+            return {};
+        }
+
+        void skip( int ( *pred )( int ) )
+        {
+            for ( ; posn_() != end_; posn_.incr() )
+            {
+                if ( !pred( *posn_() ) )
+                {
+                    break;
+                }
+            }
+        }
+
+        void skip_whitespace()
+        {
+            skip( std::isspace );
+        }
+
+        // parses a member's name and the ':' after it
+        //
+        Result parse_name( std::string& name )
+        {
+            count( &ParseStats::member_names );
+
+            Result result = parse_string( name );
+
+            if ( !result )
+            {
+                return result;
+            }
+
+            skip_whitespace();
+
+            if ( posn_() == end_ || *posn_() != ':' )
+            {
+                return std::unexpected( "missing ':'" + where() );
+            }
+
+            posn_.incr();
+
+            skip_whitespace();
+
+            if ( posn_() == end_ )
+            {
+                return std::unexpected( "end of string reached while looking for second of pair" + where() );
+            }
+
+            return {};
+        }
+
+        std::expected<std::string, std::string> parse_string()
+        {
+            std::string result;
+            return parse_string( result ).transform( [ & ]() { return std::move( result ); } );
+        }
+
+        Result parse_string( std::string& result )
+        {
+            [[maybe_unused]] auto timer = time( &ParseStats::string_time );
+
+            posn_.incr(); // Skip the opening '"'
+
+            [[maybe_unused]] size_t capacity = result.capacity();
+
+            const size_t max_size = std::min( max_string_bytes_, memory_left_ );
+
+            bool prev_esc = false;
+
+            for ( ; posn_() != end_; posn_.incr() ) // we don't want to skip whitespace here
+            {
+                if ( prev_esc )
+                {
+                    const char* alph_esc_chars = "bfnrt\"\\/";     // alphabetic escape characters
+                    const char* bin_esc_chars = "\b\f\n\r\t\"\\/"; // their binary equivalents
+
+                    const char* esc_pos = strchr( alph_esc_chars, *posn_() );
+                    if ( esc_pos == nullptr )
+                    {
+                        return std::unexpected( std::string( "invalid escape character '\\" ) + *posn_() + "'" + where() );
+                    }
+
+                    result.push_back( bin_esc_chars[ esc_pos - &alph_esc_chars[ 0 ] ] );
+
+                    if constexpr ( collect_stats )
+                    {
+                        ++stats_.stats.string_bytes_escaped;
+                    }
+
+                    prev_esc = false;
+                }
+                else if ( *posn_() == '"' )
+                {
+                    posn_.incr(); // Skip the closing '"'
+
+                    if ( result.capacity() > small_string_capacity && !charge( result.capacity() + 1 ) )
+                    {
+                        return over_budget();
+                    }
+
+                    return {};
+                }
+                else if ( *posn_() == '\\' )
+                {
+                    prev_esc = true;
+                }
+                else
+                {
+                    result.push_back( *posn_() );
+
+                    if constexpr ( collect_stats )
+                    {
+                        ++stats_.stats.string_bytes_copied;
+                    }
+                }
+
+                if ( result.size() > max_size )
+                {
+                    if ( result.size() > max_string_bytes_ )
+                    {
+                        return std::unexpected( "string longer than the maximum of " + std::to_string( max_string_bytes_ ) + " bytes" + where() );
+                    }
+                    return over_budget();
+                }
+
+                if constexpr ( collect_stats )
+                {
+                    count_growth( capacity, result.capacity(), 1, 1 ); // one extra byte for the terminating null
+                    capacity = result.capacity();
+                }
+            }
+
+            return std::unexpected( "missing closing '\"'" + where() );
+        }
+
+        std::expected<int64_t, std::string> parse_integer()
+        {
+            [[maybe_unused]] auto timer = time( &ParseStats::integer_time );
+
+            const std::string::const_iterator int_start = posn_();
+
+            posn_.incr(); // Skip the first character, possibly a '-'
+
+            skip( isdigit );
+
+            const std::string::const_iterator int_end = posn_();
+
+            int64_t value;
+            auto [ ptr, ec ] = std::from_chars( &*int_start, &*int_start + ( int_end - int_start ), value );
+            if ( ec == std::errc() )
+            {
+                return value;
+            }
+
+            return std::unexpected( "could not convert \"" + std::string( int_start, int_end ) + "\" to an integer" + where() );
+        }
+
+        // returns the text of a number, which may have a fraction and an exponent, without converting it
+        //
+        std::expected<std::string_view, std::string> parse_number()
+        {
+            [[maybe_unused]] auto timer = time( &ParseStats::integer_time );
+
+            const std::string::const_iterator number_start = posn_();
+
+            const auto skip_digits = [ this ]() {
+                const std::string::const_iterator digits_start = posn_();
+                skip( isdigit );
+                return posn_() != digits_start;
+            };
+
+            if ( *posn_() == '-' )
+            {
+                posn_.incr();
+            }
+
+            const std::string::const_iterator int_start = posn_();
+
+            bool valid = skip_digits() && !( *int_start == '0' && posn_() - int_start > 1 ); // no leading zeros
+
+            if ( valid && posn_() != end_ && *posn_() == '.' )
+            {
+                posn_.incr();
+                valid = skip_digits();
+            }
+
+            if ( valid && posn_() != end_ && ( *posn_() == 'e' || *posn_() == 'E' ) )
+            {
+                posn_.incr();
+                if ( posn_() != end_ && ( *posn_() == '+' || *posn_() == '-' ) )
+                {
+                    posn_.incr();
+                }
+                valid = skip_digits();
+            }
+
+            if ( !valid )
+            {
+                return std::unexpected( "invalid number \"" + std::string( number_start, posn_() ) + "\"" + where() );
+            }
+            return std::string_view( &*number_start, posn_() - number_start );
+        }
+
+        std::expected<void, std::string> parse_word( const std::string& word )
+        {
+            const size_t len = word.length();
+            if ( end_ - posn_() >= len && std::string( posn_(), posn_() + len ) == word )
+            {
+                posn_.incr( len ); // specified word found, skip over it
+                return {};
+            }
+            return std::unexpected( "expected \"" + word + "\"" + where() );
+        }
+
+        std::expected<bool, std::string> parse_true()
+        {
+            return parse_word( "true" ).transform( []() { return true; } ); // if parse_word() fails, the error will be propagated.
+        }
+
+        std::expected<bool, std::string> parse_false()
+        {
+            return parse_word( "false" ).transform( []() { return false; } ); // if parse_word() fails, the error will be propagated.
+        }
+
+        std::expected<Null, std::string> parse_null()
+        {
+            return parse_word( "null" ).transform( []() { return Null(); } ); // if parse_word() fails, the error will be propagated.
+        }
+
+        std::string where() const
+        {
+            return posn_.where();
+        }
+
+        // the size of a std::map node, the member and the red-black tree's colour and three links
+        static constexpr size_t map_node_size = sizeof( Object::value_type ) + 4 * sizeof( void* );
+
+        // the members of an ordered object that are searched for a duplicate name as each one is added
+        static constexpr size_t max_searched_members = 8;
+
+        // the longest string held without allocating
+        static constexpr size_t small_string_capacity = std::string().capacity();
+
+        // a limit from the options, with no limit as the largest size so that checking it needs no test for 0
+        //
+        static size_t limit( size_t option )
+        {
+            return option == 0 ? SIZE_MAX : option;
+        }
+
+        // takes bytes from what is left of the memory budget, returning false if there is not enough
+        //
+        bool charge( size_t bytes )
+        {
+            if ( bytes > memory_left_ )
+            {
+                return false;
+            }
+            memory_left_ -= bytes;
+            return true;
+        }
+
+        std::unexpected<std::string> over_budget() const
+        {
+            return std::unexpected( "memory budget of " + std::to_string( options_.max_memory ) + " bytes exceeded" + where() );
+        }
+
+        std::unexpected<std::string> too_many_elements() const
+        {
+            return std::unexpected( "array with more than the maximum of " + std::to_string( max_elements_ ) + " elements" + where() );
+        }
+
+        struct Stats
+        {
+            ParseStats stats;
+            std::string::const_iterator begin;
+            size_t depth = 0;
+        };
+
+        struct NoStats
+        {
+        };
+
+        // adds the time from its construction to its destruction to one of the stats' times
+        //
+        class Timer
+        {
+          public:
+            Timer( std::chrono::nanoseconds& total )
+                : total_( total ),
+                  start_( std::chrono::steady_clock::now() )
+            {
+            }
+
+            Timer( const Timer& ) = delete;
+
+            ~Timer()
+            {
+                total_ += std::chrono::steady_clock::now() - start_;
+            }
+
+          private:
+            std::chrono::nanoseconds& total_;
+            std::chrono::steady_clock::time_point start_;
+        };
+
+        // counts an array or object, and its depth until the returned object is destroyed
+        //
+        class Level
+        {
+          public:
+            Level( Stats& stats )
+                : stats_( stats )
+            {
+                stats_.stats.max_depth = std::max( stats_.stats.max_depth, ++stats_.depth );
+            }
+
+            Level( const Level& ) = delete;
+
+            ~Level()
+            {
+                --stats_.depth;
+            }
+
+          private:
+            Stats& stats_;
+        };
+
+        auto time( std::chrono::nanoseconds ParseStats::* phase )
+        {
+            if constexpr ( collect_stats )
+            {
+                return Timer( stats_.stats.*phase );
+            }
+            else
+            {
+                return NoStats();
+            }
+        }
+
+        auto nest( size_t ParseStats::* counter )
+        {
+            if constexpr ( collect_stats )
+            {
+                ++( stats_.stats.*counter );
+                return Level( stats_ );
+            }
+            else
+            {
+                return NoStats();
+            }
+        }
+
+        void count( [[maybe_unused]] size_t ParseStats::* counter )
+        {
+            if constexpr ( collect_stats )
+            {
+                ++( stats_.stats.*counter );
+            }
+        }
+
+        // counts an allocation if a container's capacity has changed
+        void count_growth( size_t old_capacity, size_t new_capacity, size_t element_size, size_t extra = 0 )
+            requires collect_stats
+        {
+            if ( new_capacity != old_capacity )
+            {
+                ++stats_.stats.allocations;
+                stats_.stats.allocated_bytes += new_capacity * element_size + extra;
+            }
+        }
+
+        // Helper class to keep track of the current position in the input string
+        // and the line and column numbers.
+        // This is used to provide better error messages.
+        //
+        class Position
+        {
+          public:
+            Position( const std::string::const_iterator& start )
+                : iter_( start )
+            {
+            }
+
+            // continues the line and column numbers from an earlier part of the input
+            //
+            void continue_from( int line, int column )
+            {
+                line_ = line;
+                column_ = column;
+            }
+
+            void incr()
+            {
+                if ( *iter_ == '\n' )
+                {
+                    ++line_;
+                    column_ = 0;
+                }
+                else
+                {
+                    ++column_;
+                }
+                ++iter_;
+            }
+
+            // moves forward to a later position, counting the lines passed
+            //
+            void skip_to( std::string::const_iterator to )
+            {
+                for ( auto newline = std::find( iter_, to, '\n' ); newline != to; newline = std::find( newline + 1, to, '\n' ) )
+                {
+                    ++line_;
+                    column_ = -1;
+                    iter_ = newline;
+                }
+                column_ += static_cast<int>( to - iter_ );
+                iter_ = to;
+            }
+
+            void incr( size_t num_chars )
+            {
+                for ( int i = 0; i < num_chars; ++i )
+                {
+                    incr();
+                }
+            }
+
+            std::string::const_iterator operator()() const
+            {
+                return iter_;
+            }
+
+            std::string where() const
+            {
+                return " at line " + std::to_string( line_ + 1 ) + " column " + std::to_string( column_ + 1 );
+            }
+
+          private:
+            std::string::const_iterator iter_;
+            int line_ = 0;
+            int column_ = 0;
+        };
+
+        Position posn_;              // Current position in the input string
+        std::string::const_iterator end_; // End of the input string
+
+        ParseOptions options_;
+
+        const size_t max_depth_;
+        const size_t max_string_bytes_;
+        const size_t max_elements_;
+        size_t memory_left_; // of the budget
+        size_t depth_ = 0;   // of the arrays and objects being parsed
+
+        [[no_unique_address]] std::conditional_t<collect_stats, Stats, NoStats> stats_;
+    };
+} // namespace simple_json::detail
@@ -0,0 +1,707 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_patch.h"
+#include <algorithm>
+#include <charconv>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    // A JSON Pointer, e.g. "/a/0/b", split into its unescaped reference tokens.
+    //
+    struct Pointer
+    {
+        string text;
+        vector<string> tokens;
+    };
+
+    expected<Pointer, string> parse_pointer( const string& text )
+    {
+        Pointer pointer{ text, {} };
+
+        if ( text.empty() )
+        {
+            return pointer; // the whole document
+        }
+        if ( text[ 0 ] != '/' )
+        {
+            return std::unexpected( "path \"" + text + "\" does not start with '/'" );
+        }
+
+        string token;
+        for ( size_t i = 1; i <= text.size(); ++i )
+        {
+            if ( i == text.size() || text[ i ] == '/' )
+            {
+                pointer.tokens.push_back( std::move( token ) );
+                token.clear();
+            }
+            else if ( text[ i ] == '~' )
+            {
+                if ( i + 1 == text.size() || ( text[ i + 1 ] != '0' && text[ i + 1 ] != '1' ) )
+                {
+                    return std::unexpected( "invalid escape sequence in path \"" + text + "\"" );
+                }
+                token += ( text[ ++i ] == '0' ? '~' : '/' );
+            }
+            else
+            {
+                token += text[ i ];
+            }
+        }
+
+        return pointer;
+    }
+
+    void append_token( string& path, const string& token )
+    {
+        path += '/';
+        for ( const char c : token )
+        {
+            if ( c == '~' )
+            {
+                path += "~0";
+            }
+            else if ( c == '/' )
+            {
+                path += "~1";
+            }
+            else
+            {
+                path += c;
+            }
+        }
+    }
+
+    // Returns the array index a token refers to. "-" refers to the end of the array
+    // and is only valid if allow_end is true, as is an index equal to the array's size.
+    //
+    expected<size_t, string> array_index( const Pointer& pointer, const string& token, size_t size, bool allow_end )
+    {
+        if ( token == "-" && allow_end )
+        {
+            return size;
+        }
+
+        const bool is_number = !token.empty() && std::all_of( token.begin(), token.end(), []( char c ) { return isdigit( c ); } );
+        if ( !is_number || ( token.size() > 1 && token[ 0 ] == '0' ) )
+        {
+            return std::unexpected( "path \"" + pointer.text + "\" has an invalid array index \"" + token + "\"" );
+        }
+
+        size_t index = 0;
+        const auto [ ptr, ec ] = std::from_chars( token.data(), token.data() + token.size(), index );
+        if ( ec != std::errc() || index > size || ( index == size && !allow_end ) )
+        {
+            return std::unexpected( "path \"" + pointer.text + "\" has an array index out of range" );
+        }
+        return index;
+    }
+
+    // returns a copy of a value with an IntArray unpacked to an Array and an OrderedObject sorted into an Object,
+    // keeping the first of any members with the same name, so that it can be compared with an Array or Object
+    //
+    Value unpack( const Value& value )
+    {
+        if ( const IntArray* ints = get_if<IntArray>( &value ) )
+        {
+            return Array( ints->begin(), ints->end() );
+        }
+        if ( const OrderedObject* ordered = get_if<OrderedObject>( &value ) )
+        {
+            return Object( ordered->begin(), ordered->end() );
+        }
+        return value;
+    }
+
+    bool is_packed( const Value& value )
+    {
+        return holds_alternative<IntArray>( value ) || holds_alternative<OrderedObject>( value );
+    }
+
+    // returns the value as an Array, unpacking an IntArray in place so that its elements can be referred to and changed
+    //
+    Array* get_array( Value* value )
+    {
+        if ( const IntArray* ints = get_if<IntArray>( value ) )
+        {
+            *value = Array( ints->begin(), ints->end() );
+        }
+        return get_if<Array>( value );
+    }
+
+    // returns the value a token refers to in an object or array. An element of an IntArray is copied to element and
+    // that is returned, so that the array is only unpacked to change it.
+    //
+    template <typename V>
+    expected<V*, string> step( V* value, const Pointer& pointer, const string& token, Value& element )
+    {
+        if ( auto* obj = get_if<Object>( value ) )
+        {
+            auto member = obj->find( token );
+            if ( member != obj->end() )
+            {
+                return &member->second;
+            }
+        }
+        else if ( auto* ordered = get_if<OrderedObject>( value ) )
+        {
+            auto member = ordered->find( token );
+            if ( member != ordered->end() )
+            {
+                return &member->second;
+            }
+        }
+        else if ( auto* arr = get_if<Array>( value ) )
+        {
+            return array_index( pointer, token, arr->size(), false ).transform( [ & ]( size_t index ) { return &( *arr )[ index ]; } );
+        }
+        else if ( const IntArray* ints = get_if<IntArray>( value ) )
+        {
+            return array_index( pointer, token, ints->size(), false ).transform( [ & ]( size_t index ) -> V* {
+                element = ( *ints )[ index ];
+                return &element;
+            } );
+        }
+        return std::unexpected( "path \"" + pointer.text + "\" not found" );
+    }
+
+    // returns the value the tokens [begin, end) of a pointer refer to, which may be element, as step() returns
+    //
+    template <typename V>
+    expected<V*, string> find( V& root, const Pointer& pointer, vector<string>::const_iterator end, Value& element )
+    {
+        V* value = &root;
+
+        for ( auto it = pointer.tokens.begin(); it != end; ++it )
+        {
+            auto next = step( value, pointer, *it, element );
+            if ( !next )
+            {
+                return next;
+            }
+            value = *next;
+        }
+
+        return value;
+    }
+
+    // returns the value a pointer refers to, to be read
+    //
+    expected<const Value*, string> look_up( const Value& root, const Pointer& pointer, Value& element )
+    {
+        return find( root, pointer, pointer.tokens.end(), element );
+    }
+
+    // returns the value a pointer refers to, to be replaced, unpacking the IntArray it is in once it is found
+    //
+    expected<Value*, string> find_to_change( Value& root, const Pointer& pointer )
+    {
+        if ( pointer.tokens.empty() )
+        {
+            return &root;
+        }
+
+        Value element;
+        auto parent = find( root, pointer, pointer.tokens.end() - 1, element );
+        if ( !parent )
+        {
+            return parent;
+        }
+        auto target = step( *parent, pointer, pointer.tokens.back(), element );
+        if ( target && *target == &element && get_array( *parent ) )
+        {
+            target = step( *parent, pointer, pointer.tokens.back(), element ); // the element of the unpacked array
+        }
+        return target;
+    }
+
+    // adds a value at a path, leaving the value unchanged if that fails
+    //
+    expected<void, string> add( Value& root, const Pointer& pointer, Value&& value )
+    {
+        if ( pointer.tokens.empty() )
+        {
+            root = std::move( value );
+            return {};
+        }
+
+        Value element; // the parent if it is an element of an IntArray, which is not an object or array
+        auto parent = find( root, pointer, pointer.tokens.end() - 1, element );
+        if ( !parent )
+        {
+            return std::unexpected( parent.error() );
+        }
+
+        if ( Object* obj = get_if<Object>( *parent ) )
+        {
+            obj->insert_or_assign( pointer.tokens.back(), std::move( value ) );
+            return {};
+        }
+        if ( OrderedObject* ordered = get_if<OrderedObject>( *parent ) )
+        {
+            ordered->insert_or_assign( pointer.tokens.back(), std::move( value ) );
+            return {};
+        }
+        if ( Array* arr = get_array( *parent ) )
+        {
+            return array_index( pointer, pointer.tokens.back(), arr->size(), true ).transform( [ & ]( size_t index ) {
+                arr->insert( arr->begin() + index, std::move( value ) );
+            } );
+        }
+        return std::unexpected( "path \"" + pointer.text + "\" not found" );
+    }
+
+    // removes the value at a path and returns it, and its position if it was in an array or ordered object
+    //
+    expected<Value, string> remove( Value& root, const Pointer& pointer, size_t* position = nullptr )
+    {
+        if ( pointer.tokens.empty() )
+        {
+            return std::exchange( root, Null() );
+        }
+
+        Value element; // the parent if it is an element of an IntArray, which is not an object or array
+        auto parent = find( root, pointer, pointer.tokens.end() - 1, element );
+        if ( !parent )
+        {
+            return std::unexpected( parent.error() );
+        }
+
+        if ( Object* obj = get_if<Object>( *parent ) )
+        {
+            auto member = obj->find( pointer.tokens.back() );
+            if ( member == obj->end() )
+            {
+                return std::unexpected( "path \"" + pointer.text + "\" not found" );
+            }
+            Value removed = std::move( member->second );
+            obj->erase( member );
+            return removed;
+        }
+        if ( OrderedObject* ordered = get_if<OrderedObject>( *parent ) )
+        {
+            auto member = ordered->find( pointer.tokens.back() );
+            if ( member == ordered->end() )
+            {
+                return std::unexpected( "path \"" + pointer.text + "\" not found" );
+            }
+            Value removed = std::move( member->second );
+            if ( position )
+            {
+                *position = member - ordered->begin();
+            }
+            ordered->erase( member );
+            return removed;
+        }
+        if ( Array* arr = get_array( *parent ) )
+        {
+            return array_index( pointer, pointer.tokens.back(), arr->size(), false ).transform( [ & ]( size_t index ) {
+                if ( position )
+                {
+                    *position = index;
+                }
+                Value removed = std::move( ( *arr )[ index ] );
+                arr->erase( arr->begin() + index );
+                return removed;
+            } );
+        }
+        return std::unexpected( "path \"" + pointer.text + "\" not found" );
+    }
+
+    // puts back a value that remove() took from a path, where it was, after a failed move
+    //
+    void restore( Value& root, const Pointer& pointer, Value&& value, size_t position )
+    {
+        if ( pointer.tokens.empty() )
+        {
+            root = std::move( value );
+            return;
+        }
+
+        Value element;
+        Value* parent = *find( root, pointer, pointer.tokens.end() - 1, element );
+
+        if ( Object* obj = get_if<Object>( parent ) )
+        {
+            obj->emplace( pointer.tokens.back(), std::move( value ) );
+        }
+        else if ( OrderedObject* ordered = get_if<OrderedObject>( parent ) )
+        {
+            ordered->insert( ordered->begin() + position, pointer.tokens.back(), std::move( value ) );
+        }
+        else
+        {
+            Array& arr = get<Array>( *parent ); // remove() unpacked it if it was an IntArray
+            arr.insert( arr.begin() + position, std::move( value ) );
+        }
+    }
+
+    expected<void, string> apply_operation( Value& root, const Object& operation )
+    {
+        const auto op = get_value<string>( operation, "op" );
+        if ( !op )
+        {
+            return std::unexpected( op.error() );
+        }
+
+        const auto path = get_value<string>( operation, "path" );
+        if ( !path )
+        {
+            return std::unexpected( path.error() );
+        }
+
+        const auto pointer = parse_pointer( path->get() );
+        if ( !pointer )
+        {
+            return std::unexpected( pointer.error() );
+        }
+
+        if ( op->get() == "remove" )
+        {
+            return remove( root, *pointer ).transform( []( const Value& ) {} );
+        }
+
+        if ( op->get() == "add" || op->get() == "replace" || op->get() == "test" )
+        {
+            const auto value = operation.find( "value" );
+            if ( value == operation.end() )
+            {
+                return std::unexpected( "field \"value\" not found" );
+            }
+
+            if ( op->get() == "add" )
+            {
+                return add( root, *pointer, Value( value->second ) );
+            }
+
+            if ( op->get() == "replace" )
+            {
+                return find_to_change( root, *pointer ).transform( [ & ]( Value* target ) { *target = value->second; } );
+            }
+
+            Value element;
+            auto target = look_up( root, *pointer, element );
+            if ( !target )
+            {
+                return std::unexpected( target.error() );
+            }
+            if ( **target != value->second )
+            {
+                return std::unexpected( "test failed for path \"" + pointer->text + "\"" );
+            }
+            return {};
+        }
+
+        if ( op->get() == "move" || op->get() == "copy" )
+        {
+            const auto from = get_value<string>( operation, "from" );
+            if ( !from )
+            {
+                return std::unexpected( from.error() );
+            }
+
+            const auto from_pointer = parse_pointer( from->get() );
+            if ( !from_pointer )
+            {
+                return std::unexpected( from_pointer.error() );
+            }
+
+            if ( op->get() == "copy" )
+            {
+                Value element;
+                auto source = look_up( root, *from_pointer, element );
+                if ( !source )
+                {
+                    return std::unexpected( source.error() );
+                }
+                return add( root, *pointer, Value( **source ) );
+            }
+
+            if ( pointer->tokens.size() > from_pointer->tokens.size() &&
+                 std::equal( from_pointer->tokens.begin(), from_pointer->tokens.end(), pointer->tokens.begin() ) )
+            {
+                return std::unexpected( "cannot move \"" + from_pointer->text + "\" into one of its children" );
+            }
+
+            size_t position = 0;
+            auto removed = remove( root, *from_pointer, &position );
+            if ( !removed )
+            {
+                return std::unexpected( removed.error() );
+            }
+            auto added = add( root, *pointer, std::move( *removed ) );
+            if ( !added )
+            {
+                restore( root, *from_pointer, std::move( *removed ), position );
+            }
+            return added;
+        }
+
+        return std::unexpected( "unknown operation \"" + op->get() + "\"" );
+    }
+
+    Object operation( const char* op, const string& path )
+    {
+        return Object{ { "op", op }, { "path", path } };
+    }
+
+    Object operation( const char* op, const string& path, const Value& value )
+    {
+        return Object{ { "op", op }, { "path", path }, { "value", value } };
+    }
+
+    void diff( const Value& from, const Value& to, string& path, Array& patch );
+
+    void diff_objects( const Object& from, const Object& to, string& path, Array& patch )
+    {
+        const size_t path_size = path.size();
+
+        // both objects' members are sorted by name, so walk them together
+        auto from_it = from.begin();
+        auto to_it = to.begin();
+
+        while ( from_it != from.end() || to_it != to.end() )
+        {
+            if ( to_it == to.end() || ( from_it != from.end() && from_it->first < to_it->first ) )
+            {
+                append_token( path, from_it->first );
+                patch.push_back( operation( "remove", path ) );
+                ++from_it;
+            }
+            else if ( from_it == from.end() || to_it->first < from_it->first )
+            {
+                append_token( path, to_it->first );
+                patch.push_back( operation( "add", path, to_it->second ) );
+                ++to_it;
+            }
+            else
+            {
+                append_token( path, from_it->first );
+                diff( from_it->second, to_it->second, path, patch );
+                ++from_it;
+                ++to_it;
+            }
+            path.resize( path_size );
+        }
+    }
+
+    void diff_arrays( const Array& from, const Array& to, string& path, Array& patch )
+    {
+        const size_t path_size = path.size();
+
+        // skip the elements common to the start and to the end of both arrays
+        size_t prefix = 0;
+        while ( prefix < from.size() && prefix < to.size() && from[ prefix ] == to[ prefix ] )
+        {
+            ++prefix;
+        }
+
+        size_t suffix = 0;
+        while ( suffix < from.size() - prefix && suffix < to.size() - prefix && from[ from.size() - 1 - suffix ] == to[ to.size() - 1 - suffix ] )
+        {
+            ++suffix;
+        }
+
+        const size_t from_count = from.size() - prefix - suffix;
+        const size_t to_count = to.size() - prefix - suffix;
+        const size_t common_count = std::min( from_count, to_count );
+
+        for ( size_t i = 0; i < common_count; ++i )
+        {
+            append_token( path, to_string( prefix + i ) );
+            diff( from[ prefix + i ], to[ prefix + i ], path, patch );
+            path.resize( path_size );
+        }
+
+        // remove the surplus elements one at a time from the same index, or add the missing ones
+        for ( size_t i = common_count; i < from_count; ++i )
+        {
+            append_token( path, to_string( prefix + common_count ) );
+            patch.push_back( operation( "remove", path ) );
+            path.resize( path_size );
+        }
+        for ( size_t i = common_count; i < to_count; ++i )
+        {
+            append_token( path, to_string( prefix + i ) );
+            patch.push_back( operation( "add", path, to[ prefix + i ] ) );
+            path.resize( path_size );
+        }
+    }
+
+    void diff( const Value& from, const Value& to, string& path, Array& patch )
+    {
+        if ( is_packed( from ) || is_packed( to ) )
+        {
+            if ( from != to )
+            {
+                diff( unpack( from ), unpack( to ), path, patch );
+            }
+            return;
+        }
+
+        const Object* from_obj = get_if<Object>( &from );
+        const Object* to_obj = get_if<Object>( &to );
+        if ( from_obj && to_obj )
+        {
+            diff_objects( *from_obj, *to_obj, path, patch );
+            return;
+        }
+
+        const Array* from_arr = get_if<Array>( &from );
+        const Array* to_arr = get_if<Array>( &to );
+        if ( from_arr && to_arr )
+        {
+            diff_arrays( *from_arr, *to_arr, path, patch );
+            return;
+        }
+
+        if ( from != to )
+        {
+            patch.push_back( operation( "replace", path, to ) );
+        }
+    }
+} // namespace
+
+expected<void, string> simple_json::apply_patch( Value& value, const Array& patch )
+{
+    for ( size_t i = 0; i < patch.size(); ++i )
+    {
+        const Object* operation = get_if<Object>( &patch[ i ] );
+
+        Value unpacked; // the operation as an Object, if the patch was parsed with ordered objects
+        if ( holds_alternative<OrderedObject>( patch[ i ] ) )
+        {
+            unpacked = unpack( patch[ i ] );
+            operation = get_if<Object>( &unpacked );
+        }
+
+        if ( !operation )
+        {
+            return std::unexpected( "patch operation " + to_string( i ) + " is not an object" );
+        }
+
+        auto result = apply_operation( value, *operation );
+        if ( !result )
+        {
+            return std::unexpected( "patch operation " + to_string( i ) + ": " + result.error() );
+        }
+    }
+
+    return {};
+}
+
+void simple_json::apply_merge_patch( Value& value, const Value& patch )
+{
+    if ( holds_alternative<OrderedObject>( patch ) )
+    {
+        apply_merge_patch( value, unpack( patch ) );
+        return;
+    }
+
+    const Object* patch_obj = get_if<Object>( &patch );
+    if ( !patch_obj )
+    {
+        value = patch;
+        return;
+    }
+
+    if ( OrderedObject* ordered = get_if<OrderedObject>( &value ) )
+    {
+        // update the members in place, so that they stay in order, with new ones at the end
+        for ( const auto& member : *patch_obj )
+        {
+            auto it = ordered->find( member.first );
+            if ( holds_alternative<Null>( member.second ) )
+            {
+                if ( it != ordered->end() )
+                {
+                    ordered->erase( it );
+                }
+            }
+            else
+            {
+                if ( it == ordered->end() )
+                {
+                    it = ordered->insert_or_assign( member.first, Null() ).first;
+                }
+                apply_merge_patch( it->second, member.second );
+            }
+        }
+        return;
+    }
+
+    if ( !holds_alternative<Object>( value ) )
+    {
+        value = Object();
+    }
+    Object& obj = get<Object>( value );
+
+    for ( const auto& member : *patch_obj )
+    {
+        if ( holds_alternative<Null>( member.second ) )
+        {
+            obj.erase( member.first );
+        }
+        else
+        {
+            apply_merge_patch( obj[ member.first ], member.second );
+        }
+    }
+}
+
+Array simple_json::diff( const Value& from, const Value& to )
+{
+    Array patch;
+    string path;
+    ::diff( from, to, path, patch );
+    return patch;
+}
+
+Value simple_json::merge_diff( const Value& from, const Value& to )
+{
+    if ( holds_alternative<OrderedObject>( from ) || holds_alternative<OrderedObject>( to ) )
+    {
+        return merge_diff( unpack( from ), unpack( to ) );
+    }
+
+    const Object* from_obj = get_if<Object>( &from );
+    const Object* to_obj = get_if<Object>( &to );
+    if ( !from_obj || !to_obj )
+    {
+        return to;
+    }
+
+    Object patch;
+
+    auto from_it = from_obj->begin();
+    auto to_it = to_obj->begin();
+
+    while ( from_it != from_obj->end() || to_it != to_obj->end() )
+    {
+        if ( to_it == to_obj->end() || ( from_it != from_obj->end() && from_it->first < to_it->first ) )
+        {
+            patch.emplace_hint( patch.end(), from_it->first, Null() );
+            ++from_it;
+        }
+        else if ( from_it == from_obj->end() || to_it->first < from_it->first )
+        {
+            patch.emplace_hint( patch.end(), to_it->first, to_it->second );
+            ++to_it;
+        }
+        else
+        {
+            if ( from_it->second != to_it->second )
+            {
+                patch.emplace_hint( patch.end(), to_it->first, merge_diff( from_it->second, to_it->second ) );
+            }
+            ++from_it;
+            ++to_it;
+        }
+    }
+
+    return patch;
+}
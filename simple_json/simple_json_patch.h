@@ -0,0 +1,33 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Applies and generates RFC 6902 JSON Patches and RFC 7386 JSON Merge Patches,
+// so that changes to a document can be sent instead of the whole document.
+
+#pragma once
+#include "simple_json.h"
+
+namespace simple_json
+{
+    // applies a JSON Patch, an array of operation objects, to a value in place
+    // If an operation fails the error is returned and the value is left with the preceding operations applied,
+    // so patch a copy if the value must be left unchanged on failure.
+    //
+    std::expected<void, std::string> apply_patch( Value& value, const Array& patch );
+
+    // applies a JSON Merge Patch to a value in place
+    //
+    void apply_merge_patch( Value& value, const Value& patch );
+
+    // returns a JSON Patch that transforms "from" into "to"
+    // Objects are compared with a single ordered walk over the members of both, and arrays by
+    // trimming their common first and last elements, so unchanged parts produce no operations.
+    //
+    Array diff( const Value& from, const Value& to );
+
+    // returns a JSON Merge Patch that transforms "from" into "to"
+    // (A merge patch cannot set an object member to null, as null means remove the member.)
+    //
+    Value merge_diff( const Value& from, const Value& to );
+
+} // namespace simple_json
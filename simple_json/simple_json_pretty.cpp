@@ -0,0 +1,277 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_pretty.h"
+#include "simple_json_detail.h"
+#include <algorithm>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    template <typename T>
+    constexpr bool is_object = std::is_same_v<T, Object> || std::is_same_v<T, OrderedObject>;
+
+    template <typename T>
+    constexpr bool is_container = is_object<T> || std::is_same_v<T, Array> || std::is_same_v<T, IntArray>;
+
+    bool is_scalar( const Value& value )
+    {
+        return holds_alternative<string>( value ) || holds_alternative<int64_t>( value ) || holds_alternative<bool>( value ) ||
+               holds_alternative<Null>( value ) || holds_alternative<RawNumber>( value );
+    }
+
+    bool is_scalar( int64_t )
+    {
+        return true;
+    }
+
+    string elision( size_t num_elided )
+    {
+        return "... (" + to_string( num_elided ) + " more)";
+    }
+
+    // Writes a value a line at a time. A container is written on one line if that fits within the maximum width,
+    // otherwise an array of scalars is wrapped onto as many lines as it needs, and anything else has one element
+    // or member per line.
+    //
+    class PrettyPrinter
+    {
+      public:
+        explicit PrettyPrinter( const PrettyOptions& options )
+            : options_( options )
+        {
+        }
+
+        string& str()
+        {
+            return str_;
+        }
+
+        void format( const Value& value, size_t level )
+        {
+            std::visit( [ & ]( const auto& v ) { format( v, level ); }, value );
+        }
+
+      private:
+        template <typename Scalar>
+            requires( !is_container<Scalar> )
+        void format( const Scalar& scalar, size_t )
+        {
+            flat( scalar, str_, string::npos );
+        }
+
+        template <typename Container>
+            requires is_container<Container>
+        void format( const Container& container, size_t level )
+        {
+            // on one line if it fits, leaving room for a following comma
+            if ( options_.max_width > column() + 1 )
+            {
+                string line;
+                if ( flat( container, line, options_.max_width - column() - 1 ) )
+                {
+                    str_ += line;
+                    return;
+                }
+            }
+
+            str_ += is_object<Container> ? '{' : '[';
+
+            const size_t num_shown = shown( container.size() );
+            const auto shown_end = std::next( container.begin(), num_shown );
+
+            if constexpr ( !is_object<Container> )
+            {
+                if ( std::all_of( container.begin(), shown_end, []( const auto& element ) { return is_scalar( element ); } ) )
+                {
+                    newline( level + 1 );
+
+                    string element;
+                    for ( auto it = container.begin(); it != shown_end; ++it )
+                    {
+                        element.clear();
+                        flat( *it, element, string::npos );
+                        append_wrapped( element, it == container.begin(), level );
+                    }
+                    if ( num_shown < container.size() )
+                    {
+                        append_wrapped( elision( container.size() - num_shown ), false, level );
+                    }
+
+                    newline( level );
+                    str_ += ']';
+                    return;
+                }
+            }
+
+            for ( auto it = container.begin(); it != shown_end; ++it )
+            {
+                if ( it != container.begin() )
+                {
+                    str_ += ',';
+                }
+                newline( level + 1 );
+
+                if constexpr ( is_object<Container> )
+                {
+                    detail::append_quoted( str_, it->first );
+                    str_ += " : ";
+                    format( it->second, level + 1 );
+                }
+                else
+                {
+                    format( *it, level + 1 );
+                }
+            }
+            if ( num_shown < container.size() )
+            {
+                str_ += ',';
+                newline( level + 1 );
+                str_ += elision( container.size() - num_shown );
+            }
+
+            newline( level );
+            str_ += is_object<Container> ? '}' : ']';
+        }
+
+        // appends an element of a wrapped array, starting a new line if it would not fit on this one
+        //
+        void append_wrapped( const string& element, bool first, size_t level )
+        {
+            if ( !first )
+            {
+                str_ += ',';
+                if ( column() + 1 + element.size() + 1 > options_.max_width )
+                {
+                    newline( level + 1 );
+                }
+                else
+                {
+                    str_ += ' ';
+                }
+            }
+            str_ += element;
+        }
+
+        // The flat() functions append a value without line breaks, and return false as soon as
+        // the output is longer than the limit, so fitting a large container on a line is not tried for long.
+
+        bool flat( const Value& value, string& out, size_t limit ) const
+        {
+            return std::visit( [ & ]( const auto& v ) { return flat( v, out, limit ); }, value );
+        }
+
+        bool flat( const string& s, string& out, size_t limit ) const
+        {
+            const bool truncated = options_.max_string_length != 0 && s.size() > options_.max_string_length;
+            const string_view shown_chars = string_view( s ).substr( 0, truncated ? options_.max_string_length : s.size() );
+
+            if ( out.size() + shown_chars.size() > limit )
+            {
+                return false; // escaping can only make it longer
+            }
+
+            detail::append_quoted( out, shown_chars );
+            if ( truncated )
+            {
+                out.insert( out.size() - 1, "..." );
+            }
+            return out.size() <= limit;
+        }
+
+        bool flat( int64_t i, string& out, size_t limit ) const
+        {
+            out += to_string( i );
+            return out.size() <= limit;
+        }
+
+        bool flat( bool b, string& out, size_t limit ) const
+        {
+            out += b ? "true" : "false";
+            return out.size() <= limit;
+        }
+
+        bool flat( const Null&, string& out, size_t limit ) const
+        {
+            out += "null";
+            return out.size() <= limit;
+        }
+
+        bool flat( const RawNumber& n, string& out, size_t limit ) const
+        {
+            out += n.text();
+            return out.size() <= limit;
+        }
+
+        template <typename Container>
+            requires is_container<Container>
+        bool flat( const Container& container, string& out, size_t limit ) const
+        {
+            out += is_object<Container> ? '{' : '[';
+
+            const size_t num_shown = shown( container.size() );
+            const auto shown_end = std::next( container.begin(), num_shown );
+
+            for ( auto it = container.begin(); it != shown_end; ++it )
+            {
+                if ( it != container.begin() )
+                {
+                    out += ", ";
+                }
+
+                bool fits;
+                if constexpr ( is_object<Container> )
+                {
+                    detail::append_quoted( out, it->first );
+                    out += " : ";
+                    fits = flat( it->second, out, limit );
+                }
+                else
+                {
+                    fits = flat( *it, out, limit );
+                }
+                if ( !fits )
+                {
+                    return false;
+                }
+            }
+            if ( num_shown < container.size() )
+            {
+                out += ", " + elision( container.size() - num_shown );
+            }
+
+            out += is_object<Container> ? '}' : ']';
+            return out.size() <= limit;
+        }
+
+        size_t shown( size_t num_elements ) const
+        {
+            return options_.max_elements == 0 ? num_elements : std::min( num_elements, options_.max_elements );
+        }
+
+        void newline( size_t level )
+        {
+            str_ += '\n';
+            line_start_ = str_.size();
+            detail::append_spaces( str_, level * options_.indent );
+        }
+
+        size_t column() const
+        {
+            return str_.size() - line_start_;
+        }
+
+        const PrettyOptions& options_;
+        string str_;
+        size_t line_start_ = 0;
+    };
+} // namespace
+
+string simple_json::pretty_print( const Value& value, const PrettyOptions& options )
+{
+    PrettyPrinter printer( options );
+    printer.format( value, 0 );
+    return std::move( printer.str() );
+}
@@ -0,0 +1,26 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Formats JSON for people to read, with lines kept within a maximum width where possible, and
+// optionally with long arrays, objects and strings cut short, so that large documents can be inspected.
+
+#pragma once
+#include "simple_json.h"
+
+namespace simple_json
+{
+    struct PrettyOptions
+    {
+        size_t max_width = 100;        // arrays and objects that fit are written on one line, arrays of scalars are wrapped
+        size_t indent = 4;             // spaces per level of nesting
+        size_t max_elements = 0;       // elements or members of a container shown before the rest are elided, 0 for all
+        size_t max_string_length = 0;  // chars of a string shown before the rest are elided, 0 for all
+    };
+
+    // formats a value for reading
+    // Elided elements are shown as "... (N more)" and elided chars as "..." before a string's closing quote,
+    // so the output is only valid JSON if nothing is elided.
+    //
+    std::string pretty_print( const Value& value, const PrettyOptions& options = PrettyOptions() );
+
+} // namespace simple_json
@@ -0,0 +1,480 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_schema.h"
+#include "simple_json_detail.h"
+#include <algorithm>
+#include <limits>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    // the names of the types in the order of the Value alternatives, then "number" for numbers that are not integers
+    const char* const type_names[] = { "string", "boolean", "integer", "null", "array", "object", "number" };
+
+    const unsigned array_bit = 1u << Value( Array() ).index();
+    const unsigned object_bit = 1u << Value( Object() ).index();
+    const unsigned integer_bit = 1u << Value( int64_t() ).index();
+    const unsigned number_bit = 1u << ( std::size( type_names ) - 1 );
+
+    expected<unsigned, string> type_bit( const string& name )
+    {
+        if ( name == "number" )
+        {
+            return number_bit | integer_bit; // integers are numbers too
+        }
+        for ( unsigned i = 0; i < std::size( type_names ); ++i )
+        {
+            if ( name == type_names[ i ] )
+            {
+                return 1u << i;
+            }
+        }
+        return std::unexpected( "unknown type \"" + name + "\"" );
+    }
+
+    // the bit for the type of a value, an IntArray is an array, an OrderedObject an object and a RawNumber an integer,
+    // unless it has a fraction or exponent
+    //
+    unsigned type_bit( const Value& value )
+    {
+        if ( const RawNumber* n = get_if<RawNumber>( &value ) )
+        {
+            return n->text().find_first_of( ".eE" ) == string::npos ? integer_bit : number_bit;
+        }
+        if ( holds_alternative<IntArray>( value ) )
+        {
+            return array_bit;
+        }
+        if ( holds_alternative<OrderedObject>( value ) )
+        {
+            return object_bit;
+        }
+        return 1u << value.index();
+    }
+
+    // compares a raw number with a limit, exactly if it is an integer that fits in an int64_t, else as a double
+    //
+    int compare( const RawNumber& n, int64_t limit )
+    {
+        if ( const auto i = n.to_int64() )
+        {
+            return *i < limit ? -1 : *i > limit;
+        }
+        const double infinity = std::numeric_limits<double>::infinity();
+        const double d = n.to_double().value_or( n.text().front() == '-' ? -infinity : infinity );
+        return d < double( limit ) ? -1 : d > double( limit );
+    }
+
+    string describe_types( unsigned types )
+    {
+        if ( types & number_bit )
+        {
+            types &= ~integer_bit; // covered by "number"
+        }
+
+        string result;
+        for ( unsigned i = 0; i < std::size( type_names ); ++i )
+        {
+            if ( types & ( 1u << i ) )
+            {
+                result += ( result.empty() ? "" : " or " ) + string( type_names[ i ] );
+            }
+        }
+        return result;
+    }
+
+    // returns the value of a keyword of a schema, an Object or OrderedObject, or nullptr if it has none
+    //
+    const Value* find_keyword( const Value& schema, const string& key )
+    {
+        if ( const Object* obj = get_if<Object>( &schema ) )
+        {
+            const auto it = obj->find( key );
+            return it == obj->end() ? nullptr : &it->second;
+        }
+        const OrderedObject& ordered = get<OrderedObject>( schema );
+        const auto it = ordered.find( key );
+        return it == ordered.end() ? nullptr : &it->second;
+    }
+
+    // returns the elements of an Array, or of an IntArray as Values, or nullopt if the value is not an array
+    //
+    optional<vector<Value>> get_elements( const Value& value )
+    {
+        if ( const Array* arr = get_if<Array>( &value ) )
+        {
+            return vector<Value>( arr->begin(), arr->end() );
+        }
+        if ( const IntArray* ints = get_if<IntArray>( &value ) )
+        {
+            return vector<Value>( ints->begin(), ints->end() );
+        }
+        return std::nullopt;
+    }
+
+    template <typename T>
+    expected<optional<T>, string> get_optional_integer( const Value& schema, const string& key, const string& where, int64_t min_value )
+    {
+        const Value* value = find_keyword( schema, key );
+        if ( !value )
+        {
+            return optional<T>();
+        }
+        optional<int64_t> i;
+        if ( const int64_t* value_int = get_if<int64_t>( value ) )
+        {
+            i = *value_int;
+        }
+        else if ( const RawNumber* n = get_if<RawNumber>( value ) )
+        {
+            if ( const auto n_int = n->to_int64() )
+            {
+                i = *n_int;
+            }
+        }
+        if ( !i || *i < min_value )
+        {
+            return std::unexpected( "\"" + key + "\" of schema at \"" + where + "\" is not " + ( min_value < 0 ? "an integer" : "a non-negative integer" ) );
+        }
+        return optional<T>( static_cast<T>( *i ) );
+    }
+} // namespace
+
+// The location of a value being validated, a linked list on the stack so that
+// it costs nothing to keep track of unless an error message needs it.
+//
+struct Schema::Path
+{
+    const Path* parent = nullptr;
+    const string* key = nullptr; // the member name, or nullptr for an array element
+    size_t index = 0;
+
+    string str() const
+    {
+        if ( !parent )
+        {
+            return "";
+        }
+        return parent->str() + "/" + ( key ? *key : to_string( index ) );
+    }
+};
+
+expected<Schema, string> Schema::compile( const Value& schema )
+{
+    Schema result;
+    return result.compile_node( schema, "" ).transform( [ & ]( size_t ) { return std::move( result ); } );
+}
+
+expected<size_t, string> Schema::compile_node( const Value& schema_value, const string& where )
+{
+    if ( !holds_alternative<Object>( schema_value ) && !holds_alternative<OrderedObject>( schema_value ) )
+    {
+        return std::unexpected( "schema at \"" + where + "\" is not an object" );
+    }
+
+    // reserve the node's index before compiling its children, they are added after it
+    const size_t index = nodes_.size();
+    nodes_.emplace_back();
+
+    Node node;
+
+    if ( const Value* type = find_keyword( schema_value, "type" ) )
+    {
+        const vector<Value> names = get_elements( *type ).value_or( vector<Value>{ *type } );
+
+        node.types = 0;
+        for ( const Value& name : names )
+        {
+            const string* name_str = get_if<string>( &name );
+            if ( !name_str )
+            {
+                return std::unexpected( "\"type\" of schema at \"" + where + "\" is not a string or array of strings" );
+            }
+            auto bit = type_bit( *name_str );
+            if ( !bit )
+            {
+                return std::unexpected( bit.error() + " in schema at \"" + where + "\"" );
+            }
+            node.types |= *bit;
+        }
+    }
+
+    if ( const Value* enum_value = find_keyword( schema_value, "enum" ) )
+    {
+        auto values = get_elements( *enum_value );
+        if ( !values )
+        {
+            return std::unexpected( "\"enum\" of schema at \"" + where + "\" is not an array" );
+        }
+        node.enum_values = std::move( *values );
+    }
+
+    const auto minimum = get_optional_integer<int64_t>( schema_value, "minimum", where, std::numeric_limits<int64_t>::min() );
+    const auto maximum = get_optional_integer<int64_t>( schema_value, "maximum", where, std::numeric_limits<int64_t>::min() );
+    const auto min_length = get_optional_integer<size_t>( schema_value, "minLength", where, 0 );
+    const auto max_length = get_optional_integer<size_t>( schema_value, "maxLength", where, 0 );
+    const auto min_items = get_optional_integer<size_t>( schema_value, "minItems", where, 0 );
+    const auto max_items = get_optional_integer<size_t>( schema_value, "maxItems", where, 0 );
+
+    for ( const auto* limit : { &min_length, &max_length, &min_items, &max_items } )
+    {
+        if ( !*limit )
+        {
+            return std::unexpected( limit->error() );
+        }
+    }
+    for ( const auto* limit : { &minimum, &maximum } )
+    {
+        if ( !*limit )
+        {
+            return std::unexpected( limit->error() );
+        }
+    }
+
+    node.minimum = *minimum;
+    node.maximum = *maximum;
+    node.min_length = *min_length;
+    node.max_length = *max_length;
+    node.min_items = *min_items;
+    node.max_items = *max_items;
+
+    if ( const Value* properties = find_keyword( schema_value, "properties" ) )
+    {
+        // compiles the properties in name order, keeping the first of any with the same name as parse() does
+        const auto compile_properties = [ & ]( const auto& members ) -> expected<void, string> {
+            for ( const auto& property : members )
+            {
+                if ( !node.properties.empty() && node.properties.back().first == property.first )
+                {
+                    continue;
+                }
+                auto property_index = compile_node( property.second, where + "/properties/" + property.first );
+                if ( !property_index )
+                {
+                    return std::unexpected( property_index.error() );
+                }
+                node.properties.emplace_back( property.first, *property_index );
+            }
+            return {};
+        };
+
+        expected<void, string> result;
+        if ( const Object* obj = get_if<Object>( properties ) )
+        {
+            result = compile_properties( *obj ); // in name order, as an Object is sorted
+        }
+        else if ( const OrderedObject* ordered = get_if<OrderedObject>( properties ) )
+        {
+            result = compile_properties( detail::sorted_members( *ordered ) );
+        }
+        else
+        {
+            return std::unexpected( "\"properties\" of schema at \"" + where + "\" is not an object" );
+        }
+        if ( !result )
+        {
+            return std::unexpected( result.error() );
+        }
+    }
+
+    if ( const Value* required_value = find_keyword( schema_value, "required" ) )
+    {
+        const auto required = get_elements( *required_value );
+        if ( !required )
+        {
+            return std::unexpected( "\"required\" of schema at \"" + where + "\" is not an array" );
+        }
+
+        for ( const Value& name : *required )
+        {
+            const string* name_str = get_if<string>( &name );
+            if ( !name_str )
+            {
+                return std::unexpected( "\"required\" of schema at \"" + where + "\" contains a value that is not a string" );
+            }
+            node.required.push_back( *name_str );
+        }
+        std::sort( node.required.begin(), node.required.end() );
+        node.required.erase( std::unique( node.required.begin(), node.required.end() ), node.required.end() );
+    }
+
+    if ( const Value* additional_value = find_keyword( schema_value, "additionalProperties" ) )
+    {
+        const bool* additional_properties = get_if<bool>( additional_value );
+        if ( !additional_properties )
+        {
+            return std::unexpected( "\"additionalProperties\" of schema at \"" + where + "\" is not a boolean" );
+        }
+        node.additional_properties = *additional_properties;
+    }
+
+    if ( const Value* items = find_keyword( schema_value, "items" ) )
+    {
+        auto items_index = compile_node( *items, where + "/items" );
+        if ( !items_index )
+        {
+            return items_index;
+        }
+        node.items = *items_index;
+    }
+
+    nodes_[ index ] = std::move( node );
+    return index;
+}
+
+template <typename Container>
+expected<void, string> Schema::validate_items( const Node& node, const Container& arr, const Path& path ) const
+{
+    if ( node.min_items && arr.size() < *node.min_items )
+    {
+        return std::unexpected( "array at \"" + path.str() + "\" has fewer than " + to_string( *node.min_items ) + " items" );
+    }
+    if ( node.max_items && arr.size() > *node.max_items )
+    {
+        return std::unexpected( "array at \"" + path.str() + "\" has more than " + to_string( *node.max_items ) + " items" );
+    }
+    if ( node.items )
+    {
+        const Node& items = nodes_[ *node.items ];
+        for ( size_t i = 0; i < arr.size(); ++i )
+        {
+            expected<void, string> result;
+            if constexpr ( std::is_same_v<Container, IntArray> )
+            {
+                result = validate( items, Value( arr[ i ] ), Path{ &path, nullptr, i } );
+            }
+            else
+            {
+                result = validate( items, arr[ i ], Path{ &path, nullptr, i } );
+            }
+            if ( !result )
+            {
+                return result;
+            }
+        }
+    }
+    return {};
+}
+
+// validates the members of an object in name order
+//
+template <typename Members>
+expected<void, string> Schema::validate_members( const Node& node, const Members& members, const Path& path ) const
+{
+    // the required names, the property names and the object's members are all sorted, so walk them together
+    auto required = node.required.begin();
+    auto property = node.properties.begin();
+
+    for ( const auto& member : members )
+    {
+        for ( ; required != node.required.end() && *required <= member.first; ++required )
+        {
+            if ( *required != member.first )
+            {
+                return std::unexpected( "object at \"" + path.str() + "\" is missing required field \"" + *required + "\"" );
+            }
+        }
+
+        while ( property != node.properties.end() && property->first < member.first )
+        {
+            ++property;
+        }
+
+        if ( property != node.properties.end() && property->first == member.first )
+        {
+            auto result = validate( nodes_[ property->second ], member.second, Path{ &path, &member.first } );
+            if ( !result )
+            {
+                return result;
+            }
+        }
+        else if ( !node.additional_properties )
+        {
+            return std::unexpected( "object at \"" + path.str() + "\" has unexpected field \"" + member.first + "\"" );
+        }
+    }
+
+    if ( required != node.required.end() )
+    {
+        return std::unexpected( "object at \"" + path.str() + "\" is missing required field \"" + *required + "\"" );
+    }
+
+    return {};
+}
+
+expected<void, string> Schema::validate( const Value& value ) const
+{
+    if ( nodes_.empty() )
+    {
+        return {};
+    }
+    return validate( nodes_.front(), value, Path() );
+}
+
+expected<void, string> Schema::validate( const Node& node, const Value& value, const Path& path ) const
+{
+    if ( !( node.types & type_bit( value ) ) )
+    {
+        return std::unexpected( "value at \"" + path.str() + "\" is not of type " + describe_types( node.types ) );
+    }
+
+    if ( !node.enum_values.empty() && std::find( node.enum_values.begin(), node.enum_values.end(), value ) == node.enum_values.end() )
+    {
+        return std::unexpected( "value at \"" + path.str() + "\" is not one of the enumerated values" );
+    }
+
+    if ( const int64_t* i = get_if<int64_t>( &value ) )
+    {
+        if ( node.minimum && *i < *node.minimum )
+        {
+            return std::unexpected( "value at \"" + path.str() + "\" is less than the minimum " + to_string( *node.minimum ) );
+        }
+        if ( node.maximum && *i > *node.maximum )
+        {
+            return std::unexpected( "value at \"" + path.str() + "\" is greater than the maximum " + to_string( *node.maximum ) );
+        }
+    }
+    else if ( const RawNumber* n = get_if<RawNumber>( &value ) )
+    {
+        if ( node.minimum && compare( *n, *node.minimum ) < 0 )
+        {
+            return std::unexpected( "value at \"" + path.str() + "\" is less than the minimum " + to_string( *node.minimum ) );
+        }
+        if ( node.maximum && compare( *n, *node.maximum ) > 0 )
+        {
+            return std::unexpected( "value at \"" + path.str() + "\" is greater than the maximum " + to_string( *node.maximum ) );
+        }
+    }
+    else if ( const string* s = get_if<string>( &value ) )
+    {
+        if ( node.min_length && s->size() < *node.min_length )
+        {
+            return std::unexpected( "string at \"" + path.str() + "\" is shorter than " + to_string( *node.min_length ) );
+        }
+        if ( node.max_length && s->size() > *node.max_length )
+        {
+            return std::unexpected( "string at \"" + path.str() + "\" is longer than " + to_string( *node.max_length ) );
+        }
+    }
+    else if ( const Array* arr = get_if<Array>( &value ) )
+    {
+        return validate_items( node, *arr, path );
+    }
+    else if ( const IntArray* ints = get_if<IntArray>( &value ) )
+    {
+        return validate_items( node, *ints, path );
+    }
+    else if ( const Object* obj = get_if<Object>( &value ) )
+    {
+        return validate_members( node, *obj, path );
+    }
+    else if ( const OrderedObject* ordered = get_if<OrderedObject>( &value ) )
+    {
+        return validate_members( node, detail::sorted_members( *ordered ), path );
+    }
+
+    return {};
+}
@@ -0,0 +1,64 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Validates values against a subset of JSON Schema, compiled once into a Schema object.
+// Supported keywords: "type", "enum", "minimum", "maximum", "minLength", "maxLength",
+// "properties", "required", "additionalProperties" (a boolean), "items", "minItems" and "maxItems".
+// The "integer" type is int64_t and RawNumbers written without a fraction or exponent, and the "number" type
+// also includes the other RawNumbers. RawNumbers are compared with "minimum" and "maximum" as doubles unless they
+// are integers that fit in an int64_t.
+// Other keywords are ignored.
+
+#pragma once
+#include "simple_json.h"
+#include <optional>
+
+namespace simple_json
+{
+    class Schema
+    {
+      public:
+        // compiles a JSON Schema, or returns an error message if it is not valid
+        //
+        static std::expected<Schema, std::string> compile( const Value& schema );
+
+        // checks a value against the schema, returning an error message for the first violation found
+        // A default constructed or moved from Schema accepts every value, as the empty schema {} does.
+        //
+        std::expected<void, std::string> validate( const Value& value ) const;
+
+      private:
+        struct Path;
+
+        // A compiled schema or sub-schema. Other nodes are referred to by their index in nodes_.
+        //
+        struct Node
+        {
+            unsigned types = ~0u; // bit n is set if Value alternative n is allowed
+            std::vector<Value> enum_values;
+            std::optional<int64_t> minimum;
+            std::optional<int64_t> maximum;
+            std::optional<size_t> min_length;
+            std::optional<size_t> max_length;
+            std::vector<std::pair<std::string, size_t>> properties; // sorted by name, like Object's members
+            std::vector<std::string> required;                      // sorted
+            bool additional_properties = true;
+            std::optional<size_t> items;
+            std::optional<size_t> min_items;
+            std::optional<size_t> max_items;
+        };
+
+        std::expected<size_t, std::string> compile_node( const Value& schema, const std::string& where );
+
+        std::expected<void, std::string> validate( const Node& node, const Value& value, const Path& path ) const;
+
+        template <typename Container>
+        std::expected<void, std::string> validate_items( const Node& node, const Container& arr, const Path& path ) const;
+
+        template <typename Members>
+        std::expected<void, std::string> validate_members( const Node& node, const Members& members, const Path& path ) const;
+
+        std::vector<Node> nodes_;
+    };
+
+} // namespace simple_json
@@ -0,0 +1,291 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_shared.h"
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    const shared_ptr<const SharedValue::Variant>& null_node()
+    {
+        static const shared_ptr<const SharedValue::Variant> node = make_shared<const SharedValue::Variant>( Null() );
+        return node;
+    }
+
+    string describe( const SharedValue::PathElement& element )
+    {
+        if ( const string* key = get_if<string>( &element ) )
+        {
+            return "field \"" + *key + "\"";
+        }
+        return "index " + to_string( get<size_t>( element ) );
+    }
+} // namespace
+
+SharedValue::SharedValue()
+    : node_( null_node() )
+{
+}
+
+SharedValue::SharedValue( Variant variant )
+    : node_( make_shared<const Variant>( std::move( variant ) ) )
+{
+}
+
+const SharedValue* SharedValue::find( const Path& path ) const
+{
+    const SharedValue* value = this;
+
+    for ( const PathElement& element : path )
+    {
+        if ( const string* key = std::get_if<string>( &element ) )
+        {
+            const SharedObject* obj = value->get_if<SharedObject>();
+            if ( !obj )
+            {
+                return nullptr;
+            }
+            auto it = obj->find( *key );
+            if ( it == obj->end() )
+            {
+                return nullptr;
+            }
+            value = &it->second;
+        }
+        else
+        {
+            const SharedArray* arr = value->get_if<SharedArray>();
+            const size_t index = std::get<size_t>( element );
+            if ( !arr || index >= arr->size() )
+            {
+                return nullptr;
+            }
+            value = &( *arr )[ index ];
+        }
+    }
+
+    return value;
+}
+
+expected<SharedValue, string> SharedValue::set( const Path& path, SharedValue value ) const
+{
+    if ( path.empty() )
+    {
+        return value;
+    }
+    return update( path.begin(), path.end(), &value );
+}
+
+expected<SharedValue, string> SharedValue::erase( const Path& path ) const
+{
+    if ( path.empty() )
+    {
+        return std::unexpected( "cannot erase the root value" );
+    }
+    return update( path.begin(), path.end(), nullptr );
+}
+
+// Returns a copy of this value with the value at the end of the path [it, end) set to *value,
+// or erased if value is null. Only the containers along the path are copied, and as they hold
+// SharedValues copying them only copies pointers to their members.
+//
+expected<SharedValue, string> SharedValue::update( Path::const_iterator it, Path::const_iterator end, const SharedValue* value ) const
+{
+    const bool last = ( it + 1 == end );
+
+    if ( const string* key = std::get_if<string>( &*it ) )
+    {
+        const SharedObject* obj = get_if<SharedObject>();
+        if ( !obj )
+        {
+            return std::unexpected( "cannot get " + describe( *it ) + " of a value that is not an object" );
+        }
+
+        SharedObject new_obj = *obj;
+        auto member = new_obj.find( *key );
+
+        if ( last )
+        {
+            if ( value )
+            {
+                new_obj.insert_or_assign( *key, *value );
+            }
+            else if ( member != new_obj.end() )
+            {
+                new_obj.erase( member );
+            }
+            else
+            {
+                return std::unexpected( describe( *it ) + " not found" );
+            }
+        }
+        else
+        {
+            if ( member == new_obj.end() )
+            {
+                return std::unexpected( describe( *it ) + " not found" );
+            }
+            auto new_member = member->second.update( it + 1, end, value );
+            if ( !new_member )
+            {
+                return new_member;
+            }
+            member->second = std::move( *new_member );
+        }
+
+        return SharedValue( std::move( new_obj ) );
+    }
+
+    const SharedArray* arr = get_if<SharedArray>();
+    if ( !arr )
+    {
+        return std::unexpected( "cannot get " + describe( *it ) + " of a value that is not an array" );
+    }
+
+    const size_t index = std::get<size_t>( *it );
+    const bool appending = last && value && index == arr->size();
+    if ( index >= arr->size() && !appending )
+    {
+        return std::unexpected( describe( *it ) + " is out of range" );
+    }
+
+    SharedArray new_arr = *arr;
+
+    if ( appending )
+    {
+        new_arr.push_back( *value );
+    }
+    else if ( last )
+    {
+        if ( value )
+        {
+            new_arr[ index ] = *value;
+        }
+        else
+        {
+            new_arr.erase( new_arr.begin() + index );
+        }
+    }
+    else
+    {
+        auto new_element = new_arr[ index ].update( it + 1, end, value );
+        if ( !new_element )
+        {
+            return new_element;
+        }
+        new_arr[ index ] = std::move( *new_element );
+    }
+
+    return SharedValue( std::move( new_arr ) );
+}
+
+SharedValue simple_json::to_shared( const Value& value )
+{
+    struct Visitor
+    {
+        SharedValue operator()( const string& s )
+        {
+            return SharedValue( s );
+        }
+        SharedValue operator()( const Object& obj )
+        {
+            SharedObject shared_obj;
+            for ( const auto& member : obj )
+            {
+                shared_obj.emplace_hint( shared_obj.end(), member.first, to_shared( member.second ) );
+            }
+            return SharedValue( std::move( shared_obj ) );
+        }
+        SharedValue operator()( const OrderedObject& obj )
+        {
+            SharedObject shared_obj;
+            for ( const auto& member : obj )
+            {
+                shared_obj.emplace( member.first, to_shared( member.second ) ); // sorted, keeping the first of any duplicates
+            }
+            return SharedValue( std::move( shared_obj ) );
+        }
+        SharedValue operator()( const Array& arr )
+        {
+            SharedArray shared_arr;
+            shared_arr.reserve( arr.size() );
+            for ( const Value& element : arr )
+            {
+                shared_arr.push_back( to_shared( element ) );
+            }
+            return SharedValue( std::move( shared_arr ) );
+        }
+        SharedValue operator()( const IntArray& arr )
+        {
+            return SharedValue( SharedArray( arr.begin(), arr.end() ) );
+        }
+        SharedValue operator()( int64_t i )
+        {
+            return SharedValue( i );
+        }
+        SharedValue operator()( bool b )
+        {
+            return SharedValue( b );
+        }
+        SharedValue operator()( const Null& )
+        {
+            return SharedValue();
+        }
+        SharedValue operator()( const RawNumber& n )
+        {
+            return SharedValue( n );
+        }
+    };
+
+    return std::visit( Visitor{}, value );
+}
+
+Value simple_json::to_value( const SharedValue& value )
+{
+    struct Visitor
+    {
+        Value operator()( const string& s )
+        {
+            return s;
+        }
+        Value operator()( const SharedObject& shared_obj )
+        {
+            Object obj;
+            for ( const auto& member : shared_obj )
+            {
+                obj.emplace_hint( obj.end(), member.first, to_value( member.second ) );
+            }
+            return obj;
+        }
+        Value operator()( const SharedArray& shared_arr )
+        {
+            Array arr;
+            arr.reserve( shared_arr.size() );
+            for ( const SharedValue& element : shared_arr )
+            {
+                arr.push_back( to_value( element ) );
+            }
+            return arr;
+        }
+        Value operator()( int64_t i )
+        {
+            return i;
+        }
+        Value operator()( bool b )
+        {
+            return b;
+        }
+        Value operator()( const Null& )
+        {
+            return Null();
+        }
+        Value operator()( const RawNumber& n )
+        {
+            return n;
+        }
+    };
+
+    return std::visit( Visitor{}, value.get() );
+}
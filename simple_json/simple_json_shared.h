@@ -0,0 +1,121 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// An immutable JSON document whose copies share structure.
+// Copying a SharedValue is O(1), and a modified version only clones the containers
+// along the modified path, the rest of the tree is shared with the original.
+// As nothing is modified after construction, any number of threads may read the same
+// document, or different versions of it, without locks.
+
+#pragma once
+#include "simple_json.h"
+#include <memory>
+#include <string_view>
+
+namespace simple_json
+{
+    struct SharedArray;
+    struct SharedObject;
+
+    class SharedValue
+    {
+      public:
+        using Variant = std::variant<std::string, bool, int64_t, Null, SharedArray, SharedObject, RawNumber>;
+
+        // an element of a path, either the name of an object member or the index of an array element
+        using PathElement = std::variant<std::string, size_t>;
+        using Path = std::vector<PathElement>;
+
+        SharedValue(); // a null value, does not allocate
+        SharedValue( Variant variant );
+
+        const Variant& get() const noexcept;
+
+        size_t index() const noexcept;
+
+        template <typename T>
+        const T* get_if() const noexcept;
+
+        // returns the value at the end of path, or nullptr if there is none
+        const SharedValue* find( const Path& path ) const;
+
+        // returns a new version of this value with the value at the end of path replaced, or added
+        // if the last element of path is a new object member name or is one past the end of an array
+        std::expected<SharedValue, std::string> set( const Path& path, SharedValue value ) const;
+
+        // returns a new version of this value with the value at the end of path removed
+        std::expected<SharedValue, std::string> erase( const Path& path ) const;
+
+        // true if both values refer to the same node, i.e. one is a copy of the other or shares it as a subtree
+        bool shares_node_with( const SharedValue& other ) const noexcept
+        {
+            return node_.get() == other.node_.get();
+        }
+
+      private:
+        std::expected<SharedValue, std::string> update( Path::const_iterator it, Path::const_iterator end, const SharedValue* value ) const;
+
+        std::shared_ptr<const Variant> node_;
+    };
+
+    // A shared JSON array is a vector of shared values, copying it copies pointers to its elements.
+    //
+    struct SharedArray : public std::vector<SharedValue>
+    {
+        using std::vector<SharedValue>::vector; // inherit all constructors
+    };
+
+    // A shared JSON object is a map of string/shared value pairs, copying it copies pointers to its members.
+    //
+    struct SharedObject : public std::map<std::string, SharedValue, std::less<>>
+    {
+        using std::map<std::string, SharedValue, std::less<>>::map; // inherit all constructors
+    };
+
+    inline const SharedValue::Variant& SharedValue::get() const noexcept
+    {
+        return *node_;
+    }
+
+    inline size_t SharedValue::index() const noexcept
+    {
+        return node_->index();
+    }
+
+    template <typename T>
+    const T* SharedValue::get_if() const noexcept
+    {
+        return std::get_if<T>( node_.get() );
+    }
+
+    template <typename T>
+    const T* get_if( const SharedValue* value ) noexcept
+    {
+        return value ? value->get_if<T>() : nullptr;
+    }
+
+    // converts a Value to the equivalent shared value
+    //
+    SharedValue to_shared( const Value& value );
+
+    // converts a shared value to the equivalent Value, e.g. for formatting
+    //
+    Value to_value( const SharedValue& value );
+
+    // helper to get a value from a shared JSON object
+    template <typename T>
+    std::expected<std::reference_wrapper<const T>, std::string> get_value( const simple_json::SharedObject& obj, std::string_view key )
+    {
+        auto it = obj.find( key );
+        if ( it == obj.end() )
+        {
+            return std::unexpected( "field \"" + std::string( key ) + "\" not found" );
+        }
+        if ( auto ptr = it->second.get_if<T>() )
+        {
+            return std::cref( *ptr );
+        }
+        return std::unexpected( "field \"" + std::string( key ) + "\" is not the expected type" );
+    }
+
+} // namespace simple_json
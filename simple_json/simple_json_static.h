@@ -0,0 +1,406 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Parses JSON string literals at compile time into read-only documents, e.g.
+//
+//     constexpr auto defaults = parse_static<R"({"port":8080,"hosts":["a","b"]})">();
+//
+//     const auto port = get_value<int64_t>( defaults.object(), "port" );
+//
+// A malformed literal is a compile time error, reported as a call to malformed_json_literal(), whose arguments
+// give the reason and the offset of the error. The document holds its values in flat arrays, with strings as
+// std::string_views into the document, so it needs no parsing or allocation at run time.
+
+#pragma once
+#include "simple_json.h"
+#include "simple_json_view.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace simple_json
+{
+    // a string literal as a template argument
+    //
+    template <size_t N>
+    struct Literal
+    {
+        constexpr Literal( const char ( &str )[ N ] )
+        {
+            std::copy_n( str, N, chars );
+        }
+
+        constexpr std::string_view view() const
+        {
+            return { chars, N - 1 };
+        }
+
+        char chars[ N ];
+    };
+
+    namespace detail
+    {
+        // A value in a static document. The nodes are in document order, so the elements of an array, or the
+        // name and value nodes of each member of an object, follow the array or object's node.
+        //
+        struct StaticNode
+        {
+            using Type = ViewType;
+
+            Type type = Type::null;
+            bool boolean = false;
+            int64_t integer = 0;
+            size_t offset = 0; // of a string's chars
+            size_t size = 0;   // of a string, or the number of elements or members of an array or object
+            size_t next = 0;   // the index of the node after this one and its elements or members
+        };
+
+        // the layout of a static document's nodes, for the views in simple_json_view.h
+        //
+        struct StaticLayout
+        {
+            using Word = StaticNode;
+
+            static constexpr ViewType type( const StaticNode* nodes, size_t i )
+            {
+                return nodes[ i ].type;
+            }
+
+            static constexpr std::string_view string( const StaticNode* nodes, const char* chars, size_t i )
+            {
+                return std::string_view( chars + nodes[ i ].offset, nodes[ i ].size );
+            }
+
+            static constexpr int64_t integer( const StaticNode* nodes, size_t i )
+            {
+                return nodes[ i ].integer;
+            }
+
+            static constexpr bool boolean( const StaticNode* nodes, size_t i )
+            {
+                return nodes[ i ].boolean;
+            }
+
+            static constexpr size_t size( const StaticNode* nodes, size_t i )
+            {
+                return nodes[ i ].size;
+            }
+
+            static constexpr size_t first( size_t i )
+            {
+                return i + 1;
+            }
+
+            static constexpr size_t end( const StaticNode* nodes, size_t i )
+            {
+                return nodes[ i ].next;
+            }
+
+            static constexpr size_t next( const StaticNode* nodes, size_t i )
+            {
+                return nodes[ i ].next;
+            }
+
+            static constexpr size_t member_value( size_t i )
+            {
+                return i + 1;
+            }
+        };
+    } // namespace detail
+
+    // A value, array or object in a static document, see simple_json_view.h.
+    //
+    using StaticValue = ValueView<detail::StaticLayout>;
+    using StaticArray = ArrayView<detail::StaticLayout>;
+    using StaticObject = ObjectView<detail::StaticLayout>;
+
+    // A document parsed by parse_static().
+    //
+    template <size_t num_nodes, size_t num_chars>
+    struct StaticDocument
+    {
+        std::array<detail::StaticNode, num_nodes> nodes;
+        std::array<char, num_chars> chars;
+
+        constexpr StaticValue root() const
+        {
+            return StaticValue( nodes.data(), chars.data(), 0 );
+        }
+
+        // returns the root as an object, which must be one
+        //
+        constexpr StaticObject object() const
+        {
+            return *root().template get_if<StaticObject>();
+        }
+    };
+
+    namespace detail
+    {
+        // not constexpr, so calling it during constant evaluation is the compile time error for a malformed literal
+        //
+        inline void malformed_json_literal( const char* /* reason */, size_t /* offset */ )
+        {
+        }
+
+        // Parses JSON during constant evaluation into vectors of nodes and chars. It accepts the same
+        // JSON as parse(), except that the separators between elements and members are required.
+        //
+        class StaticParser
+        {
+          public:
+            constexpr explicit StaticParser( std::string_view json )
+                : json_( json )
+            {
+            }
+
+            constexpr bool parse()
+            {
+                if ( !parse_value() )
+                {
+                    return false;
+                }
+                skip_whitespace();
+                return posn_ == json_.size() || fail( "unprocessed data" );
+            }
+
+            std::vector<StaticNode> nodes;
+            std::string chars;
+            const char* error = nullptr;
+
+            constexpr size_t position() const
+            {
+                return posn_;
+            }
+
+          private:
+            constexpr bool fail( const char* reason )
+            {
+                error = reason;
+                return false;
+            }
+
+            constexpr bool at_end() const
+            {
+                return posn_ == json_.size();
+            }
+
+            constexpr void skip_whitespace()
+            {
+                while ( !at_end() && ( json_[ posn_ ] == ' ' || json_[ posn_ ] == '\t' || json_[ posn_ ] == '\n' || json_[ posn_ ] == '\r' ) )
+                {
+                    ++posn_;
+                }
+            }
+
+            constexpr bool parse_value()
+            {
+                skip_whitespace();
+
+                if ( at_end() )
+                {
+                    return fail( "end of string reached while looking for value" );
+                }
+
+                const char c = json_[ posn_ ];
+                if ( c == '{' || c == '[' )
+                {
+                    return parse_container( c == '{' );
+                }
+                if ( c == '"' )
+                {
+                    return parse_string();
+                }
+                if ( c == 't' || c == 'f' || c == 'n' )
+                {
+                    return parse_word();
+                }
+                if ( c == '-' || ( c >= '0' && c <= '9' ) )
+                {
+                    return parse_integer();
+                }
+                return fail( "unexpected character" );
+            }
+
+            constexpr bool parse_container( bool is_object )
+            {
+                const size_t index = nodes.size();
+                nodes.push_back( { is_object ? StaticNode::Type::object : StaticNode::Type::array } );
+
+                const char close = is_object ? '}' : ']';
+                ++posn_; // skip the opening bracket
+
+                skip_whitespace();
+                while ( at_end() || json_[ posn_ ] != close )
+                {
+                    if ( nodes[ index ].size > 0 )
+                    {
+                        if ( at_end() || json_[ posn_ ] != ',' )
+                        {
+                            return fail( is_object ? "missing closing '}'" : "missing closing ']'" );
+                        }
+                        ++posn_;
+                        skip_whitespace();
+                    }
+
+                    if ( is_object )
+                    {
+                        if ( at_end() || json_[ posn_ ] != '"' )
+                        {
+                            return fail( "missing member name" );
+                        }
+                        if ( !parse_string() )
+                        {
+                            return false;
+                        }
+                        skip_whitespace();
+                        if ( at_end() || json_[ posn_ ] != ':' )
+                        {
+                            return fail( "missing ':'" );
+                        }
+                        ++posn_;
+                    }
+
+                    if ( !parse_value() )
+                    {
+                        return false;
+                    }
+                    ++nodes[ index ].size;
+                    skip_whitespace();
+                }
+
+                ++posn_; // skip the closing bracket
+                nodes[ index ].next = nodes.size();
+                return true;
+            }
+
+            constexpr bool parse_string()
+            {
+                StaticNode node{ StaticNode::Type::string };
+                node.offset = chars.size();
+
+                constexpr std::string_view escaped = "bfnrt\"\\/";
+                constexpr std::string_view unescaped = "\b\f\n\r\t\"\\/";
+
+                for ( ++posn_; !at_end() && json_[ posn_ ] != '"'; ++posn_ )
+                {
+                    if ( json_[ posn_ ] == '\\' )
+                    {
+                        ++posn_;
+                        const size_t i = at_end() ? std::string_view::npos : escaped.find( json_[ posn_ ] );
+                        if ( i == std::string_view::npos )
+                        {
+                            return fail( "invalid escape character" );
+                        }
+                        chars.push_back( unescaped[ i ] );
+                    }
+                    else
+                    {
+                        chars.push_back( json_[ posn_ ] );
+                    }
+                }
+
+                if ( at_end() )
+                {
+                    return fail( "missing closing '\"'" );
+                }
+                ++posn_; // skip the closing quote
+
+                node.size = chars.size() - node.offset;
+                node.next = nodes.size() + 1;
+                nodes.push_back( node );
+                return true;
+            }
+
+            constexpr bool parse_word()
+            {
+                StaticNode node;
+                node.next = nodes.size() + 1;
+
+                for ( const std::string_view word : { "true", "false", "null" } )
+                {
+                    if ( json_.substr( posn_, word.size() ) == word )
+                    {
+                        node.type = word == "null" ? StaticNode::Type::null : StaticNode::Type::boolean;
+                        node.boolean = word == "true";
+                        posn_ += word.size();
+                        nodes.push_back( node );
+                        return true;
+                    }
+                }
+                return fail( "expected \"true\", \"false\" or \"null\"" );
+            }
+
+            constexpr bool parse_integer()
+            {
+                const bool negative = json_[ posn_ ] == '-';
+                if ( negative )
+                {
+                    ++posn_;
+                }
+
+                if ( at_end() || json_[ posn_ ] < '0' || json_[ posn_ ] > '9' )
+                {
+                    return fail( "could not convert to an integer" );
+                }
+
+                // accumulate negatively, so that the minimum int64_t does not overflow
+                int64_t value = 0;
+                for ( ; !at_end() && json_[ posn_ ] >= '0' && json_[ posn_ ] <= '9'; ++posn_ )
+                {
+                    const int digit = json_[ posn_ ] - '0';
+                    if ( value < ( std::numeric_limits<int64_t>::min() + digit ) / 10 )
+                    {
+                        return fail( "could not convert to an integer" );
+                    }
+                    value = value * 10 - digit;
+                }
+
+                if ( !negative )
+                {
+                    if ( value == std::numeric_limits<int64_t>::min() )
+                    {
+                        return fail( "could not convert to an integer" );
+                    }
+                    value = -value;
+                }
+
+                StaticNode node{ StaticNode::Type::integer };
+                node.integer = value;
+                node.next = nodes.size() + 1;
+                nodes.push_back( node );
+                return true;
+            }
+
+            std::string_view json_;
+            size_t posn_ = 0;
+        };
+    } // namespace detail
+
+    // parses a JSON string literal at compile time
+    //
+    template <Literal json>
+    consteval auto parse_static()
+    {
+        constexpr auto sizes = [] {
+            detail::StaticParser parser( json.view() );
+            if ( !parser.parse() )
+            {
+                detail::malformed_json_literal( parser.error, parser.position() );
+            }
+            return std::pair{ parser.nodes.size(), parser.chars.size() };
+        }();
+
+        detail::StaticParser parser( json.view() );
+        parser.parse();
+
+        StaticDocument<sizes.first, sizes.second> document{};
+        std::copy( parser.nodes.begin(), parser.nodes.end(), document.nodes.begin() );
+        std::copy( parser.chars.begin(), parser.chars.end(), document.chars.begin() );
+        return document;
+    }
+
+} // namespace simple_json
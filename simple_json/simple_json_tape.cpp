@@ -0,0 +1,432 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_tape.h"
+#include "simple_json_parser.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace simple_json;
+using namespace std;
+
+// A thread's recycled document buffers. The thread takes and gives back buffers without locking, other threads
+// give back buffers to a second list under a mutex, which the thread collects once it has used up its own.
+//
+class detail::TapePool
+{
+  public:
+    struct Buffers
+    {
+        vector<uint64_t> tape;
+        string chars;
+    };
+
+    TapePool()
+    {
+        local_.reserve( max_buffers );
+        remote_.reserve( max_buffers );
+    }
+
+    // takes buffers for a new document, empty but keeping their capacity, on the pool's thread
+    //
+    Buffers take()
+    {
+        if ( local_.empty() )
+        {
+            lock_guard lock( mutex_ );
+            local_.swap( remote_ );
+        }
+
+        if ( local_.empty() )
+        {
+            return Buffers();
+        }
+
+        Buffers buffers = std::move( local_.back() );
+        local_.pop_back();
+        bytes_.fetch_sub( bytes( buffers.tape, buffers.chars ), memory_order_relaxed );
+        return buffers;
+    }
+
+    // gives back a document's buffers, on any thread, keeping them if there is room
+    //
+    void give( vector<uint64_t>&& tape, string&& chars )
+    {
+        tape.clear();
+        chars.clear();
+
+        if ( this_thread::get_id() == owner_ )
+        {
+            if ( local_.size() < max_buffers && reserve( bytes( tape, chars ) ) )
+            {
+                local_.push_back( { std::move( tape ), std::move( chars ) } );
+            }
+            return;
+        }
+
+        lock_guard lock( mutex_ );
+        if ( remote_.size() < max_buffers && reserve( bytes( tape, chars ) ) )
+        {
+            remote_.push_back( { std::move( tape ), std::move( chars ) } );
+        }
+    }
+
+  private:
+    static constexpr size_t max_buffers = 4;              // enough for a few documents alive at once
+    static constexpr size_t max_bytes = 16 * 1024 * 1024; // of all the buffers held, any more are freed
+
+    static size_t bytes( const vector<uint64_t>& tape, const string& chars )
+    {
+        return tape.capacity() * sizeof( uint64_t ) + chars.capacity();
+    }
+
+    // counts buffers of the size as held, unless that would take the pool over max_bytes
+    //
+    bool reserve( size_t size )
+    {
+        size_t held = bytes_.load( memory_order_relaxed );
+        do
+        {
+            if ( size > max_bytes - held )
+            {
+                return false;
+            }
+        } while ( !bytes_.compare_exchange_weak( held, held + size, memory_order_relaxed ) );
+        return true;
+    }
+
+    const thread::id owner_ = this_thread::get_id();
+    atomic<size_t> bytes_ = 0; // of the buffers in both lists
+    vector<Buffers> local_;
+    mutex mutex_;
+    vector<Buffers> remote_;
+};
+
+namespace
+{
+    using detail::tape::word;
+
+    // Parses with the same grammar as parse(), but appends each value to the tape and each string's chars to the
+    // string buffer rather than building a Value.
+    //
+    class TapeParser : public detail::Parser<false>
+    {
+      public:
+        TapeParser( const string& json_str, const ParseOptions& options, vector<uint64_t>& tape, string& chars )
+            : Parser( json_str, options ),
+              tape_( tape ),
+              chars_( chars ),
+              max_memory_( options.max_memory == 0 ? SIZE_MAX : options.max_memory )
+        {
+            memory_left_ = SIZE_MAX; // the budget applies to the tape and string buffer instead, see check_budget() and limit_string()
+
+            if ( options.max_memory == 0 )
+            {
+                tape_.reserve( json_str.size() / 8 + 4 ); // a little less than typical JSON needs, saving most regrowth
+                chars_.reserve( json_str.size() / 4 );
+            }
+        }
+
+        Result parse_document()
+        {
+            Result result = parse_tape_value();
+            if ( result )
+            {
+                skip_whitespace();
+                if ( posn_() != end_ )
+                {
+                    result = std::unexpected( "unprocessed data" + where() );
+                }
+            }
+            return result;
+        }
+
+      private:
+        Result parse_tape_value()
+        {
+            skip_whitespace();
+
+            if ( posn_() == end_ )
+            {
+                return std::unexpected( "end of string reached while looking for value" + where() );
+            }
+            if ( *posn_() == '{' || *posn_() == '[' )
+            {
+                return parse_tape_container();
+            }
+            if ( *posn_() == '"' )
+            {
+                return parse_tape_string();
+            }
+            if ( *posn_() == 't' )
+            {
+                return parse_true().and_then( [ & ]( bool ) { return add_word( word( 't' ) ); } );
+            }
+            if ( *posn_() == 'f' )
+            {
+                return parse_false().and_then( [ & ]( bool ) { return add_word( word( 'f' ) ); } );
+            }
+            if ( *posn_() == 'n' )
+            {
+                return parse_null().and_then( [ & ]( Null ) { return add_word( word( 'n' ) ); } );
+            }
+            if ( at_integer() )
+            {
+                return parse_integer().and_then( [ & ]( int64_t i ) {
+                    tape_.push_back( word( 'l' ) );
+                    return add_word( uint64_t( i ) );
+                } );
+            }
+            return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+        }
+
+        Result parse_tape_string()
+        {
+            string_.clear();
+            limit_string();
+
+            Result result = parse_string( string_ );
+            if ( result )
+            {
+                add_string();
+                result = check_budget();
+            }
+            return result;
+        }
+
+        // appends a scalar's last word, checking the budget as the tape grows
+        //
+        Result add_word( uint64_t w )
+        {
+            tape_.push_back( w );
+            return check_budget();
+        }
+
+        // appends the string just parsed
+        //
+        void add_string()
+        {
+            tape_.push_back( word( '"', chars_.size() ) );
+            tape_.push_back( string_.size() );
+            chars_.append( string_ );
+        }
+
+        // parses an array or object, leaving the word for its number of elements or members after its start
+        //
+        Result parse_tape_container()
+        {
+            if ( depth_ == max_depth_ )
+            {
+                return std::unexpected( "nesting deeper than the maximum depth of " + to_string( max_depth_ ) + where() );
+            }
+
+            ++depth_;
+
+            const bool is_object = *posn_() == '{';
+            const size_t start = tape_.size();
+            tape_.push_back( 0 );
+            tape_.push_back( 0 );
+
+            posn_.incr(); // skip the opening bracket
+
+            const expected<size_t, string> size = is_object ? parse_tape_members() : parse_tape_elements();
+            if ( !size )
+            {
+                return std::unexpected( size.error() );
+            }
+
+            tape_[ start ] = word( is_object ? '{' : '[', tape_.size() + 1 );
+            tape_[ start + 1 ] = *size;
+            tape_.push_back( word( is_object ? '}' : ']', start ) );
+
+            --depth_;
+            return check_budget();
+        }
+
+        expected<size_t, string> parse_tape_elements()
+        {
+            skip_whitespace();
+
+            if ( posn_() == end_ )
+            {
+                return std::unexpected( "missing closing ']'" + where() );
+            }
+
+            if ( *posn_() == ']' )
+            {
+                posn_.incr();
+                return 0;
+            }
+
+            for ( size_t size = 0;; )
+            {
+                if ( size++ == max_elements_ )
+                {
+                    return too_many_elements();
+                }
+
+                Result result = parse_tape_value();
+                if ( !result )
+                {
+                    return std::unexpected( std::move( result.error() ) );
+                }
+
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "missing closing ']'" + where() );
+                }
+
+                if ( *posn_() == ']' )
+                {
+                    posn_.incr();
+                    return size; // end of array
+                }
+
+                if ( *posn_() != ',' )
+                {
+                    return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+                }
+
+                posn_.incr(); // skip ','
+            }
+        }
+
+        expected<size_t, string> parse_tape_members()
+        {
+            size_t size = 0;
+
+            while ( true )
+            {
+                skip_whitespace();
+
+                if ( posn_() == end_ )
+                {
+                    return std::unexpected( "missing closing '}'" + where() );
+                }
+
+                if ( *posn_() == '}' )
+                {
+                    posn_.incr();
+                    return size; // end of object
+                }
+
+                if ( *posn_() == '"' )
+                {
+                    if ( size++ == max_elements_ )
+                    {
+                        return std::unexpected( "object with more than the maximum of " + to_string( max_elements_ ) + " members" + where() );
+                    }
+
+                    string_.clear();
+                    limit_string();
+
+                    Result result = parse_name( string_ );
+                    if ( result )
+                    {
+                        add_string();
+                        result = check_budget();
+                    }
+                    if ( result )
+                    {
+                        result = parse_tape_value();
+                    }
+                    if ( !result )
+                    {
+                        return std::unexpected( std::move( result.error() ) );
+                    }
+                }
+                else if ( *posn_() == ',' )
+                {
+                    posn_.incr(); // skip ','
+                }
+                else
+                {
+                    return std::unexpected( string( "unexpected character '" ) + *posn_() + "'" + where() );
+                }
+            }
+        }
+
+        // leaves the string about to be parsed what is left of the budget, so a long one fails as soon as it passes it
+        //
+        void limit_string()
+        {
+            const size_t used = tape_.capacity() * sizeof( uint64_t ) + chars_.capacity();
+            memory_left_ = used > max_memory_ ? 0 : max_memory_ - used;
+        }
+
+        Result check_budget() const
+        {
+            if ( tape_.capacity() * sizeof( uint64_t ) + chars_.capacity() > max_memory_ )
+            {
+                return over_budget();
+            }
+            return {};
+        }
+
+        vector<uint64_t>& tape_;
+        string& chars_;
+        string string_; // the string being parsed, reused for each one
+        const size_t max_memory_;
+    };
+
+    thread_local bool recycle_buffers = true;
+
+    // returns this thread's pool, which documents share so that it lasts until the last one is destroyed, or null
+    // if this thread does not recycle buffers
+    //
+    shared_ptr<detail::TapePool> thread_pool()
+    {
+        thread_local const shared_ptr<detail::TapePool> pool = make_shared<detail::TapePool>();
+        return recycle_buffers ? pool : nullptr;
+    }
+} // namespace
+
+void simple_json::set_recycle_tape_buffers( bool recycle )
+{
+    recycle_buffers = recycle;
+}
+
+TapeDocument& TapeDocument::operator=( TapeDocument&& other ) noexcept
+{
+    if ( this != &other )
+    {
+        if ( pool_ )
+        {
+            pool_->give( std::move( tape_ ), std::move( chars_ ) );
+        }
+        tape_ = std::move( other.tape_ );
+        chars_ = std::move( other.chars_ );
+        pool_ = std::move( other.pool_ );
+    }
+    return *this;
+}
+
+TapeDocument::~TapeDocument()
+{
+    if ( pool_ )
+    {
+        pool_->give( std::move( tape_ ), std::move( chars_ ) );
+    }
+}
+
+expected<TapeDocument, string> simple_json::parse_tape( const string& json_str, const ParseOptions& options )
+{
+    shared_ptr<detail::TapePool> pool = thread_pool();
+
+    // recycled buffers may have more capacity than a document needs, which would count against a memory budget
+    detail::TapePool::Buffers buffers = pool && options.max_memory == 0 ? pool->take() : detail::TapePool::Buffers();
+
+    if ( expected<void, string> result = TapeParser( json_str, options, buffers.tape, buffers.chars ).parse_document(); !result )
+    {
+        if ( pool )
+        {
+            pool->give( std::move( buffers.tape ), std::move( buffers.chars ) );
+        }
+        return std::unexpected( std::move( result.error() ) );
+    }
+
+    return TapeDocument( std::move( buffers.tape ), std::move( buffers.chars ), std::move( pool ) );
+}
@@ -0,0 +1,201 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Parses JSON into a read-only document held in two flat buffers rather than a tree, e.g.
+//
+//     const auto document = parse_tape( json );
+//
+//     const auto id = get_value<int64_t>( *document->root().get_if<TapeObject>(), "id" );
+//
+// The document is a tape of 64-bit words, one or two for each value in document order, and one buffer of the
+// chars of all the strings. Walking it reads memory in order rather than following pointers between the nodes of
+// a Value tree, and destroying it frees two allocations rather than one for each string, array and member.
+//
+// Each thread keeps a pool of up to 16 MB of the buffers of destroyed documents for its next parses, so a thread
+// parsing one document after another allocates nothing once its buffers are large enough, and threads parsing at
+// the same time do not contend in the global allocator. A document may be destroyed on any thread, its buffers go
+// back to the pool of the thread that parsed it.
+
+#pragma once
+#include "simple_json.h"
+#include "simple_json_view.h"
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace simple_json
+{
+    namespace detail
+    {
+        class TapePool;
+    }
+
+    namespace detail::tape
+    {
+        // Each word has a tag in its top byte and a payload in the rest:
+        //
+        //     'n', 't', 'f'  null, true and false
+        //     'l'            an integer, in the next word
+        //     '"'            a string, the payload is the offset of its chars and the next word their number
+        //     '[' or '{'     the start of an array or object, the payload is the index of the word after its end and
+        //                    the next word the number of elements or members, which follow as values or name and value pairs
+        //     ']' or '}'     the end of an array or object, the payload is the index of its start
+        //
+        inline constexpr int tag_shift = 56;
+
+        inline constexpr uint64_t word( char tag, uint64_t payload = 0 )
+        {
+            return uint64_t( uint8_t( tag ) ) << tag_shift | payload;
+        }
+
+        inline constexpr char tag( uint64_t word )
+        {
+            return char( word >> tag_shift );
+        }
+
+        inline constexpr size_t payload( uint64_t word )
+        {
+            return size_t( word & ( ( uint64_t( 1 ) << tag_shift ) - 1 ) );
+        }
+
+        // the layout of a tape, for the views in simple_json_view.h
+        //
+        struct Layout
+        {
+            using Word = uint64_t;
+
+            static constexpr ViewType type( const uint64_t* tape, size_t i )
+            {
+                switch ( tag( tape[ i ] ) )
+                {
+                case '"':
+                    return ViewType::string;
+                case 't':
+                case 'f':
+                    return ViewType::boolean;
+                case 'l':
+                    return ViewType::integer;
+                case '[':
+                    return ViewType::array;
+                case '{':
+                    return ViewType::object;
+                default:
+                    return ViewType::null;
+                }
+            }
+
+            static constexpr std::string_view string( const uint64_t* tape, const char* chars, size_t i )
+            {
+                return std::string_view( chars + payload( tape[ i ] ), size_t( tape[ i + 1 ] ) );
+            }
+
+            static constexpr int64_t integer( const uint64_t* tape, size_t i )
+            {
+                return int64_t( tape[ i + 1 ] );
+            }
+
+            static constexpr bool boolean( const uint64_t* tape, size_t i )
+            {
+                return tag( tape[ i ] ) == 't';
+            }
+
+            static constexpr size_t size( const uint64_t* tape, size_t i )
+            {
+                return size_t( tape[ i + 1 ] );
+            }
+
+            static constexpr size_t first( size_t i )
+            {
+                return i + 2;
+            }
+
+            static constexpr size_t end( const uint64_t* tape, size_t i )
+            {
+                return payload( tape[ i ] ) - 1; // the closing ']' or '}'
+            }
+
+            static constexpr size_t next( const uint64_t* tape, size_t i )
+            {
+                switch ( tag( tape[ i ] ) )
+                {
+                case '[':
+                case '{':
+                    return payload( tape[ i ] );
+                case 'l':
+                case '"':
+                    return i + 2;
+                default:
+                    return i + 1;
+                }
+            }
+
+            static constexpr size_t member_value( size_t i )
+            {
+                return i + 2; // after the name's two words
+            }
+        };
+    } // namespace detail::tape
+
+    // A value, array or object in a tape document, see simple_json_view.h.
+    //
+    using TapeValue = ValueView<detail::tape::Layout>;
+    using TapeArray = ArrayView<detail::tape::Layout>;
+    using TapeObject = ObjectView<detail::tape::Layout>;
+
+    // A document parsed by parse_tape().
+    //
+    class TapeDocument
+    {
+      public:
+        TapeDocument( TapeDocument&& other ) noexcept = default;
+        TapeDocument& operator=( TapeDocument&& other ) noexcept;
+        ~TapeDocument();
+
+        TapeValue root() const
+        {
+            return TapeValue( tape_.data(), chars_.data(), 0 );
+        }
+
+        // the number of words in the tape
+        //
+        size_t tape_size() const
+        {
+            return tape_.size();
+        }
+
+        // the number of chars of all the strings, including member names
+        //
+        size_t chars_size() const
+        {
+            return chars_.size();
+        }
+
+      private:
+        TapeDocument( std::vector<uint64_t>&& tape, std::string&& chars, std::shared_ptr<detail::TapePool> pool )
+            : tape_( std::move( tape ) ),
+              chars_( std::move( chars ) ),
+              pool_( std::move( pool ) )
+        {
+        }
+
+        friend std::expected<TapeDocument, std::string> parse_tape( const std::string& json_str, const ParseOptions& options );
+
+        std::vector<uint64_t> tape_;
+        std::string chars_;
+        std::shared_ptr<detail::TapePool> pool_; // that the buffers go back to, null once moved from
+    };
+
+    // parses a JSON string into a tape document
+    // It accepts the same JSON as parse(), with the same errors, and applies the limits of the options, the memory
+    // budget to the sizes of the tape and the string buffer. Objects keep their members in document order, including
+    // any duplicates, and numbers are integers whatever the options.
+    //
+    std::expected<TapeDocument, std::string> parse_tape( const std::string& json_str, const ParseOptions& options = ParseOptions() );
+
+    // turns recycling the buffers of the documents this thread parses through its pool on or off, e.g. off for a
+    // thread that only parses the odd large document. It is on by default.
+    //
+    void set_recycle_tape_buffers( bool recycle );
+
+} // namespace simple_json
@@ -0,0 +1,344 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Read-only views of the values of documents held in flat arrays rather than trees, shared by the static and
+// tape documents. A document's values are in document order, each followed by its elements, or by the name and
+// value of each of its members, and its strings' chars are in a separate buffer. A Layout says how the values are
+// encoded, with these static members, each taking the array of values and the index of a value:
+//
+//     type( values, i )             the ViewType of the value
+//     string( values, chars, i )    its chars, and integer( values, i ) and boolean( values, i ) its other scalars
+//     size( values, i )             the number of elements or members of an array or object
+//     first( i ) and end( values, i )  the index of the first element or member's name, and of the end of them
+//     next( values, i )             the index of the value after it and its elements or members
+//     member_value( i )             the index of a member's value, given the index of its name
+
+#pragma once
+#include "simple_json.h"
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace simple_json
+{
+    namespace detail
+    {
+        enum class ViewType : uint8_t
+        {
+            string,
+            boolean,
+            integer,
+            null,
+            array,
+            object
+        };
+    } // namespace detail
+
+    template <typename Layout>
+    class ArrayView;
+
+    template <typename Layout>
+    class ObjectView;
+
+    // A value in a document, which must outlive it. get_if<T>() returns the value if it is a T, where T is
+    // std::string_view, int64_t, bool, Null, ArrayView or ObjectView.
+    //
+    template <typename Layout>
+    class ValueView
+    {
+      public:
+        using Word = typename Layout::Word;
+
+        constexpr ValueView( const Word* values, const char* chars, size_t index )
+            : values_( values ),
+              chars_( chars ),
+              index_( index )
+        {
+        }
+
+        template <typename T>
+        constexpr std::optional<T> get_if() const
+        {
+            using Type = detail::ViewType;
+            const Type type = Layout::type( values_, index_ );
+
+            if constexpr ( std::is_same_v<T, std::string_view> )
+            {
+                return type == Type::string ? std::optional<T>( Layout::string( values_, chars_, index_ ) ) : std::nullopt;
+            }
+            else if constexpr ( std::is_same_v<T, int64_t> )
+            {
+                return type == Type::integer ? std::optional<T>( Layout::integer( values_, index_ ) ) : std::nullopt;
+            }
+            else if constexpr ( std::is_same_v<T, bool> )
+            {
+                return type == Type::boolean ? std::optional<T>( Layout::boolean( values_, index_ ) ) : std::nullopt;
+            }
+            else if constexpr ( std::is_same_v<T, Null> )
+            {
+                return type == Type::null ? std::optional<T>( Null() ) : std::nullopt;
+            }
+            else if constexpr ( std::is_same_v<T, ArrayView<Layout>> )
+            {
+                return type == Type::array ? std::optional<T>( T( values_, chars_, index_ ) ) : std::nullopt;
+            }
+            else
+            {
+                static_assert( std::is_same_v<T, ObjectView<Layout>>, "not a ValueView type" );
+                return type == Type::object ? std::optional<T>( T( values_, chars_, index_ ) ) : std::nullopt;
+            }
+        }
+
+      private:
+        const Word* values_;
+        const char* chars_;
+        size_t index_;
+    };
+
+    template <typename Layout>
+    class ArrayView
+    {
+      public:
+        using Word = typename Layout::Word;
+
+        class Iterator
+        {
+          public:
+            using value_type = ValueView<Layout>;
+            using difference_type = std::ptrdiff_t;
+
+            constexpr Iterator() = default;
+
+            constexpr Iterator( const Word* values, const char* chars, size_t index )
+                : values_( values ),
+                  chars_( chars ),
+                  index_( index )
+            {
+            }
+
+            constexpr value_type operator*() const
+            {
+                return value_type( values_, chars_, index_ );
+            }
+
+            constexpr Iterator& operator++()
+            {
+                index_ = Layout::next( values_, index_ );
+                return *this;
+            }
+
+            constexpr Iterator operator++( int )
+            {
+                Iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            constexpr bool operator==( const Iterator& other ) const
+            {
+                return index_ == other.index_;
+            }
+
+          private:
+            const Word* values_ = nullptr;
+            const char* chars_ = nullptr;
+            size_t index_ = 0;
+        };
+
+        constexpr ArrayView( const Word* values, const char* chars, size_t index )
+            : values_( values ),
+              chars_( chars ),
+              index_( index )
+        {
+        }
+
+        constexpr size_t size() const
+        {
+            return Layout::size( values_, index_ );
+        }
+
+        constexpr bool empty() const
+        {
+            return size() == 0;
+        }
+
+        constexpr Iterator begin() const
+        {
+            return Iterator( values_, chars_, Layout::first( index_ ) );
+        }
+
+        constexpr Iterator end() const
+        {
+            return Iterator( values_, chars_, Layout::end( values_, index_ ) );
+        }
+
+        // returns an element, stepping over the ones before it
+        //
+        constexpr ValueView<Layout> operator[]( size_t i ) const
+        {
+            return *std::next( begin(), i );
+        }
+
+      private:
+        const Word* values_;
+        const char* chars_;
+        size_t index_;
+    };
+
+    template <typename Layout>
+    class ObjectView
+    {
+      public:
+        using Word = typename Layout::Word;
+        using value_type = std::pair<std::string_view, ValueView<Layout>>;
+
+        class Iterator
+        {
+          public:
+            using value_type = ObjectView::value_type;
+            using difference_type = std::ptrdiff_t;
+
+            constexpr Iterator() = default;
+
+            constexpr Iterator( const Word* values, const char* chars, size_t index )
+                : values_( values ),
+                  chars_( chars ),
+                  index_( index )
+            {
+            }
+
+            constexpr value_type operator*() const
+            {
+                return { Layout::string( values_, chars_, index_ ), ValueView<Layout>( values_, chars_, Layout::member_value( index_ ) ) };
+            }
+
+            constexpr Iterator& operator++()
+            {
+                index_ = Layout::next( values_, Layout::member_value( index_ ) ); // skip the name and the value
+                return *this;
+            }
+
+            constexpr Iterator operator++( int )
+            {
+                Iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            constexpr bool operator==( const Iterator& other ) const
+            {
+                return index_ == other.index_;
+            }
+
+          private:
+            const Word* values_ = nullptr;
+            const char* chars_ = nullptr;
+            size_t index_ = 0;
+        };
+
+        constexpr ObjectView( const Word* values, const char* chars, size_t index )
+            : values_( values ),
+              chars_( chars ),
+              index_( index )
+        {
+        }
+
+        constexpr size_t size() const
+        {
+            return Layout::size( values_, index_ );
+        }
+
+        constexpr bool empty() const
+        {
+            return size() == 0;
+        }
+
+        constexpr Iterator begin() const
+        {
+            return Iterator( values_, chars_, Layout::first( index_ ) );
+        }
+
+        constexpr Iterator end() const
+        {
+            return Iterator( values_, chars_, Layout::end( values_, index_ ) );
+        }
+
+        // returns the value of the first member with the name, searching the members in order
+        //
+        constexpr std::optional<ValueView<Layout>> find( std::string_view name ) const
+        {
+            for ( const auto& [ member_name, value ] : *this )
+            {
+                if ( member_name == name )
+                {
+                    return value;
+                }
+            }
+            return std::nullopt;
+        }
+
+      private:
+        const Word* values_;
+        const char* chars_;
+        size_t index_;
+    };
+
+    // helper to get a value from an object view, as get_value() does from an Object
+    // T is one of the types ValueView::get_if() accepts, and the value is returned rather than a reference.
+    //
+    template <typename T, typename Layout>
+    constexpr std::expected<T, std::string> get_value( const ObjectView<Layout>& obj, std::string_view key )
+    {
+        const auto value = obj.find( key );
+        if ( !value )
+        {
+            return std::unexpected( "field \"" + std::string( key ) + "\" not found" );
+        }
+        if ( const auto t = value->template get_if<T>() )
+        {
+            return *t;
+        }
+        return std::unexpected( "field \"" + std::string( key ) + "\" is not the expected type" );
+    }
+
+    // converts a value view to a Value, keeping the first of any members with the same name, as parse() does
+    //
+    template <typename Layout>
+    Value to_value( const ValueView<Layout>& value )
+    {
+        if ( const auto s = value.template get_if<std::string_view>() )
+        {
+            return std::string( *s );
+        }
+        if ( const auto i = value.template get_if<int64_t>() )
+        {
+            return *i;
+        }
+        if ( const auto b = value.template get_if<bool>() )
+        {
+            return *b;
+        }
+        if ( const auto arr = value.template get_if<ArrayView<Layout>>() )
+        {
+            Array result;
+            result.reserve( arr->size() );
+            for ( const ValueView<Layout> element : *arr )
+            {
+                result.push_back( to_value( element ) );
+            }
+            return result;
+        }
+        if ( const auto obj = value.template get_if<ObjectView<Layout>>() )
+        {
+            Object result;
+            for ( const auto& [ name, member_value ] : *obj )
+            {
+                result.emplace( name, to_value( member_value ) );
+            }
+            return result;
+        }
+        return Null();
+    }
+
+} // namespace simple_json
@@ -0,0 +1,218 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Writes JSON a piece at a time straight into a buffer, without first building a Value.
+
+#pragma once
+#include "simple_json.h"
+#include "simple_json_detail.h"
+#include <cassert>
+#include <charconv>
+#include <concepts>
+#include <vector>
+
+namespace simple_json
+{
+    // Writes JSON in compact form, without whitespace, as calls are made, e.g.
+    //
+    //     std::string json;
+    //     Writer writer( json );
+    //     writer.begin_object().key( "id" ).value( 42 ).key( "tags" ).begin_array().value( "a" ).end_array().end_object();
+    //
+    // gives {"id":42,"tags":["a"]}. Strings are escaped as operator<< escapes them. The Sink, e.g. std::string,
+    // needs push_back( char ) and append( const char*, size_t ). Debug builds assert that the calls make a single
+    // well-formed value, e.g. that each member has a key and that arrays and objects are ended in order.
+    //
+    template <typename Sink = std::string>
+    class Writer
+    {
+      public:
+        explicit Writer( Sink& sink )
+            : sink_( sink )
+        {
+        }
+
+        Writer& begin_object()
+        {
+            before_value();
+            sink_.push_back( '{' );
+            levels_.push_back( { true, false } );
+            return *this;
+        }
+
+        Writer& end_object()
+        {
+            assert( !levels_.empty() && levels_.back().is_object && "end_object() without begin_object()" );
+            assert( !after_key_ && "end_object() after a key without a value" );
+            sink_.push_back( '}' );
+            levels_.pop_back();
+            return *this;
+        }
+
+        Writer& begin_array()
+        {
+            before_value();
+            sink_.push_back( '[' );
+            levels_.push_back( { false, false } );
+            return *this;
+        }
+
+        Writer& end_array()
+        {
+            assert( !levels_.empty() && !levels_.back().is_object && "end_array() without begin_array()" );
+            sink_.push_back( ']' );
+            levels_.pop_back();
+            return *this;
+        }
+
+        // writes the name of the next member of an object, to be followed by its value
+        //
+        Writer& key( std::string_view name )
+        {
+            assert( !levels_.empty() && levels_.back().is_object && "key() outside an object" );
+            assert( !after_key_ && "key() after a key without a value" );
+            if ( levels_.back().has_elements )
+            {
+                sink_.push_back( ',' );
+            }
+            levels_.back().has_elements = true;
+            detail::append_quoted( sink_, name );
+            sink_.push_back( ':' );
+            after_key_ = true;
+            return *this;
+        }
+
+        Writer& value( std::string_view s )
+        {
+            before_value();
+            detail::append_quoted( sink_, s );
+            return *this;
+        }
+
+        Writer& value( const char* s )
+        {
+            return value( std::string_view( s ) );
+        }
+
+        Writer& value( const std::string& s )
+        {
+            return value( std::string_view( s ) );
+        }
+
+        template <std::integral T>
+            requires( !std::is_same_v<T, bool> && !std::is_same_v<T, char> )
+        Writer& value( T i )
+        {
+            before_value();
+            char buffer[ 24 ];
+            const auto [ end, ec ] = std::to_chars( buffer, buffer + sizeof( buffer ), i );
+            sink_.append( buffer, end - buffer );
+            return *this;
+        }
+
+        Writer& value( bool b )
+        {
+            before_value();
+            b ? sink_.append( "true", 4 ) : sink_.append( "false", 5 );
+            return *this;
+        }
+
+        Writer& value( Null )
+        {
+            before_value();
+            sink_.append( "null", 4 );
+            return *this;
+        }
+
+        // writes the number's text unchanged
+        //
+        Writer& value( const RawNumber& n )
+        {
+            before_value();
+            sink_.append( n.text().data(), n.text().size() );
+            return *this;
+        }
+
+        // writes a whole Value, with the members of an OrderedObject in order
+        //
+        Writer& value( const Value& v )
+        {
+            std::visit( [ this ]( const auto& alternative ) { write( alternative ); }, v );
+            return *this;
+        }
+
+        // returns true once a complete value has been written
+        //
+        bool complete() const
+        {
+            return written_ && levels_.empty();
+        }
+
+      private:
+        template <typename Scalar>
+        void write( const Scalar& scalar )
+        {
+            value( scalar );
+        }
+
+        template <typename Obj>
+            requires std::is_same_v<Obj, Object> || std::is_same_v<Obj, OrderedObject>
+        void write( const Obj& obj )
+        {
+            begin_object();
+            for ( const auto& member : obj )
+            {
+                key( member.first ).value( member.second );
+            }
+            end_object();
+        }
+
+        template <typename Container>
+            requires std::is_same_v<Container, Array> || std::is_same_v<Container, IntArray>
+        void write( const Container& arr )
+        {
+            begin_array();
+            for ( const auto& element : arr )
+            {
+                value( element );
+            }
+            end_array();
+        }
+
+        // writes the separator before a value, if any
+        //
+        void before_value()
+        {
+            if ( levels_.empty() )
+            {
+                assert( !written_ && "more than one value at the top level" );
+                written_ = true;
+            }
+            else if ( levels_.back().is_object )
+            {
+                assert( after_key_ && "a value in an object without a key()" );
+                after_key_ = false;
+            }
+            else
+            {
+                if ( levels_.back().has_elements )
+                {
+                    sink_.push_back( ',' );
+                }
+                levels_.back().has_elements = true;
+            }
+        }
+
+        struct Level
+        {
+            bool is_object;
+            bool has_elements;
+        };
+
+        Sink& sink_;
+        std::vector<Level> levels_; // the open arrays and objects
+        bool after_key_ = false;
+        bool written_ = false;
+    };
+
+} // namespace simple_json
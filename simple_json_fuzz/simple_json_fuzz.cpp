@@ -0,0 +1,103 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// A fuzz target for libFuzzer or AFL. Each input is parsed, and if it is valid JSON, formatted and parsed again
+// to check the round trip. The process is aborted if the parse makes more allocations than the size of the input
+// can justify, so that inputs causing super-linear memory use are reported like crashes.
+
+#include "allocation_counter.h"
+#include "simple_json.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    // Each byte of input can start at most one value, which needs at most one allocation for its container
+    // or string, plus an error message copied out of each level of nesting.
+    const size_t max_allocations_per_byte = 2;
+    const size_t max_allocated_bytes_per_byte = 256;
+    const size_t allocation_allowance = 16; // allocations not related to the input size
+
+    void fail( const string& message, const string& json_str )
+    {
+        cerr << message << "\ninput: " << json_str.substr( 0, 1000 ) << endl;
+        abort();
+    }
+
+    void check_round_trip( const Value& value, const string& json_str )
+    {
+        ostringstream os;
+        os << value;
+        const auto reparsed = parse( os.str() );
+        if ( !reparsed || *reparsed != value )
+        {
+            fail( "formatted value does not parse to the same value: " + os.str(), json_str );
+        }
+
+        const auto canonical = parse( to_canonical_string( value ) );
+        if ( !canonical || *canonical != value || hash_value( *canonical ) != hash_value( value ) )
+        {
+            fail( "canonical value does not parse to the same value: " + to_canonical_string( value ), json_str );
+        }
+    }
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput( const uint8_t* data, size_t size )
+{
+    const string json_str( reinterpret_cast<const char*>( data ), size );
+
+    const AllocationCounts start = AllocationCounts::now();
+    const auto value = parse( json_str );
+    const AllocationCounts used = AllocationCounts::now() - start;
+
+    if ( used.allocations > max_allocations_per_byte * size + allocation_allowance ||
+         used.bytes > max_allocated_bytes_per_byte * ( size + allocation_allowance ) )
+    {
+        fail( "parse made " + to_string( used.allocations ) + " allocations of " + to_string( used.bytes ) + " bytes for " + to_string( size ) +
+                  " bytes of input",
+              json_str );
+    }
+
+    if ( value )
+    {
+        check_round_trip( *value, json_str );
+    }
+
+    return 0;
+}
+
+#ifdef SIMPLE_JSON_FUZZ_MAIN
+int main( int argc, char* argv[] )
+{
+    auto run = []( istream& is )
+    {
+        const string input{ istreambuf_iterator<char>( is ), istreambuf_iterator<char>() };
+        LLVMFuzzerTestOneInput( reinterpret_cast<const uint8_t*>( input.data() ), input.size() );
+    };
+
+    if ( argc < 2 )
+    {
+        run( cin );
+    }
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        ifstream is( argv[ i ], ios::binary );
+        if ( !is )
+        {
+            cerr << "cannot open " << argv[ i ] << endl;
+            return 1;
+        }
+        run( is );
+    }
+
+    return 0;
+}
+#endif
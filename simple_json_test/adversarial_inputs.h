@@ -0,0 +1,88 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Generates inputs of a given size that are likely to expose performance cliffs in a parser,
+// such as deep nesting, huge numbers of keys and long runs of escape sequences.
+// The nesting depth is a quarter of n, as the formatted output of nested values grows with the square of the depth.
+
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+struct AdversarialInput
+{
+    const char* name;
+    std::function<std::string( size_t n )> generate;
+};
+
+inline std::vector<AdversarialInput> adversarial_inputs()
+{
+    using std::string;
+    using std::to_string;
+
+    return {
+        { "nested arrays",
+          []( size_t n ) { return string( n / 4, '[' ) + string( n / 4, ']' ); } },
+        { "nested objects",
+          []( size_t n )
+          {
+              string s;
+              for ( size_t i = 0; i < n / 4; ++i )
+              {
+                  s += "{\"a\":";
+              }
+              return s + "0" + string( n / 4, '}' );
+          } },
+        { "unclosed nesting", // fails at the end, after the deepest level
+          []( size_t n ) { return string( n / 4, '[' ); } },
+        { "many keys",
+          []( size_t n )
+          {
+              string s = "{";
+              for ( size_t i = 0; i < n; ++i )
+              {
+                  s += ( i ? ",\"k" : "\"k" ) + to_string( i ) + "\":" + to_string( i );
+              }
+              return s + "}";
+          } },
+        { "duplicate keys",
+          []( size_t n )
+          {
+              string s = "{";
+              for ( size_t i = 0; i < n; ++i )
+              {
+                  s += i ? ",\"k\":0" : "\"k\":0";
+              }
+              return s + "}";
+          } },
+        { "many elements",
+          []( size_t n )
+          {
+              string s = "[";
+              for ( size_t i = 0; i < n; ++i )
+              {
+                  s += i ? ",0" : "0";
+              }
+              return s + "]";
+          } },
+        { "long escape run",
+          []( size_t n )
+          {
+              string s = "\"";
+              for ( size_t i = 0; i < n; ++i )
+              {
+                  s += "\\n";
+              }
+              return s + "\"";
+          } },
+        { "long string",
+          []( size_t n ) { return "\"" + string( n, 'x' ) + "\""; } },
+        { "long key",
+          []( size_t n ) { return "{\"" + string( n, 'k' ) + "\":0}"; } },
+        { "long digit run", // fails as it is too big for an int64_t
+          []( size_t n ) { return string( n, '9' ); } },
+        { "many lines",
+          []( size_t n ) { return "[" + string( n, '\n' ) + "0]"; } },
+    };
+}
@@ -0,0 +1,78 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "allocation_counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<size_t> total_allocations;
+    std::atomic<size_t> total_bytes;
+    std::atomic<int64_t> total_live_bytes;
+
+    // each allocation is preceded by its size, so that it can be subtracted from total_live_bytes when freed
+    const size_t header_size = alignof( std::max_align_t );
+
+    void* allocate( size_t size )
+    {
+        char* ptr = static_cast<char*>( std::malloc( size + header_size ) );
+        if ( !ptr )
+        {
+            throw std::bad_alloc();
+        }
+        *reinterpret_cast<size_t*>( ptr ) = size;
+
+        total_allocations.fetch_add( 1, std::memory_order_relaxed );
+        total_bytes.fetch_add( size, std::memory_order_relaxed );
+        total_live_bytes.fetch_add( size, std::memory_order_relaxed );
+
+        return ptr + header_size;
+    }
+
+    void deallocate( void* user_ptr ) noexcept
+    {
+        if ( user_ptr )
+        {
+            char* ptr = static_cast<char*>( user_ptr ) - header_size;
+            total_live_bytes.fetch_sub( *reinterpret_cast<size_t*>( ptr ), std::memory_order_relaxed );
+            std::free( ptr );
+        }
+    }
+} // namespace
+
+AllocationCounts AllocationCounts::now()
+{
+    return { total_allocations.load(), total_bytes.load(), total_live_bytes.load() };
+}
+
+void* operator new( size_t size )
+{
+    return allocate( size );
+}
+
+void* operator new[]( size_t size )
+{
+    return allocate( size );
+}
+
+void operator delete( void* ptr ) noexcept
+{
+    deallocate( ptr );
+}
+
+void operator delete[]( void* ptr ) noexcept
+{
+    deallocate( ptr );
+}
+
+void operator delete( void* ptr, size_t ) noexcept
+{
+    deallocate( ptr );
+}
+
+void operator delete[]( void* ptr, size_t ) noexcept
+{
+    deallocate( ptr );
+}
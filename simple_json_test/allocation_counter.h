@@ -0,0 +1,25 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Counts the allocations made through the global operator new by the test executable,
+// so that tests can measure memory use and check for unexpected allocations.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// A snapshot of the allocation counts, subtract an earlier snapshot to get the counts in between.
+//
+struct AllocationCounts
+{
+    size_t allocations = 0; // number of allocations made
+    size_t bytes = 0;       // number of bytes allocated
+    int64_t live_bytes = 0; // number of bytes allocated and not yet freed
+
+    static AllocationCounts now();
+
+    AllocationCounts operator-( const AllocationCounts& earlier ) const
+    {
+        return { allocations - earlier.allocations, bytes - earlier.bytes, live_bytes - earlier.live_bytes };
+    }
+};
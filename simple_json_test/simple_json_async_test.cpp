@@ -0,0 +1,322 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_async.h"
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    // A single threaded executor and event loop, resuming coroutines when posted or when a file descriptor is ready.
+    //
+    class PollLoop
+    {
+      public:
+        void post( coroutine_handle<> handle )
+        {
+            ready_.push_back( handle );
+        }
+
+        void wait( int fd, short events, coroutine_handle<> handle )
+        {
+            waiting_.push_back( { fd, events, handle } );
+        }
+
+        template <typename Done>
+        void run_until( Done done )
+        {
+            while ( !done() )
+            {
+                if ( !ready_.empty() )
+                {
+                    const auto handle = ready_.front();
+                    ready_.pop_front();
+                    handle.resume();
+                    continue;
+                }
+
+                ASSERT_FALSE( waiting_.empty() ) << "deadlock";
+
+                vector<pollfd> fds;
+                for ( const auto& waiter : waiting_ )
+                {
+                    fds.push_back( { waiter.fd, waiter.events, 0 } );
+                }
+                ASSERT_GT( ::poll( fds.data(), fds.size(), 10000 ), 0 ) << "timed out";
+
+                for ( size_t i = fds.size(); i-- > 0; )
+                {
+                    if ( fds[ i ].revents )
+                    {
+                        ++wakeups_;
+                        ready_.push_back( waiting_[ i ].handle );
+                        waiting_.erase( waiting_.begin() + i );
+                    }
+                }
+            }
+        }
+
+        bool idle() const
+        {
+            return ready_.empty();
+        }
+
+        size_t wakeups() const
+        {
+            return wakeups_;
+        }
+
+      private:
+        struct Waiter
+        {
+            int fd;
+            short events;
+            coroutine_handle<> handle;
+        };
+
+        deque<coroutine_handle<>> ready_;
+        vector<Waiter> waiting_;
+        size_t wakeups_ = 0;
+    };
+
+    // Reads from or writes to a non-blocking file descriptor, suspending until it is ready.
+    //
+    class FdStream
+    {
+      public:
+        FdStream( int fd, PollLoop& loop )
+            : fd_( fd )
+            , loop_( loop )
+        {
+            ::fcntl( fd_, F_SETFL, ::fcntl( fd_, F_GETFL ) | O_NONBLOCK );
+        }
+
+        auto read_some( span<char> buffer )
+        {
+            return Transfer{ this, POLLIN, [ = ]( int fd ) { return ::read( fd, buffer.data(), buffer.size() ); } };
+        }
+
+        auto write_some( span<const char> data )
+        {
+            return Transfer{ this, POLLOUT, [ = ]( int fd ) { return ::write( fd, data.data(), data.size() ); } };
+        }
+
+      private:
+        template <typename Op>
+        struct Transfer
+        {
+            FdStream* stream;
+            short events;
+            Op op;
+            ssize_t result = 0;
+
+            bool try_op()
+            {
+                result = op( stream->fd_ );
+                return result >= 0 || ( errno != EAGAIN && errno != EWOULDBLOCK );
+            }
+
+            bool await_ready()
+            {
+                return try_op();
+            }
+
+            void await_suspend( coroutine_handle<> handle )
+            {
+                stream->loop_.wait( stream->fd_, events, handle );
+            }
+
+            expected<size_t, string> await_resume()
+            {
+                if ( result < 0 && !try_op() )
+                {
+                    return std::unexpected( string( "spurious wake up" ) );
+                }
+                if ( result < 0 )
+                {
+                    return std::unexpected( string( strerror( errno ) ) );
+                }
+                return static_cast<size_t>( result );
+            }
+        };
+
+        int fd_;
+        PollLoop& loop_;
+    };
+
+    struct SocketPair
+    {
+        int fds[ 2 ];
+
+        SocketPair()
+        {
+            EXPECT_EQ( 0, ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ) );
+        }
+
+        ~SocketPair()
+        {
+            close( 0 );
+            close( 1 );
+        }
+
+        void close( int i )
+        {
+            if ( fds[ i ] >= 0 )
+            {
+                ::close( fds[ i ] );
+                fds[ i ] = -1;
+            }
+        }
+    };
+
+    Value make_large_value()
+    {
+        Array arr;
+        for ( int i = 0; i < 20000; ++i )
+        {
+            arr.push_back( Object{ { "id", i }, { "name", "item \"" + to_string( i ) + "\"" }, { "tags", Array{ "a", "b]", true, Null() } } } );
+        }
+        return arr;
+    }
+} // namespace
+
+TEST( Simple_json_async_test, test_write_and_parse )
+{
+    PollLoop loop;
+    SocketPair sockets;
+    FdStream writer( sockets.fds[ 0 ], loop );
+    FdStream reader( sockets.fds[ 1 ], loop );
+
+    const Value value = make_large_value(); // larger than the socket buffers, so both sides suspend
+
+    auto parse_task = async_parse( reader, loop, ParseOptions(), 4096 );
+    auto write_task = async_write( writer, value, loop );
+    parse_task.start();
+    write_task.start();
+
+    loop.run_until( [ & ] { return parse_task.done(); } ); // the writer is not closed, the array's end completes the parse
+
+    ASSERT_TRUE( write_task.done() );
+    EXPECT_TRUE( write_task.result() ) << write_task.result().error();
+    ASSERT_TRUE( parse_task.result() ) << parse_task.result().error();
+    EXPECT_EQ( value, *parse_task.result() );
+    EXPECT_GT( loop.wakeups(), 2u );
+}
+
+TEST( Simple_json_async_test, test_parse_scalar_until_end_of_input )
+{
+    PollLoop loop;
+    SocketPair sockets;
+    FdStream reader( sockets.fds[ 1 ], loop );
+
+    auto task = async_parse( reader, loop );
+    task.start();
+
+    ASSERT_EQ( 3, ::write( sockets.fds[ 0 ], "123", 3 ) );
+    loop.run_until( [ & ] { return loop.idle(); } ); // until the reader is waiting for more
+    EXPECT_FALSE( task.done() ); // more digits may follow
+
+    ASSERT_EQ( 2, ::write( sockets.fds[ 0 ], "45", 2 ) );
+    sockets.close( 0 );
+    loop.run_until( [ & ] { return task.done(); } );
+
+    ASSERT_TRUE( task.result() ) << task.result().error();
+    EXPECT_EQ( Value( 12345 ), *task.result() );
+}
+
+TEST( Simple_json_async_test, test_parse_pipelined_values )
+{
+    PollLoop loop;
+    SocketPair sockets;
+    FdStream stream( sockets.fds[ 1 ], loop );
+    BufferedReader reader( stream );
+
+    // values split between reads, with several in one read
+    ASSERT_EQ( 14, ::write( sockets.fds[ 0 ], "{\"a\":1} [2,3]{", 14 ) );
+
+    const auto parse_next = [ & ]() {
+        auto task = async_parse( reader, loop );
+        task.start();
+        loop.run_until( [ & ] { return task.done(); } );
+        return std::move( task.result() );
+    };
+
+    EXPECT_EQ( Value( Object{ { "a", 1 } } ), parse_next() );
+    EXPECT_EQ( Value( Array{ 2, 3 } ), parse_next() );
+
+    ASSERT_EQ( 8, ::write( sockets.fds[ 0 ], "\"b\":4}\n ", 8 ) );
+    EXPECT_EQ( Value( Object{ { "b", 4 } } ), parse_next() );
+}
+
+TEST( Simple_json_async_test, test_errors )
+{
+    PollLoop loop;
+    SocketPair sockets;
+    FdStream reader( sockets.fds[ 1 ], loop );
+
+    ASSERT_EQ( 7, ::write( sockets.fds[ 0 ], "[1, 2, ", 7 ) );
+    sockets.close( 0 );
+
+    auto task = async_parse( reader, loop );
+    task.start();
+    loop.run_until( [ & ] { return task.done(); } );
+
+    ASSERT_FALSE( task.result() );
+    EXPECT_EQ( parse( "[1, 2, " ).error(), task.result().error() );
+
+    // a reader that cannot take back what follows a value, and the options
+    for ( const auto& [ json, options ] : { pair( string( "[1] \n" ), ParseOptions() ), pair( string( "{} garbage" ), ParseOptions() ),
+                                            pair( string( "[[1]]" ), ParseOptions{ .max_depth = 1 } ) } )
+    {
+        SocketPair more;
+        FdStream more_reader( more.fds[ 1 ], loop );
+        ASSERT_EQ( json.size(), ::write( more.fds[ 0 ], json.data(), json.size() ) );
+
+        auto more_task = async_parse( more_reader, loop, options );
+        more_task.start();
+        loop.run_until( [ & ] { return more_task.done(); } );
+        EXPECT_EQ( parse( json, options ), more_task.result() ) << json;
+    }
+
+    FdStream closed( sockets.fds[ 1 ], loop );
+    sockets.close( 1 );
+
+    const Value value = Array{ 1, 2 };
+    auto write_task = async_write( closed, value, loop );
+    write_task.start();
+    loop.run_until( [ & ] { return write_task.done(); } );
+
+    ASSERT_FALSE( write_task.result() );
+    EXPECT_EQ( strerror( EBADF ), write_task.result().error() );
+}
+
+TEST( Simple_json_async_test, test_composes_with_other_coroutines )
+{
+    PollLoop loop;
+    SocketPair sockets;
+    FdStream writer( sockets.fds[ 0 ], loop );
+    FdStream reader( sockets.fds[ 1 ], loop );
+
+    // echoes a value back through the same pair of sockets, counting its elements
+    auto round_trip = [ & ]( Value value ) -> Task<size_t> {
+        auto written = co_await async_write( writer, value, loop );
+        EXPECT_TRUE( written );
+        auto parsed = co_await async_parse( reader, loop );
+        co_return parsed ? get<Array>( *parsed ).size() : 0;
+    };
+
+    auto task = round_trip( Array{ 1, "two", Object{ { "three", 3 } } } );
+    task.start();
+    loop.run_until( [ & ] { return task.done(); } );
+
+    EXPECT_EQ( 3u, task.result() );
+}
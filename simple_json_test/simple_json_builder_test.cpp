@@ -0,0 +1,141 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "allocation_counter.h"
+#include "simple_json_builder.h"
+#include "simple_json_writer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    // too long for a small string, so copying it allocates
+    const char* const record_name = "a record with a name too long to be a small string";
+
+    // writes the same JSON through a Writer or a Builder
+    //
+    template <typename Output>
+    void write_record( Output& out, int i )
+    {
+        out.begin_object().key( "active" ).value( i % 2 == 0 ).key( "id" ).value( i ).key( "name" ).value( record_name );
+        out.key( "scores" ).begin_array().value( i ).value( i + 1 ).value( i + 2 ).end_array().end_object();
+    }
+} // namespace
+
+TEST( Simple_json_builder_test, test_build )
+{
+    Value value;
+    Builder builder( value );
+
+    builder.begin_object()
+        .key( "id" )
+        .value( 42 )
+        .key( "name" )
+        .value( "Bob" )
+        .key( "tags" )
+        .begin_array()
+        .value( true )
+        .value( Null() )
+        .begin_object()
+        .key( "a" )
+        .begin_array()
+        .end_array()
+        .end_object()
+        .value( Array{ 1, 2 } )
+        .end_array()
+        .key( "id" )
+        .value( 43 )
+        .end_object();
+
+    EXPECT_TRUE( builder.complete() );
+    EXPECT_EQ( Value( Object{ { "id", 43 }, { "name", "Bob" }, { "tags", Array{ true, Null(), Object{ { "a", Array() } }, Array{ 1, 2 } } } } ), value );
+
+    Value scalar;
+    EXPECT_TRUE( Builder( scalar ).value( "s" ).complete() );
+    EXPECT_EQ( Value( "s" ), scalar );
+}
+
+TEST( Simple_json_builder_test, test_build_as_writer_does )
+{
+    Value value;
+    string json;
+    Builder builder( value );
+    Writer writer( json );
+
+    builder.begin_array();
+    writer.begin_array();
+    for ( int i = 0; i < 3; ++i )
+    {
+        write_record( builder, i );
+        write_record( writer, i );
+    }
+    builder.end_array();
+    writer.end_array();
+
+    EXPECT_EQ( *parse( json ), value );
+}
+
+TEST( Simple_json_builder_test, test_build_does_not_copy )
+{
+    const string long_string( 100, 'x' );
+    Value value;
+
+    const AllocationCounts start = AllocationCounts::now();
+    {
+        Builder builder( value );
+        builder.begin_array().value( long_string ).begin_object().key( "a" ).begin_array().value( long_string ).end_array().end_object().end_array();
+    }
+    const AllocationCounts used = AllocationCounts::now() - start;
+
+    // the stack of levels growing to capacities 1, 2 and 4, the outer array growing to 1 and 2, the member,
+    // the inner array and the two strings, so no value is copied after being added
+    EXPECT_EQ( 3u + 2 + 1 + 1 + 2, used.allocations );
+    EXPECT_EQ( Value( Array{ long_string, Object{ { "a", Array{ long_string } } } } ), value );
+}
+
+TEST( Simple_json_builder_test, test_misuse_is_caught_in_debug_builds )
+{
+    Value value;
+    EXPECT_DEBUG_DEATH( Builder( value ).begin_object().value( 1 ), "without a key" );
+    EXPECT_DEBUG_DEATH( Builder( value ).begin_array().key( "a" ), "outside an object" );
+    EXPECT_DEBUG_DEATH( Builder( value ).begin_array().end_object(), "without begin_object" );
+    EXPECT_DEBUG_DEATH( Builder( value ).begin_object().key( "a" ).end_object(), "without a value" );
+    EXPECT_DEBUG_DEATH( Builder( value ).value( 1 ).value( 2 ), "more than one value" );
+}
+
+// run with --gtest_also_run_disabled_tests to compare building a Value from nested initializer lists, which copies
+// each value from its list, with a Builder
+TEST( DISABLED_Simple_json_builder_test, test_build_speed )
+{
+    const int num_records = 500000;
+
+    const AllocationCounts list_counts = AllocationCounts::now();
+    auto start = chrono::steady_clock::now();
+    Array records;
+    for ( int i = 0; i < num_records; ++i )
+    {
+        records.push_back( Object{ { "active", i % 2 == 0 }, { "id", i }, { "name", record_name }, { "scores", Array{ i, i + 1, i + 2 } } } );
+    }
+    const auto list_time = chrono::steady_clock::now() - start;
+    const AllocationCounts list_used = AllocationCounts::now() - list_counts;
+
+    const AllocationCounts build_counts = AllocationCounts::now();
+    start = chrono::steady_clock::now();
+    Value built;
+    Builder builder( built );
+    builder.begin_array();
+    for ( int i = 0; i < num_records; ++i )
+    {
+        write_record( builder, i );
+    }
+    builder.end_array();
+    const auto build_time = chrono::steady_clock::now() - start;
+    const AllocationCounts build_used = AllocationCounts::now() - build_counts;
+
+    EXPECT_EQ( Value( std::move( records ) ), built );
+    cout << "initializer lists " << chrono::duration_cast<chrono::milliseconds>( list_time ) << ", " << list_used.allocations << " allocations\n"
+         << "builder           " << chrono::duration_cast<chrono::milliseconds>( build_time ) << ", " << build_used.allocations << " allocations\n";
+}
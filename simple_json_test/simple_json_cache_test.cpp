@@ -0,0 +1,136 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_cache.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+using namespace simple_json;
+using namespace std;
+
+TEST( Simple_json_cache_test, test_hit_and_miss )
+{
+    ParseCache cache( 4 );
+
+    const auto first = cache.parse( R"({"a":[1,2]})" );
+    ASSERT_TRUE( first );
+    EXPECT_EQ( 1u, cache.stats().misses );
+    EXPECT_EQ( 0u, cache.stats().hits );
+
+    const auto second = cache.parse( R"({"a":[1,2]})" );
+    ASSERT_TRUE( second );
+    EXPECT_EQ( first->get(), second->get() ); // the same shared value
+    EXPECT_EQ( 1u, cache.stats().hits );
+
+    const auto different = cache.parse( R"({"a":[1, 2]})" ); // equal value, but different text
+    ASSERT_TRUE( different );
+    EXPECT_NE( first->get(), different->get() );
+    EXPECT_EQ( **first, **different );
+    EXPECT_EQ( 2u, cache.stats().misses );
+    EXPECT_EQ( 2u, cache.size() );
+}
+
+TEST( Simple_json_cache_test, test_errors_are_not_cached )
+{
+    ParseCache cache( 4 );
+
+    const auto result = cache.parse( "[1," );
+    ASSERT_FALSE( result );
+    EXPECT_EQ( result.error(), parse( "[1," ).error() );
+    EXPECT_EQ( 0u, cache.size() );
+}
+
+TEST( Simple_json_cache_test, test_least_recently_used_is_evicted )
+{
+    ParseCache cache( 2 );
+
+    cache.parse( "1" );
+    cache.parse( "2" );
+    cache.parse( "1" ); // "2" is now the least recently used
+    cache.parse( "3" );
+    EXPECT_EQ( 2u, cache.size() );
+
+    const auto before = cache.stats();
+    cache.parse( "1" );
+    cache.parse( "3" );
+    EXPECT_EQ( before.hits + 2, cache.stats().hits );
+
+    cache.parse( "2" );
+    EXPECT_EQ( before.misses + 1, cache.stats().misses );
+
+    cache.clear();
+    EXPECT_EQ( 0u, cache.size() );
+}
+
+TEST( Simple_json_cache_test, test_zero_capacity )
+{
+    ParseCache cache( 0 );
+
+    ASSERT_TRUE( cache.parse( "[]" ) );
+    ASSERT_TRUE( cache.parse( "[]" ) );
+    EXPECT_EQ( 2u, cache.stats().misses );
+    EXPECT_EQ( 0u, cache.size() );
+}
+
+TEST( Simple_json_cache_test, test_concurrent_use )
+{
+    ParseCache cache( 8 );
+    const vector<string> inputs = { "[1]", "[2]", "[3]", "[4]", "[5]", "[6]", "[7]", "[8]", "[9]", "[10]" };
+    const int per_thread = 2000;
+    atomic<int> failures = 0;
+
+    {
+        vector<jthread> threads;
+        for ( int t = 0; t < 4; ++t )
+        {
+            threads.emplace_back( [ & ]()
+                                  {
+                                      for ( int i = 0; i < per_thread; ++i )
+                                      {
+                                          const string& input = inputs[ ( i * 7 + t ) % inputs.size() ];
+                                          const auto result = cache.parse( input );
+                                          if ( !result || to_canonical_string( **result ) != input )
+                                          {
+                                              ++failures;
+                                          }
+                                      }
+                                  } );
+        }
+    }
+
+    EXPECT_EQ( 0, failures );
+    EXPECT_EQ( 4u * per_thread, cache.stats().hits + cache.stats().misses );
+    EXPECT_LE( cache.size(), 8u );
+}
+
+// run with --gtest_also_run_disabled_tests to compare cached and uncached parsing of a repeated input
+TEST( DISABLED_Simple_json_cache_test, test_cache_speed )
+{
+    string json = R"({"policies":[)";
+    for ( int i = 0; i < 200; ++i )
+    {
+        json += ( i ? "," : "" ) + R"({"id":)"s + to_string( i ) + R"(,"allow":true,"resource":"/api/v1/resource/)" + to_string( i ) + R"("})";
+    }
+    json += "]}";
+
+    const int runs = 10000;
+    ParseCache cache( 16 );
+
+    auto start = chrono::steady_clock::now();
+    for ( int i = 0; i < runs; ++i )
+    {
+        ASSERT_TRUE( parse( json ) );
+    }
+    const auto uncached = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for ( int i = 0; i < runs; ++i )
+    {
+        ASSERT_TRUE( cache.parse( json ) );
+    }
+    const auto cached = chrono::steady_clock::now() - start;
+
+    cout << "parse:            " << chrono::duration_cast<chrono::microseconds>( uncached ).count() / runs << " us\n";
+    cout << "ParseCache::parse: " << chrono::duration_cast<chrono::nanoseconds>( cached ).count() / runs << " ns\n";
+}
@@ -0,0 +1,141 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "allocation_counter.h"
+#include "simple_json_columnar.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace simple_json;
+using namespace std;
+
+TEST( Simple_json_columnar_test, test_parse_table )
+{
+    const auto table = parse_table( R"([
+        { "id": 1, "name": "Alice", "active": true, "score": null },
+        { "name": "Bob", "id": 2, "active": false, "score": 7 },
+        { "id": 3, "name": null, "active": true, "extra": "x" }
+    ])" );
+    ASSERT_TRUE( table ) << table.error();
+
+    EXPECT_EQ( 3u, table->rows );
+    ASSERT_EQ( 5u, table->columns.size() );
+
+    const Column* id = table->find( "id" );
+    ASSERT_TRUE( id );
+    EXPECT_EQ( Column::Type::integer, id->type );
+    EXPECT_EQ( ( vector<int64_t>{ 1, 2, 3 } ), id->integers );
+    EXPECT_EQ( ( vector<bool>{ false, false, false } ), id->nulls );
+
+    const Column* name = table->find( "name" );
+    ASSERT_TRUE( name );
+    EXPECT_EQ( Column::Type::string, name->type );
+    EXPECT_EQ( ( vector<string>{ "Alice", "Bob", "" } ), name->strings );
+    EXPECT_TRUE( name->is_null( 2 ) );
+
+    const Column* active = table->find( "active" );
+    ASSERT_TRUE( active );
+    EXPECT_EQ( Column::Type::boolean, active->type );
+    EXPECT_EQ( ( vector<bool>{ true, false, true } ), active->booleans );
+
+    // a column whose first values are null, or that is missing from some rows
+    const Column* score = table->find( "score" );
+    ASSERT_TRUE( score );
+    EXPECT_EQ( ( vector<int64_t>{ 0, 7, 0 } ), score->integers );
+    EXPECT_EQ( ( vector<bool>{ true, false, true } ), score->nulls );
+
+    const Column* extra = table->find( "extra" );
+    ASSERT_TRUE( extra );
+    EXPECT_EQ( ( vector<string>{ "", "", "x" } ), extra->strings );
+    EXPECT_EQ( ( vector<bool>{ true, true, false } ), extra->nulls );
+
+    EXPECT_FALSE( table->find( "missing" ) );
+}
+
+TEST( Simple_json_columnar_test, test_special_tables )
+{
+    const auto empty = parse_table( " [ ] " );
+    ASSERT_TRUE( empty );
+    EXPECT_EQ( 0u, empty->rows );
+    EXPECT_TRUE( empty->columns.empty() );
+
+    const auto all_null = parse_table( R"([{"a":null},{}])" );
+    ASSERT_TRUE( all_null );
+    EXPECT_EQ( Column::Type::null, all_null->columns[ 0 ].type );
+    EXPECT_EQ( ( vector<bool>{ true, true } ), all_null->columns[ 0 ].nulls );
+
+    const auto duplicates = parse_table( R"([{"a":1,"a":[2]}])" ); // the first value is kept, as by parse()
+    ASSERT_TRUE( duplicates );
+    EXPECT_EQ( ( vector<int64_t>{ 1 } ), duplicates->columns[ 0 ].integers );
+}
+
+TEST( Simple_json_columnar_test, test_errors )
+{
+    auto check_error = []( const string& json_str, const string& expected_error ) {
+        const auto table = parse_table( json_str );
+        ASSERT_FALSE( table ) << json_str;
+        EXPECT_EQ( expected_error, table.error() );
+    };
+
+    check_error( R"({"a":1})", "expected an array of objects at line 1 column 1" );
+    check_error( R"([{"a":1},2])", "row 1 is not an object at line 1 column 10" );
+    check_error( R"([{"a":1},{"a":"x"}])", R"(value of "a" in row 1 is not of type integer at line 1 column 15)" );
+    check_error( R"([{"a":[1]}])", R"(value of "a" in row 0 is not an integer, boolean, string or null at line 1 column 7)" );
+    check_error( R"([{"a":1})", "missing closing ']' at line 1 column 9" );
+    check_error( R"([{"a":1}] x)", "unprocessed data at line 1 column 11" );
+    check_error( R"([{"a" 1}])", "missing ':' at line 1 column 7" );
+    check_error( R"([{"a":tru}])", R"(expected "true" at line 1 column 7)" );
+}
+
+// run with --gtest_also_run_disabled_tests to compare decoding rows into columns with parsing them into Objects
+TEST( DISABLED_Simple_json_columnar_test, test_parse_table_speed )
+{
+    string json = "[";
+    for ( int i = 0; i < 200000; ++i )
+    {
+        json += ( i ? ",\n" : "" ) + R"({"id":)"s + to_string( i ) + R"(,"name":"user)" + to_string( i ) + R"(","active":)" +
+                ( i % 3 ? "true" : "false" ) + R"(,"score":)" + ( i % 10 ? to_string( i % 1000 ) : "null" ) + "}";
+    }
+    json += "]";
+
+    AllocationCounts start_counts = AllocationCounts::now();
+    auto start = chrono::steady_clock::now();
+    const auto value = parse( json );
+    const auto parse_time = chrono::steady_clock::now() - start;
+    const AllocationCounts parse_counts = AllocationCounts::now() - start_counts;
+    ASSERT_TRUE( value );
+
+    start_counts = AllocationCounts::now();
+    start = chrono::steady_clock::now();
+    const auto table = parse_table( json );
+    const auto table_time = chrono::steady_clock::now() - start;
+    const AllocationCounts table_counts = AllocationCounts::now() - start_counts;
+    ASSERT_TRUE( table );
+
+    start = chrono::steady_clock::now();
+    int64_t total = 0;
+    for ( const Value& row : get<Array>( *value ) )
+    {
+        if ( const int64_t* score = get_if<int64_t>( &get<Object>( row ).at( "score" ) ) )
+        {
+            total += *score;
+        }
+    }
+    const auto row_scan_time = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    int64_t column_total = 0;
+    const Column& score = *table->find( "score" );
+    for ( const int64_t s : score.integers ) // null scores are 0
+    {
+        column_total += s;
+    }
+    const auto column_scan_time = chrono::steady_clock::now() - start;
+
+    EXPECT_EQ( total, column_total );
+
+    cout << "parse:       " << chrono::duration_cast<chrono::milliseconds>( parse_time ) << ", " << parse_counts.allocations << " allocations, scan "
+         << chrono::duration_cast<chrono::microseconds>( row_scan_time ) << "\n";
+    cout << "parse_table: " << chrono::duration_cast<chrono::milliseconds>( table_time ) << ", " << table_counts.allocations << " allocations, scan "
+         << chrono::duration_cast<chrono::microseconds>( column_scan_time ) << "\n";
+}
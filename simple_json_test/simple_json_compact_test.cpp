@@ -0,0 +1,226 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "allocation_counter.h"
+#include "simple_json_compact.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    string to_string( const CompactValue& value )
+    {
+        ostringstream os;
+        os << to_value( value );
+        return os.str();
+    }
+} // namespace
+
+TEST( Simple_json_compact_test, test_alternatives )
+{
+    EXPECT_EQ( sizeof( CompactValue ), 16 );
+
+    const CompactValue null_value;
+    EXPECT_EQ( null_value.index(), 3 );
+    EXPECT_TRUE( holds_alternative<Null>( null_value ) );
+    EXPECT_FALSE( get_if<int64_t>( &null_value ) );
+
+    const CompactValue int_value( -1234567890123 );
+    EXPECT_EQ( int_value.index(), 2 );
+    ASSERT_TRUE( get_if<int64_t>( &int_value ) );
+    EXPECT_EQ( *get_if<int64_t>( &int_value ), -1234567890123 );
+
+    const CompactValue bool_value( true );
+    EXPECT_EQ( bool_value.index(), 1 );
+    ASSERT_TRUE( get_if<bool>( &bool_value ) );
+    EXPECT_TRUE( *get_if<bool>( &bool_value ) );
+
+    for ( const string s : { "", "short", "exactly 15 char", "a string too long to be stored inline" } )
+    {
+        const CompactValue str_value( s );
+        EXPECT_EQ( str_value.index(), 0 );
+        const CompactString* str = get_if<CompactString>( &str_value );
+        ASSERT_TRUE( str );
+        EXPECT_EQ( str->view(), s );
+        EXPECT_EQ( str->is_inline(), s.size() <= CompactString::max_inline_size );
+
+        CompactValue copy = str_value;
+        EXPECT_EQ( get_if<CompactString>( &copy )->view(), s );
+
+        CompactValue moved = std::move( copy );
+        EXPECT_EQ( get_if<CompactString>( &moved )->view(), s );
+    }
+
+    CompactValue value( CompactArray{ 1, "two", CompactObject{ { "three", 3 } } } );
+    EXPECT_EQ( value.index(), 4 );
+    CompactArray* arr = get_if<CompactArray>( &value );
+    ASSERT_TRUE( arr );
+    ASSERT_EQ( arr->size(), 3 );
+    ( *arr )[ 0 ] = "one";
+    EXPECT_EQ( get_if<CompactString>( &( *arr )[ 0 ] )->view(), "one" );
+
+    const CompactValue copy = value;
+    value = Null();
+    EXPECT_EQ( to_string( copy ), "[\n"
+                                  "    \"one\", \"two\", {\n"
+                                  "        \"three\" : 3\n"
+                                  "    }\n"
+                                  "]" );
+}
+
+TEST( Simple_json_compact_test, test_object )
+{
+    CompactObject obj;
+    obj[ "b" ] = 2;
+    obj[ "c" ] = "three";
+    obj[ "a" ] = true;
+    EXPECT_FALSE( obj.emplace( "b", 22 ).second );
+
+    ASSERT_EQ( obj.size(), 3 );
+    EXPECT_EQ( obj.begin()->first.view(), "a" );
+    EXPECT_EQ( obj.find( "d" ), obj.end() );
+
+    const auto b = get_value<int64_t>( obj, "b" );
+    ASSERT_TRUE( b );
+    EXPECT_EQ( b->get(), 2 );
+
+    const auto c = get_value<CompactString>( obj, "c" );
+    ASSERT_TRUE( c );
+    EXPECT_EQ( c->get().view(), "three" );
+
+    EXPECT_EQ( get_value<int64_t>( obj, "c" ).error(), "field \"c\" is not the expected type" );
+    EXPECT_EQ( get_value<int64_t>( obj, "d" ).error(), "field \"d\" not found" );
+}
+
+TEST( Simple_json_compact_test, test_parse_compact )
+{
+    const string json_str = "{\n"
+                            "    \"age\" : 21,\n"
+                            "    \"grades\" : [\n"
+                            "        55, 69, 64\n"
+                            "    ],\n"
+                            "    \"name\" : \"Bob\",\n"
+                            "    \"notes\" : \"a note too long to store inline\",\n"
+                            "    \"valid\" : true,\n"
+                            "    \"x\" : null\n"
+                            "}";
+
+    const auto value = parse_compact( json_str );
+    ASSERT_TRUE( value );
+    EXPECT_EQ( to_string( *value ), json_str );
+
+    EXPECT_EQ( parse_compact( "[1,]" ).error(), "unexpected character ']' at line 1 column 4" );
+}
+
+TEST( Simple_json_compact_test, test_parse_compact_is_parse )
+{
+    // the same values, with members sorted and the first of duplicates kept, and the same errors
+    for ( const string json : { R"({"b":[1,{}],"a":"a string too long to store inline","b":2,"c":{"z":null,"y":false}})", "[]", " -12 ", R"("s")",
+                                "[1,]", "{\"a\" 1}", "{\"a\":1", "[1,\n2", "tru", "\"\\q\"", "1 2", "" } )
+    {
+        const auto value = parse( json );
+        const auto compact = parse_compact( json );
+        ASSERT_EQ( bool( value ), bool( compact ) ) << json;
+        if ( value )
+        {
+            EXPECT_EQ( *value, to_value( *compact ) ) << json;
+        }
+        else
+        {
+            EXPECT_EQ( value.error(), compact.error() ) << json;
+        }
+    }
+
+    // without building a Value first, so it allocates less than parse() alone
+    string json = "[";
+    for ( int i = 0; i < 1000; ++i )
+    {
+        json += R"({"id":)" + std::to_string( i ) + R"(,"name":"name number )" + std::to_string( i ) + R"(","tags":["a","b"]},)";
+    }
+    json += "{}]";
+
+    AllocationCounts start = AllocationCounts::now();
+    ASSERT_TRUE( parse( json ) );
+    const size_t value_bytes = ( AllocationCounts::now() - start ).bytes;
+
+    start = AllocationCounts::now();
+    ASSERT_TRUE( parse_compact( json ) );
+    EXPECT_GT( value_bytes, ( AllocationCounts::now() - start ).bytes );
+}
+
+TEST( Simple_json_compact_test, test_raw_numbers )
+{
+    const auto raw = parse( "[1.5,12,-123456789012345678901234,2e3]", ParseOptions{ .raw_numbers = true } );
+    const CompactValue value( *raw );
+
+    const CompactArray& arr = *value.get_if<CompactArray>();
+    EXPECT_EQ( "1.5", arr[ 0 ].get_if<RawNumber>()->text() );
+    EXPECT_EQ( 8, arr[ 0 ].index() );
+    EXPECT_EQ( 12, *arr[ 1 ].get_if<int64_t>() ); // an integer that fits is kept inline
+
+    const CompactValue copy = value;
+    EXPECT_EQ( Value( Array{ RawNumber( "1.5" ), 12, RawNumber( "-123456789012345678901234" ), RawNumber( "2e3" ) } ), to_value( copy ) );
+}
+
+TEST( Simple_json_compact_test, test_memory_footprint )
+{
+    Array arr;
+    for ( int i = 0; i < 100000; ++i )
+    {
+        arr.push_back( i );
+    }
+
+    AllocationCounts start = AllocationCounts::now();
+    const Value value = arr;
+    const int64_t value_bytes = ( AllocationCounts::now() - start ).live_bytes;
+
+    start = AllocationCounts::now();
+    const CompactValue compact( value );
+    const int64_t compact_bytes = ( AllocationCounts::now() - start ).live_bytes;
+
+    EXPECT_GE( value_bytes, 2 * compact_bytes );
+}
+
+namespace
+{
+    string key_name( int i )
+    {
+        return "test_" + std::to_string( i );
+    }
+} // namespace
+
+TEST( DISABLED_Simple_json_compact_test, test_memory_usage )
+{
+    Object obj;
+    for ( int i = 0; i < 1000000; ++i )
+    {
+        obj.emplace( key_name( i ), Array{ i, 222, 33333, "abcdefg", true, false, Null{} } );
+    }
+
+    ostringstream os;
+    os << obj;
+    const string json_str = os.str();
+    obj.clear();
+
+    AllocationCounts start = AllocationCounts::now();
+    auto begin = std::chrono::steady_clock::now();
+    auto value = parse( json_str );
+    auto end = std::chrono::steady_clock::now();
+    ASSERT_TRUE( value );
+    const int64_t value_bytes = ( AllocationCounts::now() - start ).live_bytes;
+    cout << "Value: " << value_bytes / 1000000 << " MB, read time " << std::chrono::duration_cast<std::chrono::milliseconds>( end - begin ) << endl;
+    value = Null();
+
+    start = AllocationCounts::now();
+    begin = std::chrono::steady_clock::now();
+    auto compact = parse_compact( json_str );
+    end = std::chrono::steady_clock::now();
+    ASSERT_TRUE( compact );
+    const int64_t compact_bytes = ( AllocationCounts::now() - start ).live_bytes;
+    cout << "CompactValue: " << compact_bytes / 1000000 << " MB, read time " << std::chrono::duration_cast<std::chrono::milliseconds>( end - begin ) << endl;
+
+    cout << "ratio " << static_cast<double>( value_bytes ) / compact_bytes << endl;
+}
@@ -0,0 +1,197 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#ifdef SIMPLE_JSON_HAVE_ZLIB
+
+#include "allocation_counter.h"
+#include "simple_json_compress.h"
+#include "simple_json_writer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    string compress( const string& text, Compression compression = Compression::gzip )
+    {
+        ostringstream out;
+        Compressor compressor( out, compression );
+        compressor.append( text.data(), text.size() );
+        EXPECT_TRUE( compressor.finish() );
+        return out.str();
+    }
+
+    expected<Value, string> parse_gzip( const string& text, const ParseOptions& options = ParseOptions(), size_t chunk_size = 7 )
+    {
+        istringstream in( compress( text ) );
+        return parse_compressed( in, Compression::gzip, options, StreamOptions{ .threaded = false, .chunk_size = chunk_size } );
+    }
+
+    Value make_records( int num_records )
+    {
+        Array records;
+        for ( int i = 0; i < num_records; ++i )
+        {
+            records.push_back( Object{ { "id", i }, { "name", "record \"" + to_string( i ) + "\"" }, { "tags", Array{ "a,b", "[c]", Null() } } } );
+        }
+        return records;
+    }
+} // namespace
+
+TEST( Simple_json_compress_test, test_round_trip )
+{
+    const Value value = make_records( 1000 );
+
+    for ( const bool threaded : { false, true } )
+    {
+        // chunks small enough that elements, strings and escapes are split between them
+        const StreamOptions stream_options{ .threaded = threaded, .chunk_size = 100, .max_queued_chunks = 2 };
+
+        ostringstream out;
+        ASSERT_TRUE( write_compressed( out, value, Compression::gzip, stream_options ) );
+        EXPECT_EQ( "\x1f\x8b", out.str().substr( 0, 2 ) ); // a gzip header
+
+        istringstream in( out.str() );
+        const auto parsed = parse_compressed( in, Compression::gzip, ParseOptions(), stream_options );
+        ASSERT_TRUE( parsed ) << parsed.error();
+        EXPECT_EQ( value, *parsed );
+    }
+}
+
+TEST( Simple_json_compress_test, test_parses_as_parse_does )
+{
+    for ( const string json : { R"( [ 1, "a", {"b":[2,{}]}, [], true, null ] )", "[]", "[ ]", "42", R"( {"a":[1,2]} )", R"(["]",",","\"["])" } )
+    {
+        EXPECT_EQ( parse( json ), parse_gzip( json ) ) << json;
+    }
+
+    const ParseOptions options{ .pack_integer_arrays = true, .ordered_objects = true };
+    EXPECT_EQ( parse( R"([1,2,{"b":1,"a":2}])", options ), parse_gzip( R"([1,2,{"b":1,"a":2}])", options ) );
+    EXPECT_EQ( Value( IntArray{ 1, 2, 3 } ), parse_gzip( "[1,2,3]", options ) );
+}
+
+TEST( Simple_json_compress_test, test_errors )
+{
+    // the same errors, at the same positions in the decompressed text, as parse()
+    for ( const string json : { "[1,\n {\"a\" 1}]", "[1,]", "[,1]", "[1", "[\"ab", "[1] x", "[1,\n  [\"\\q\"]]", "", "{\"a\":}" } )
+    {
+        EXPECT_EQ( parse( json ).error(), parse_gzip( json ).error() ) << json;
+    }
+
+    for ( const ParseOptions& options : { ParseOptions{ .max_depth = 2 }, ParseOptions{ .max_string_bytes = 2 }, ParseOptions{ .max_container_elements = 2 } } )
+    {
+        const string json = R"([1,["abc",[2]],3])";
+        EXPECT_EQ( parse( json, options ).error(), parse_gzip( json, options ).error() );
+    }
+
+    const auto over_budget = parse_gzip( to_canonical_string( make_records( 100 ) ), ParseOptions{ .max_memory = 10000 } );
+    ASSERT_FALSE( over_budget );
+    EXPECT_TRUE( over_budget.error().starts_with( "memory budget of 10000 bytes exceeded at line 1" ) ) << over_budget.error();
+
+    const string compressed = compress( "[1,2,3]" );
+
+    istringstream truncated( compressed.substr( 0, compressed.size() - 4 ) );
+    EXPECT_EQ( "truncated compressed data", parse_compressed( truncated, Compression::gzip ).error() );
+
+    istringstream not_compressed( "[1,2,3]" );
+    EXPECT_EQ( "invalid gzip data: incorrect header check", parse_compressed( not_compressed, Compression::gzip ).error() );
+}
+
+TEST( Simple_json_compress_test, test_concatenated_streams )
+{
+    // as when appending to a compressed log
+    istringstream in( compress( "[1,\n" ) + compress( "2]" ) );
+    EXPECT_EQ( Value( Array{ 1, 2 } ), parse_compressed( in, Compression::gzip ) );
+}
+
+TEST( Simple_json_compress_test, test_writer_to_compressor )
+{
+    ostringstream out;
+    Compressor compressor( out, Compression::gzip, 16 );
+    Writer writer( compressor );
+    writer.begin_array();
+    for ( int i = 0; i < 100; ++i )
+    {
+        writer.value( i );
+    }
+    writer.end_array();
+    ASSERT_TRUE( compressor.finish() );
+
+    istringstream in( out.str() );
+    Decompressor decompressor( in, Compression::gzip, 16 );
+    string text;
+    char buffer[ 10 ];
+    while ( const size_t count = *decompressor.read_some( buffer ) )
+    {
+        text.append( buffer, count );
+    }
+    EXPECT_EQ( "[0,1,2,", text.substr( 0, 7 ) );
+    EXPECT_EQ( 100, get<Array>( *parse( text ) ).size() );
+}
+
+#ifdef SIMPLE_JSON_HAVE_ZSTD
+TEST( Simple_json_compress_test, test_zstd_round_trip )
+{
+    const Value value = make_records( 1000 );
+
+    ostringstream out;
+    ASSERT_TRUE( write_compressed( out, value, Compression::zstd ) );
+    EXPECT_EQ( "\x28\xb5\x2f\xfd", out.str().substr( 0, 4 ) ); // a zstd frame
+
+    istringstream in( out.str() );
+    EXPECT_EQ( value, parse_compressed( in, Compression::zstd ) );
+}
+#else
+TEST( Simple_json_compress_test, test_zstd_not_built )
+{
+    istringstream in( "" );
+    EXPECT_EQ( "zstd support is not built in", parse_compressed( in, Compression::zstd ).error() );
+}
+#endif
+
+// run with --gtest_also_run_disabled_tests to compare decompressing a whole document and then parsing it with
+// parsing it as it is decompressed
+TEST( DISABLED_Simple_json_compress_test, test_parse_compressed_speed )
+{
+    const Value value = make_records( 500000 );
+    ostringstream out;
+    ASSERT_TRUE( write_compressed( out, value, Compression::gzip ) );
+    const string compressed = out.str();
+
+    {
+        const AllocationCounts start_counts = AllocationCounts::now();
+        const auto start = chrono::steady_clock::now();
+        istringstream in( compressed );
+        Decompressor decompressor( in, Compression::gzip );
+        string text;
+        string buffer( 64 * 1024, '\0' );
+        while ( const size_t count = *decompressor.read_some( buffer ) )
+        {
+            text.append( buffer, 0, count );
+        }
+        const auto parsed = parse( text );
+        const auto time = chrono::steady_clock::now() - start;
+        const AllocationCounts used = AllocationCounts::now() - start_counts;
+        EXPECT_EQ( value, *parsed );
+        cout << "decompress, then parse " << text.size() / 1000000 << " MB: " << chrono::duration_cast<chrono::milliseconds>( time ) << ", "
+             << used.bytes / 1000000 << " MB allocated\n";
+    }
+
+    for ( const bool threaded : { false, true } )
+    {
+        const AllocationCounts start_counts = AllocationCounts::now();
+        const auto start = chrono::steady_clock::now();
+        istringstream in( compressed );
+        const auto parsed = parse_compressed( in, Compression::gzip, ParseOptions(), StreamOptions{ .threaded = threaded } );
+        const auto time = chrono::steady_clock::now() - start;
+        const AllocationCounts used = AllocationCounts::now() - start_counts;
+        EXPECT_EQ( value, *parsed );
+        cout << ( threaded ? "parse_compressed, threaded " : "parse_compressed          " ) << chrono::duration_cast<chrono::milliseconds>( time ) << ", "
+             << used.bytes / 1000000 << " MB allocated\n";
+    }
+}
+
+#endif // SIMPLE_JSON_HAVE_ZLIB
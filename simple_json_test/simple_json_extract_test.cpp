@@ -0,0 +1,108 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_extract.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+
+using namespace simple_json;
+using namespace std;
+
+TEST( Simple_json_extract_test, test_extract )
+{
+    const string json = R"(
+        {
+            "id" : 12,
+            "payload" : { "items" : [ { "sku" : "a]b}", "note" : "say \"}\"\\" }, [ [], {} ] ], "paid" : true },
+            "text" : "line\nline",
+            "type" : "order.created",
+            "missed" : null,
+            "tenant" : { "name" : "t", "region" : [ 1, 2 ] },
+            "type" : "duplicate"
+        })";
+
+    const auto fields = extract( json, { "type", "tenant", "absent" } );
+    ASSERT_TRUE( fields ) << fields.error();
+    EXPECT_EQ( Value( "order.created" ), ( *fields )[ 0 ] ); // the first of the duplicates, as parse() keeps
+    EXPECT_EQ( get<Object>( *parse( json ) ).at( "tenant" ), ( *fields )[ 1 ] );
+    EXPECT_FALSE( ( *fields )[ 2 ] );
+
+    // the options apply to the values returned
+    const auto ordered = extract( json, { "tenant" }, ParseOptions{ .pack_integer_arrays = true, .ordered_objects = true } );
+    ASSERT_TRUE( ordered ) << ordered.error();
+    const OrderedObject& tenant = get<OrderedObject>( *( *ordered )[ 0 ] );
+    EXPECT_EQ( "name", tenant.begin()->first );
+    EXPECT_EQ( Value( IntArray{ 1, 2 } ), prev( tenant.end() )->second );
+
+    EXPECT_EQ( Value( "x" ), ( *extract( R"({"a\"b":"x"})", { "a\"b" } ) )[ 0 ] );
+    EXPECT_FALSE( ( *extract( "{}", { "a" } ) )[ 0 ] );
+}
+
+TEST( Simple_json_extract_test, test_stops_when_found )
+{
+    // nothing after the last member found is scanned
+    EXPECT_EQ( Value( 1 ), ( *extract( R"({"a":1,"b":[}  trailing)", { "a" } ) )[ 0 ] );
+
+    // but the whole object is scanned if a member is missing
+    EXPECT_EQ( "unexpected character '}' at line 1 column 13", extract( R"({"a":1,"b":[}  trailing)", { "a", "c" } ).error() );
+}
+
+TEST( Simple_json_extract_test, test_errors )
+{
+    // the same errors as parse() in the part that is scanned
+    for ( const string json : { "{\"a\" 1}", "{\"a\":}", "{\"a\":1", "{\"a\":tru}", "{1}", "{\"a\":1} x", "{\"a\":[1,\n {\"b\":2]}",
+                                "{\"a\":[1,\n \"b]", "{\"a\":[[1]" } )
+    {
+        EXPECT_EQ( parse( json ).error(), extract( json, { "z" } ).error() ) << json;
+    }
+
+    // strings stepped over are not decoded, so their escapes are not checked
+    const string bad_escape = R"({"a":"\q"})";
+    EXPECT_EQ( parse( bad_escape ).error(), extract( bad_escape, { "a" } ).error() );
+    EXPECT_TRUE( extract( bad_escape, { "z" } ) );
+
+    EXPECT_EQ( "expected an object at line 1 column 2", extract( " [1]", { "a" } ).error() );
+    EXPECT_EQ( "expected an object at line 1 column 1", extract( "", { "a" } ).error() );
+
+    // the maximum depth applies to values stepped over
+    const string json = R"({"a":[[1]],"b":[[[1]]]})";
+    const ParseOptions options{ .max_depth = 3 };
+    EXPECT_TRUE( extract( json, { "a" }, options ) );
+    EXPECT_EQ( parse( json, options ).error(), extract( json, { "c" }, options ).error() );
+    EXPECT_EQ( parse( json, options ).error(), extract( json, { "b" }, options ).error() );
+}
+
+// run with --gtest_also_run_disabled_tests to compare parsing whole messages with extracting two members from them
+TEST( DISABLED_Simple_json_extract_test, test_extract_speed )
+{
+    ostringstream os;
+    os << R"({"id":123456789,"items":[)";
+    for ( int i = 0; i < 20; ++i )
+    {
+        os << R"({"sku":"sku-)" << i << R"(","quantity":2,"description":"a \"quoted\" description of the item"},)";
+    }
+    os << R"({}],"address":{"street":"1 Long Street Name","city":"Some City Name"},"type":"order.created","tenant":"tenant-0123456789","paid":true})";
+    const string json = os.str();
+    const int count = 20000;
+
+    auto start = chrono::steady_clock::now();
+    for ( int i = 0; i < count; ++i )
+    {
+        const auto value = parse( json );
+        const auto fields = find_members<2>( get<Object>( *value ), { "type", "tenant" } );
+        ASSERT_TRUE( fields[ 0 ] && fields[ 1 ] );
+    }
+    const auto parse_time = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for ( int i = 0; i < count; ++i )
+    {
+        const auto fields = extract( json, { "type", "tenant" } );
+        ASSERT_TRUE( ( *fields )[ 0 ] && ( *fields )[ 1 ] );
+    }
+    const auto extract_time = chrono::steady_clock::now() - start;
+
+    const auto us = []( auto d ) { return chrono::duration_cast<chrono::microseconds>( d ); };
+    cout << count << " messages of " << json.size() << " bytes: parse " << us( parse_time ) << ", extract " << us( extract_time ) << "\n";
+}
@@ -0,0 +1,127 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_many.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    // returns each document's value, or error, and its text
+    //
+    vector<pair<expected<Value, string>, string>> parse_all( const string& json, const ParseOptions& options = ParseOptions() )
+    {
+        vector<pair<expected<Value, string>, string>> result;
+        for ( ParsedDocument& document : parse_many( json, options ) )
+        {
+            result.emplace_back( std::move( document.value ), json.substr( document.offset, document.size ) );
+        }
+        return result;
+    }
+} // namespace
+
+TEST( Simple_json_many_test, test_parse_many )
+{
+    const auto documents = parse_all( "{\"a\":[1,2]}\n  [\"x\" ]{}\"s\"true 12 -3\r\nnull\n" );
+
+    ASSERT_EQ( 8, documents.size() );
+    EXPECT_EQ( *parse( R"({"a":[1,2]})" ), documents[ 0 ].first );
+    EXPECT_EQ( R"({"a":[1,2]})", documents[ 0 ].second );
+    EXPECT_EQ( Value( Array{ "x" } ), documents[ 1 ].first );
+    EXPECT_EQ( R"(["x" ])", documents[ 1 ].second );
+    EXPECT_EQ( Value( Object() ), documents[ 2 ].first );
+    EXPECT_EQ( Value( "s" ), documents[ 3 ].first );
+    EXPECT_EQ( R"("s")", documents[ 3 ].second );
+    EXPECT_EQ( Value( true ), documents[ 4 ].first );
+    EXPECT_EQ( Value( 12 ), documents[ 5 ].first );
+    EXPECT_EQ( Value( -3 ), documents[ 6 ].first );
+    EXPECT_EQ( Value( Null() ), documents[ 7 ].first );
+    EXPECT_EQ( "null", documents[ 7 ].second );
+
+    EXPECT_TRUE( parse_all( "" ).empty() );
+    EXPECT_TRUE( parse_all( " \n " ).empty() );
+
+    // the options apply to each document
+    const ParseOptions options{ .pack_integer_arrays = true, .max_memory = 200 };
+    const auto packed = parse_all( "[1,2,3]\n[4,5,6]\n[7,8,9]", options );
+    ASSERT_EQ( 3, packed.size() );
+    EXPECT_EQ( Value( IntArray{ 7, 8, 9 } ), packed[ 2 ].first );
+}
+
+TEST( Simple_json_many_test, test_skips_malformed_documents )
+{
+    const string json = "{\"id\":1}\n{\"id\":2,,\"x\" 1}\n{\"id\":3}\n{\"id\":4,\n{\"id\":5}\n{\"id\":6}";
+    const auto documents = parse_all( json );
+
+    ASSERT_EQ( 6, documents.size() );
+    EXPECT_EQ( *parse( R"({"id":1})" ), documents[ 0 ].first );
+
+    // the error at its line and column in the whole string, and the document up to it
+    EXPECT_EQ( "missing ':' at line 2 column 14", documents[ 1 ].first.error() );
+    EXPECT_EQ( R"({"id":2,,"x" )", documents[ 1 ].second );
+
+    // carrying on at the next line
+    EXPECT_EQ( *parse( R"({"id":3})" ), documents[ 2 ].first );
+
+    // a truncated line, whose error is found on the next line, which is still parsed
+    EXPECT_EQ( "unexpected character '{' at line 5 column 1", documents[ 3 ].first.error() );
+    EXPECT_EQ( *parse( R"({"id":5})" ), documents[ 4 ].first );
+    EXPECT_EQ( *parse( R"({"id":6})" ), documents[ 5 ].first );
+
+    // the rest of a malformed document over several lines is parsed from the line after its start
+    const auto multi_line = parse_all( "[1,\n2 x]\n{\"id\":7}" );
+    ASSERT_EQ( 4, multi_line.size() );
+    EXPECT_EQ( "unexpected character 'x' at line 2 column 3", multi_line[ 0 ].first.error() );
+    EXPECT_EQ( Value( 2 ), multi_line[ 1 ].first );
+    EXPECT_EQ( "unexpected character 'x' at line 2 column 3", multi_line[ 2 ].first.error() );
+    EXPECT_EQ( *parse( R"({"id":7})" ), multi_line[ 3 ].first );
+
+    // an unfinished last document
+    const auto unfinished = parse_all( "1 [2" );
+    ASSERT_EQ( 2, unfinished.size() );
+    EXPECT_EQ( "missing closing ']' at line 1 column 5", unfinished[ 1 ].first.error() );
+    EXPECT_EQ( "[2", unfinished[ 1 ].second );
+
+    // each document has the whole of the limits
+    const auto limited = parse_all( "[[[1]]]\n[[1]]", ParseOptions{ .max_depth = 2 } );
+    ASSERT_EQ( 2, limited.size() );
+    EXPECT_FALSE( limited[ 0 ].first );
+    EXPECT_EQ( Value( Array{ Array{ 1 } } ), limited[ 1 ].first );
+}
+
+// run with --gtest_also_run_disabled_tests to compare splitting a log into lines to parse with parse_many()
+TEST( DISABLED_Simple_json_many_test, test_parse_many_speed )
+{
+    ostringstream os;
+    for ( int i = 0; i < 200000; ++i )
+    {
+        os << R"({"time":)" << 1700000000 + i << R"(,"level":"info","message":"request )" << i << R"( handled","tags":["a","b"]})" << "\n";
+    }
+    const string log = os.str();
+
+    auto start = chrono::steady_clock::now();
+    size_t count = 0;
+    istringstream in( log );
+    for ( string line; getline( in, line ); )
+    {
+        count += bool( parse( line ) );
+    }
+    const auto lines_time = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    size_t many_count = 0;
+    for ( const ParsedDocument& document : parse_many( log ) )
+    {
+        many_count += bool( document.value );
+    }
+    const auto many_time = chrono::steady_clock::now() - start;
+
+    EXPECT_EQ( count, many_count );
+
+    const auto ms = []( auto d ) { return chrono::duration_cast<chrono::milliseconds>( d ); };
+    cout << count << " documents: getline and parse " << ms( lines_time ) << ", parse_many " << ms( many_time ) << "\n";
+}
@@ -0,0 +1,220 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_patch.h"
+#include <gtest/gtest.h>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    Value parse_ok( const string& json_str )
+    {
+        auto value = parse( json_str );
+        EXPECT_TRUE( value ) << value.error();
+        return value ? *value : Value();
+    }
+
+    // applies a patch and checks the result, both patch and result given as JSON
+    void check_patch( const string& doc, const string& patch, const string& expected_result )
+    {
+        Value value = parse_ok( doc );
+        auto result = apply_patch( value, get<Array>( parse_ok( patch ) ) );
+        ASSERT_TRUE( result ) << result.error();
+        EXPECT_EQ( value, parse_ok( expected_result ) );
+    }
+
+    void check_patch_error( const string& doc, const string& patch, const string& expected_error )
+    {
+        Value value = parse_ok( doc );
+        auto result = apply_patch( value, get<Array>( parse_ok( patch ) ) );
+        ASSERT_FALSE( result );
+        EXPECT_EQ( result.error(), expected_error );
+    }
+
+    void check_merge_patch( const string& doc, const string& patch, const string& expected_result )
+    {
+        Value value = parse_ok( doc );
+        apply_merge_patch( value, parse_ok( patch ) );
+        EXPECT_EQ( value, parse_ok( expected_result ) );
+    }
+
+    // checks that diff() and merge_diff() produce patches that transform "from" into "to"
+    void check_diff( const string& from_str, const string& to_str, size_t expected_num_operations )
+    {
+        const Value from = parse_ok( from_str );
+        const Value to = parse_ok( to_str );
+
+        const Array patch = diff( from, to );
+        EXPECT_EQ( patch.size(), expected_num_operations );
+
+        Value patched = from;
+        auto result = apply_patch( patched, patch );
+        ASSERT_TRUE( result ) << result.error();
+        EXPECT_EQ( patched, to );
+
+        patched = from;
+        apply_merge_patch( patched, merge_diff( from, to ) );
+        EXPECT_EQ( patched, to );
+    }
+} // namespace
+
+TEST( Simple_json_patch_test, test_apply_patch )
+{
+    // examples from RFC 6902 appendix A
+    check_patch( R"({"foo":"bar"})", R"([{"op":"add","path":"/baz","value":"qux"}])", R"({"baz":"qux","foo":"bar"})" );
+    check_patch( R"({"foo":["bar","baz"]})", R"([{"op":"add","path":"/foo/1","value":"qux"}])", R"({"foo":["bar","qux","baz"]})" );
+    check_patch( R"({"baz":"qux","foo":"bar"})", R"([{"op":"remove","path":"/baz"}])", R"({"foo":"bar"})" );
+    check_patch( R"({"foo":["bar","qux","baz"]})", R"([{"op":"remove","path":"/foo/1"}])", R"({"foo":["bar","baz"]})" );
+    check_patch( R"({"baz":"qux","foo":"bar"})", R"([{"op":"replace","path":"/baz","value":"boo"}])", R"({"baz":"boo","foo":"bar"})" );
+    check_patch( R"({"foo":{"bar":"baz","waldo":"fred"},"qux":{"corge":"grault"}})",
+                 R"([{"op":"move","from":"/foo/waldo","path":"/qux/thud"}])",
+                 R"({"foo":{"bar":"baz"},"qux":{"corge":"grault","thud":"fred"}})" );
+    check_patch( R"({"foo":["all","grass","cows","eat"]})", R"([{"op":"move","from":"/foo/1","path":"/foo/3"}])", R"({"foo":["all","cows","eat","grass"]})" );
+    check_patch( R"({"baz":"qux","foo":["a",2,"c"]})",
+                 R"([{"op":"test","path":"/baz","value":"qux"},{"op":"test","path":"/foo/1","value":2}])",
+                 R"({"baz":"qux","foo":["a",2,"c"]})" );
+    check_patch( R"({"foo":"bar"})", R"([{"op":"add","path":"/child","value":{"grandchild":{}}}])", R"({"foo":"bar","child":{"grandchild":{}}})" );
+    check_patch( R"({"foo":["bar"]})", R"([{"op":"add","path":"/foo/-","value":["abc","def"]}])", R"({"foo":["bar",["abc","def"]]})" );
+    check_patch( R"({"/":9,"~1":10})", R"([{"op":"test","path":"/~01","value":10},{"op":"copy","from":"/~1","path":"/x"}])", R"({"/":9,"~1":10,"x":9})" );
+    check_patch( R"({"foo":1})", R"([{"op":"replace","path":"","value":[1,2]}])", R"([1,2])" );
+
+    check_patch_error( R"({"baz":"qux"})", R"([{"op":"test","path":"/baz","value":"bar"}])", R"(patch operation 0: test failed for path "/baz")" );
+    check_patch_error( R"({"foo":"bar"})", R"([{"op":"add","path":"/baz/bat","value":"qux"}])", R"(patch operation 0: path "/baz/bat" not found)" );
+    check_patch_error( R"({"foo":[1]})", R"([{"op":"remove","path":"/foo"},{"op":"remove","path":"/foo/0"}])", R"(patch operation 1: path "/foo/0" not found)" );
+    check_patch_error( R"({"foo":[1]})", R"([{"op":"add","path":"/foo/2","value":0}])", R"(patch operation 0: path "/foo/2" has an array index out of range)" );
+    check_patch_error( R"({"foo":[1]})", R"([{"op":"remove","path":"/foo/01"}])", R"(patch operation 0: path "/foo/01" has an invalid array index "01")" );
+    check_patch_error( R"({"foo":1})", R"([{"op":"move","from":"/foo","path":"/foo/bar"}])", R"(patch operation 0: cannot move "/foo" into one of its children)" );
+    check_patch_error( R"({"foo":[1]})", R"([{"op":"move","from":"/foo/0","path":"/foo/1"}])", R"(patch operation 0: path "/foo/1" has an array index out of range)" );
+    check_patch_error( R"({"foo":1})", R"([{"op":"frob","path":"/foo"}])", R"(patch operation 0: unknown operation "frob")" );
+    check_patch_error( R"({"foo":1})", R"([{"op":"add","path":"/foo"}])", R"(patch operation 0: field "value" not found)" );
+    check_patch_error( R"({"foo":1})", R"([{"op":"add","path":"foo","value":1}])", R"(patch operation 0: path "foo" does not start with '/')" );
+    check_patch_error( R"({"foo":1})", R"([1])", "patch operation 0 is not an object" );
+}
+
+TEST( Simple_json_patch_test, test_apply_merge_patch )
+{
+    // examples from RFC 7386 appendix A
+    check_merge_patch( R"({"a":"b"})", R"({"a":"c"})", R"({"a":"c"})" );
+    check_merge_patch( R"({"a":"b"})", R"({"b":"c"})", R"({"a":"b","b":"c"})" );
+    check_merge_patch( R"({"a":"b"})", R"({"a":null})", R"({})" );
+    check_merge_patch( R"({"a":"b","b":"c"})", R"({"a":null})", R"({"b":"c"})" );
+    check_merge_patch( R"({"a":["b"]})", R"({"a":"c"})", R"({"a":"c"})" );
+    check_merge_patch( R"({"a":"c"})", R"({"a":["b"]})", R"({"a":["b"]})" );
+    check_merge_patch( R"({"a":{"b":"c"}})", R"({"a":{"b":"d","c":null}})", R"({"a":{"b":"d"}})" );
+    check_merge_patch( R"({"a":[{"b":"c"}]})", R"({"a":[1]})", R"({"a":[1]})" );
+    check_merge_patch( R"(["a","b"])", R"(["c","d"])", R"(["c","d"])" );
+    check_merge_patch( R"({"a":"b"})", R"(["c"])", R"(["c"])" );
+    check_merge_patch( R"({"a":"foo"})", R"(null)", R"(null)" );
+    check_merge_patch( R"({"a":"foo"})", R"("bar")", R"("bar")" );
+    check_merge_patch( R"({"e":null})", R"({"a":1})", R"({"e":null,"a":1})" );
+    check_merge_patch( R"([1,2])", R"({"a":"b","c":null})", R"({"a":"b"})" );
+    check_merge_patch( R"({})", R"({"a":{"bb":{"ccc":null}}})", R"({"a":{"bb":{}}})" );
+}
+
+TEST( Simple_json_patch_test, test_diff )
+{
+    check_diff( R"({"a":1})", R"({"a":1})", 0 );
+    check_diff( R"({"a":1,"b":2,"c":3})", R"({"a":1,"c":4,"d":5})", 3 );
+    check_diff( R"({"a":{"b":{"c":[1,2,3]}}})", R"({"a":{"b":{"c":[1,9,3]}}})", 1 );
+    check_diff( R"([1,2,3,4,5])", R"([1,2,9,9,4,5])", 2 ); // replace 3, insert a 9
+    check_diff( R"([1,2,3,4,5])", R"([1,5])", 3 );
+    check_diff( R"([1,2,3])", R"([0,1,2,3])", 1 );
+    check_diff( R"([1,2,3])", R"([])", 3 );
+    check_diff( R"({"a":[1]})", R"({"a":{"b":1}})", 1 );
+    check_diff( R"({"a/b":1,"c~d":2})", R"({"a/b":2,"c~d":3})", 2 );
+    check_diff( R"(1)", R"("one")", 1 );
+
+    EXPECT_EQ( Value( diff( parse_ok( R"({"a":1,"b":2})" ), parse_ok( R"({"b":3,"c":4})" ) ) ),
+               parse_ok( R"([{"op":"remove","path":"/a"},{"op":"replace","path":"/b","value":3},{"op":"add","path":"/c","value":4}])" ) );
+
+    EXPECT_EQ( merge_diff( parse_ok( R"({"a":1,"b":{"c":2,"d":3},"e":4})" ), parse_ok( R"({"b":{"c":2,"d":5},"e":4,"f":6})" ) ),
+               parse_ok( R"({"a":null,"b":{"d":5},"f":6})" ) );
+}
+
+TEST( Simple_json_patch_test, test_packed_arrays )
+{
+    const ParseOptions options{ .pack_integer_arrays = true };
+
+    Value value = *parse( R"({"a":[1,2,3]})", options );
+    ASSERT_TRUE( holds_alternative<IntArray>( get<Object>( value ).at( "a" ) ) );
+
+    ASSERT_TRUE( apply_patch( value, get<Array>( parse_ok( R"([{"op":"test","path":"/a","value":[1,2,3]}])" ) ) ) );
+
+    // reading elements, or failing to find something inside one, leaves the array packed
+    ASSERT_TRUE( apply_patch( value, get<Array>( parse_ok( R"([{"op":"test","path":"/a/2","value":3},
+                                                               {"op":"copy","from":"/a/0","path":"/b"}])" ) ) ) );
+    EXPECT_EQ( Value( int64_t( 1 ) ), get<Object>( value ).at( "b" ) );
+    EXPECT_EQ( R"(patch operation 0: path "/a/0/x" not found)",
+               apply_patch( value, get<Array>( parse_ok( R"([{"op":"add","path":"/a/0/x","value":1}])" ) ) ).error() );
+    EXPECT_EQ( R"(patch operation 0: path "/a/3" has an array index out of range)",
+               apply_patch( value, get<Array>( parse_ok( R"([{"op":"replace","path":"/a/3","value":1}])" ) ) ).error() );
+    EXPECT_TRUE( holds_alternative<IntArray>( get<Object>( value ).at( "a" ) ) );
+
+    // changing an element unpacks the array
+    ASSERT_TRUE( apply_patch( value, get<Array>( parse_ok( R"([{"op":"replace","path":"/a/1","value":"two"}])" ) ) ) );
+    EXPECT_EQ( parse_ok( R"({"a":[1,"two",3],"b":1})" ), value );
+
+    // packed and unpacked arrays with the same elements have no differences
+    EXPECT_TRUE( diff( *parse( "[1,2,3]", options ), parse_ok( "[1,2,3]" ) ).empty() );
+    EXPECT_EQ( 1u, diff( *parse( "[1,2,3]", options ), parse_ok( "[1,5,3]" ) ).size() );
+}
+
+TEST( Simple_json_patch_test, test_raw_numbers )
+{
+    // numbers compare as JSON, whether they were kept as text or not
+    Value value = *parse( R"({"a":1,"b":[2,3],"c":4.5})", ParseOptions{ .raw_numbers = true } );
+    ASSERT_TRUE( apply_patch( value, get<Array>( parse_ok( R"([{"op":"test","path":"/a","value":1},{"op":"test","path":"/b","value":[2,3]}])" ) ) ) );
+    EXPECT_FALSE( apply_patch( value, get<Array>( parse_ok( R"([{"op":"test","path":"/a","value":2}])" ) ) ) );
+
+    const Value packed = *parse( R"({"a":1,"b":[2,3],"c":"x"})", ParseOptions{ .pack_integer_arrays = true } );
+    EXPECT_EQ( parse_ok( R"({"c":"x"})" ), merge_diff( value, packed ) );
+}
+
+TEST( Simple_json_patch_test, test_failed_move_keeps_value )
+{
+    // the value removed is put back where it was if it cannot be added at the path
+    for ( const ParseOptions& options : { ParseOptions(), ParseOptions{ .pack_integer_arrays = true, .ordered_objects = true } } )
+    {
+        Value value = *parse( R"({"b":{"x":1,"y":2},"a":[1,2,3]})", options );
+        const Value original = value;
+
+        for ( const char* patch : { R"([{"op":"move","from":"/b/x","path":"/c/x"}])", R"([{"op":"move","from":"/a/1","path":"/a/3"}])",
+                                    R"([{"op":"move","from":"/a/0","path":"/a/x"}])" } )
+        {
+            EXPECT_FALSE( apply_patch( value, get<Array>( parse_ok( patch ) ) ) ) << patch;
+            EXPECT_EQ( original, value ) << patch;
+        }
+
+        // in the same position in an ordered object
+        if ( options.ordered_objects )
+        {
+            EXPECT_EQ( "x", get<OrderedObject>( get<OrderedObject>( value ).find( "b" )->second ).begin()->first );
+        }
+    }
+}
+
+TEST( Simple_json_patch_test, test_ordered_objects )
+{
+    const ParseOptions options{ .ordered_objects = true };
+
+    Value value = *parse( R"({"b":1,"a":{"y":2,"x":3}})", options );
+
+    // patches can themselves be ordered objects
+    ASSERT_TRUE( apply_patch( value, get<Array>( *parse( R"([{"op":"test","path":"","value":{"a":{"x":3,"y":2},"b":1}},
+                                                             {"op":"remove","path":"/a/y"},
+                                                             {"op":"add","path":"/c","value":4},
+                                                             {"op":"replace","path":"/b","value":5}])",
+                                                          options ) ) ) );
+    EXPECT_EQ( *parse( R"({"b":5,"a":{"x":3},"c":4})", options ), value );
+
+    // merge patches keep the members in order, adding new ones at the end
+    apply_merge_patch( value, *parse( R"({"d":6,"b":null,"a":{"w":7}})", options ) );
+    EXPECT_EQ( *parse( R"({"a":{"x":3,"w":7},"c":4,"d":6})", options ), value );
+
+    // ordered and sorted objects with the same members have no differences
+    EXPECT_TRUE( diff( value, parse_ok( R"({"a":{"w":7,"x":3},"c":4,"d":6})" ) ).empty() );
+    EXPECT_EQ( 1u, diff( value, parse_ok( R"({"a":{"w":7,"x":3},"c":4,"d":8})" ) ).size() );
+    EXPECT_EQ( parse_ok( R"({"d":8})" ), merge_diff( value, parse_ok( R"({"a":{"w":7,"x":3},"c":4,"d":8})" ) ) );
+}
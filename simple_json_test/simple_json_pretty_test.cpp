@@ -0,0 +1,122 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_pretty.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    Value parse_ok( const string& json_str )
+    {
+        auto value = parse( json_str );
+        EXPECT_TRUE( value ) << value.error();
+        return value ? *value : Value();
+    }
+} // namespace
+
+TEST( Simple_json_pretty_test, test_fits_on_one_line )
+{
+    EXPECT_EQ( R"({"a" : 1, "b" : [true, null, "x"], "c" : {}})", pretty_print( parse_ok( R"({"a":1,"b":[true,null,"x"],"c":{}})" ) ) );
+    EXPECT_EQ( "[]", pretty_print( Array() ) );
+    EXPECT_EQ( "42", pretty_print( 42 ) );
+}
+
+TEST( Simple_json_pretty_test, test_max_width )
+{
+    const Value value = parse_ok( R"({"name":"a long enough name","ints":[1,2,3,4,5,6,7,8,9,10,11,12],"inner":{"x":[1,2],"y":{"z":null}}})" );
+
+    EXPECT_EQ( "{\n"
+               "  \"inner\" : {\n"
+               "    \"x\" : [1, 2],\n"
+               "    \"y\" : {\"z\" : null}\n"
+               "  },\n"
+               "  \"ints\" : [\n"
+               "    1, 2, 3, 4, 5, 6, 7, 8, 9,\n"
+               "    10, 11, 12\n"
+               "  ],\n"
+               "  \"name\" : \"a long enough name\"\n"
+               "}",
+               pretty_print( value, PrettyOptions{ .max_width = 30, .indent = 2 } ) );
+
+    EXPECT_EQ( value, parse_ok( pretty_print( value, PrettyOptions{ .max_width = 10 } ) ) );
+    EXPECT_EQ( value, parse_ok( pretty_print( value, PrettyOptions{ .max_width = 0 } ) ) );
+}
+
+TEST( Simple_json_pretty_test, test_elision )
+{
+    const PrettyOptions options{ .max_width = 40, .max_elements = 3, .max_string_length = 5 };
+
+    EXPECT_EQ( R"([1, 2, 3, ... (7 more)])", pretty_print( Array{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }, options ) );
+    EXPECT_EQ( R"(["abcde...", "abc"])", pretty_print( Array{ "abcdefgh", "abc" }, options ) );
+    EXPECT_EQ( "{\n"
+               "    \"a\" : 1,\n"
+               "    \"b\" : 2,\n"
+               "    \"c\" : 3,\n"
+               "    ... (1 more)\n"
+               "}",
+               pretty_print( Object{ { "a", 1 }, { "b", 2 }, { "c", 3 }, { "d", 4 } }, options ) );
+
+    EXPECT_EQ( "[\n"
+               "    [\"0000000000...\"],\n"
+               "    [\"0123456789...\"],\n"
+               "    ... (1 more)\n"
+               "]",
+               pretty_print( Array{ Array{ string( 100, '0' ) + "x" }, Array{ "0123456789abc" }, Array() },
+                             PrettyOptions{ .max_width = 30, .max_elements = 2, .max_string_length = 10 } ) );
+}
+
+TEST( Simple_json_pretty_test, test_deep_nesting )
+{
+    // deeper than the precomputed run of spaces
+    Value value = 1;
+    for ( int i = 0; i < 40; ++i )
+    {
+        value = Array{ std::move( value ), "padding to stop the array fitting on a line" };
+    }
+
+    const string pretty = pretty_print( value );
+    EXPECT_NE( string::npos, pretty.find( "\n" + string( 40 * 4, ' ' ) + "1,\n" ) );
+    EXPECT_EQ( value, parse_ok( pretty ) );
+}
+
+TEST( Simple_json_pretty_test, test_ordered_objects )
+{
+    const auto value = parse( R"({"b":1,"a":2})", ParseOptions{ .ordered_objects = true } );
+    EXPECT_EQ( R"({"b" : 1, "a" : 2})", pretty_print( *value ) );
+}
+
+// run with --gtest_also_run_disabled_tests to compare pretty printing a large document with operator<<
+TEST( DISABLED_Simple_json_pretty_test, test_pretty_print_speed )
+{
+    Array records;
+    for ( int i = 0; i < 200000; ++i )
+    {
+        records.push_back( Object{ { "id", i },
+                                   { "message", "request " + to_string( i ) + " completed" },
+                                   { "samples", Array{ 1, 2, 3, 4, 5, 6, 7, 8 } },
+                                   { "context", Object{ { "host", "h" }, { "tags", Array{ Object{ { "k", "v" } } } } } } } );
+    }
+    const Value value = std::move( records );
+
+    auto start = chrono::steady_clock::now();
+    ostringstream os;
+    os << value;
+    const auto format_time = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    const string pretty = pretty_print( value );
+    const auto pretty_time = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    const string elided = pretty_print( value, PrettyOptions{ .max_elements = 10, .max_string_length = 20 } );
+    const auto elided_time = chrono::steady_clock::now() - start;
+
+    cout << "operator<< " << chrono::duration_cast<chrono::milliseconds>( format_time ) << ", " << os.str().size() / 1000000 << " MB\n"
+         << "pretty     " << chrono::duration_cast<chrono::milliseconds>( pretty_time ) << ", " << pretty.size() / 1000000 << " MB\n"
+         << "elided     " << chrono::duration_cast<chrono::milliseconds>( elided_time ) << ", " << elided.size() << " bytes\n";
+}
@@ -0,0 +1,173 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+//
+// Checks that parsing and formatting take allocations, and time, in proportion to the size of the input,
+// for inputs designed to expose super-linear behaviour that could be used for denial of service. Only the
+// allocations are checked by default, as they are deterministic.
+
+#include "adversarial_inputs.h"
+#include "allocation_counter.h"
+#include "simple_json.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    struct Cost
+    {
+        size_t size = 0; // of the input to a parse, or of the output of a format
+        size_t allocations = 0;
+        size_t allocated_bytes = 0;
+        double seconds = 0; // the fastest of several runs, if timed
+    };
+
+    template <typename Function>
+    Cost measure( size_t size, Function function, bool timed )
+    {
+        Cost cost;
+        cost.size = size;
+
+        const AllocationCounts start = AllocationCounts::now();
+        function();
+        const AllocationCounts used = AllocationCounts::now() - start;
+
+        cost.allocations = used.allocations;
+        cost.allocated_bytes = used.bytes;
+
+        if ( !timed )
+        {
+            return cost;
+        }
+
+        // repeat to get a stable time, at least 5 runs and 2 ms
+        cost.seconds = 1e9;
+        const auto deadline = chrono::steady_clock::now() + chrono::milliseconds( 2 );
+        for ( int run = 0; run < 5 || chrono::steady_clock::now() < deadline; ++run )
+        {
+            const auto run_start = chrono::steady_clock::now();
+            function();
+            cost.seconds = std::min( cost.seconds, chrono::duration<double>( chrono::steady_clock::now() - run_start ).count() );
+        }
+
+        return cost;
+    }
+
+    string format( const Value& value )
+    {
+        ostringstream os;
+        os << value;
+        return os.str();
+    }
+
+    // The costs of parsing an input, and of formatting it if it is valid. Parsing is measured against the size of
+    // the input and formatting against the size of the output, as pretty printing nested values adds indentation
+    // that grows with the square of the depth.
+    //
+    struct Costs
+    {
+        Cost parse;
+        optional<Cost> format;
+    };
+
+    Costs measure( const string& json_str, bool timed )
+    {
+        Costs costs;
+        costs.parse = measure( json_str.size(), [ & ]() { (void)parse( json_str ); }, timed );
+
+        if ( const auto value = parse( json_str ) )
+        {
+            const string formatted = format( *value );
+            EXPECT_EQ( *value, parse( formatted ) ) << formatted; // the round trip gives the same value
+
+            costs.format = measure( formatted.size(), [ & ]() { (void)format( *value ); }, timed );
+        }
+
+        return costs;
+    }
+
+    // The sizes at which each input is measured. Nesting is limited by the recursion of the parser and formatter.
+    const size_t small_size = 64;
+    const size_t growth = 16;
+
+    // Limits on how much faster than the input the costs may grow. Allocations are deterministic so the limit is tight,
+    // time is noisy but a quadratic cost would still grow "growth" times more than a linear one.
+    const double allocation_slack = 1.5;
+    const double time_slack = 4.0;
+
+    // checks the allocations, allowing for a fixed number that do not depend on the size
+    //
+    void check_linear( const Cost& small, const Cost& large, const string& what )
+    {
+        const double size_ratio = double( large.size ) / small.size;
+
+        EXPECT_LE( large.allocations, ( small.allocations + 4 ) * size_ratio * allocation_slack ) << what;
+        EXPECT_LE( large.allocated_bytes, ( small.allocated_bytes + 256 ) * size_ratio * allocation_slack ) << what;
+    }
+
+    // checks the times, allowing for a fixed time that does not depend on the size
+    //
+    void check_time_linear( const Cost& small, const Cost& large, const string& what )
+    {
+        const double size_ratio = double( large.size ) / small.size;
+
+        EXPECT_LE( large.seconds, ( small.seconds + 1e-6 ) * size_ratio * time_slack ) << what;
+    }
+
+    // measures each input at two sizes and checks the costs with a check function
+    //
+    void check_inputs( bool timed, void ( *check )( const Cost&, const Cost&, const string& ) )
+    {
+        for ( const AdversarialInput& input : adversarial_inputs() )
+        {
+            const Costs small = measure( input.generate( small_size ), timed );
+            const Costs large = measure( input.generate( small_size * growth ), timed );
+
+            check( small.parse, large.parse, "parse " + string( input.name ) );
+
+            ASSERT_EQ( small.format.has_value(), large.format.has_value() );
+            if ( small.format )
+            {
+                check( *small.format, *large.format, "format " + string( input.name ) );
+            }
+        }
+    }
+
+    void print( const Cost& cost, const char* what )
+    {
+        cout << "    " << what << " " << cost.size << " bytes: " << cost.allocations << " allocations, " << cost.allocated_bytes << " bytes allocated, "
+             << cost.seconds * 1e6 << " us\n";
+    }
+} // namespace
+
+TEST( Simple_json_scaling_test, test_costs_grow_linearly )
+{
+    check_inputs( false, check_linear );
+}
+
+// run with --gtest_also_run_disabled_tests to check the times too, which depend on the machine being otherwise idle
+TEST( DISABLED_Simple_json_scaling_test, test_times_grow_linearly )
+{
+    check_inputs( true, check_time_linear );
+}
+
+// run with --gtest_also_run_disabled_tests to see the costs of each input at increasing sizes
+TEST( DISABLED_Simple_json_scaling_test, test_costs )
+{
+    for ( const AdversarialInput& input : adversarial_inputs() )
+    {
+        cout << input.name << "\n";
+        for ( size_t n = small_size; n <= small_size * growth * growth / 4; n *= 2 )
+        {
+            const Costs costs = measure( input.generate( n ), true );
+            print( costs.parse, "parse " );
+            if ( costs.format )
+            {
+                print( *costs.format, "format" );
+            }
+        }
+    }
+}
@@ -0,0 +1,219 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_schema.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    Value parse_ok( const string& json_str )
+    {
+        auto value = parse( json_str );
+        EXPECT_TRUE( value ) << value.error();
+        return value ? *value : Value();
+    }
+
+    Schema compile_ok( const string& schema_str )
+    {
+        auto schema = Schema::compile( parse_ok( schema_str ) );
+        EXPECT_TRUE( schema ) << schema.error();
+        return *schema;
+    }
+
+    void check_valid( const Schema& schema, const string& json_str )
+    {
+        auto result = schema.validate( parse_ok( json_str ) );
+        EXPECT_TRUE( result ) << json_str << ": " << result.error();
+    }
+
+    void check_invalid( const Schema& schema, const string& json_str, const string& expected_error )
+    {
+        auto result = schema.validate( parse_ok( json_str ) );
+        ASSERT_FALSE( result ) << json_str;
+        EXPECT_EQ( result.error(), expected_error );
+    }
+
+    const string student_schema = R"({
+        "type" : "object",
+        "required" : [ "name", "age", "grades" ],
+        "properties" : {
+            "name" : { "type" : "string", "minLength" : 1, "maxLength" : 20 },
+            "age" : { "type" : "integer", "minimum" : 0, "maximum" : 150 },
+            "grades" : { "type" : "array", "maxItems" : 5, "items" : { "type" : "integer", "minimum" : 0, "maximum" : 100 } },
+            "year" : { "enum" : [ "first", "second", 3 ] },
+            "notes" : { "type" : [ "string", "null" ] }
+        },
+        "additionalProperties" : false
+    })";
+} // namespace
+
+TEST( Simple_json_schema_test, test_validate )
+{
+    const Schema schema = compile_ok( student_schema );
+
+    check_valid( schema, R"({"name":"Bob","age":21,"grades":[55,69,64]})" );
+    check_valid( schema, R"({"name":"Bob","age":21,"grades":[],"year":3,"notes":null})" );
+    check_valid( schema, R"({"name":"Bob","age":21,"grades":[],"year":"second","notes":"none"})" );
+
+    check_invalid( schema, "[1,2,3]", R"(value at "" is not of type object)" );
+    check_invalid( schema, R"({"name":"Bob","grades":[55,69,64]})", R"(object at "" is missing required field "age")" );
+    check_invalid( schema, R"({"name":"Bob","age":21})", R"(object at "" is missing required field "grades")" );
+    check_invalid( schema, R"({"name":1234,"age":21,"grades":[]})", R"(value at "/name" is not of type string)" );
+    check_invalid( schema, R"({"name":"","age":21,"grades":[]})", R"(string at "/name" is shorter than 1)" );
+    check_invalid( schema, R"({"name":"Bob","age":-1,"grades":[]})", R"(value at "/age" is less than the minimum 0)" );
+    check_invalid( schema, R"({"name":"Bob","age":151,"grades":[]})", R"(value at "/age" is greater than the maximum 150)" );
+    check_invalid( schema, R"({"name":"Bob","age":21,"grades":[55,"foo",64]})", R"(value at "/grades/1" is not of type integer)" );
+    check_invalid( schema, R"({"name":"Bob","age":21,"grades":[55,101]})", R"(value at "/grades/1" is greater than the maximum 100)" );
+    check_invalid( schema, R"({"name":"Bob","age":21,"grades":[1,2,3,4,5,6]})", R"(array at "/grades" has more than 5 items)" );
+    check_invalid( schema, R"({"name":"Bob","age":21,"grades":[],"year":4})", R"(value at "/year" is not one of the enumerated values)" );
+    check_invalid( schema, R"({"name":"Bob","age":21,"grades":[],"notes":true})", R"(value at "/notes" is not of type string or null)" );
+    check_invalid( schema, R"({"name":"Bob","age":21,"grades":[],"extra":1})", R"(object at "" has unexpected field "extra")" );
+}
+
+TEST( Simple_json_schema_test, test_validate_packed_arrays )
+{
+    const Schema schema = compile_ok( student_schema );
+
+    auto validate_packed = [ & ]( const string& json_str ) {
+        const auto value = parse( json_str, ParseOptions{ .pack_integer_arrays = true } );
+        EXPECT_TRUE( holds_alternative<IntArray>( get<Object>( *value ).at( "grades" ) ) );
+        return schema.validate( *value );
+    };
+
+    EXPECT_TRUE( validate_packed( R"({"name":"Bob","age":21,"grades":[55,69,64]})" ) );
+    EXPECT_EQ( R"(value at "/grades/1" is greater than the maximum 100)", validate_packed( R"({"name":"Bob","age":21,"grades":[55,101]})" ).error() );
+    EXPECT_EQ( R"(array at "/grades" has more than 5 items)", validate_packed( R"({"name":"Bob","age":21,"grades":[1,2,3,4,5,6]})" ).error() );
+}
+
+TEST( Simple_json_schema_test, test_validate_raw_numbers )
+{
+    const Schema schema = compile_ok( student_schema );
+
+    auto validate_raw = [ & ]( const string& json_str ) {
+        const auto value = parse( json_str, ParseOptions{ .raw_numbers = true } );
+        EXPECT_TRUE( holds_alternative<RawNumber>( get<Object>( *value ).at( "age" ) ) );
+        return schema.validate( *value );
+    };
+
+    EXPECT_TRUE( validate_raw( R"({"name":"Bob","age":21,"grades":[55,100,0]})" ) );
+    EXPECT_EQ( R"(value at "/grades/1" is greater than the maximum 100)", validate_raw( R"({"name":"Bob","age":21,"grades":[55,101]})" ).error() );
+    EXPECT_EQ( R"(value at "/age" is greater than the maximum 150)",
+               validate_raw( R"({"name":"Bob","age":100000000000000000000000,"grades":[]})" ).error() );
+
+    // numbers with a fraction or exponent are not integers
+    EXPECT_EQ( R"(value at "/grades/1" is not of type integer)", validate_raw( R"({"name":"Bob","age":21,"grades":[55,2.5]})" ).error() );
+    EXPECT_EQ( R"(value at "/age" is not of type integer)", validate_raw( R"({"name":"Bob","age":2e1,"grades":[]})" ).error() );
+
+    const Schema numbers = compile_ok( R"({"type":"array","items":{"type":"number","minimum":0,"maximum":100}})" );
+    const auto validate_numbers = [ & ]( const string& json_str ) { return numbers.validate( *parse( json_str, ParseOptions{ .raw_numbers = true } ) ); };
+
+    EXPECT_TRUE( validate_numbers( "[55.5,100.0,0,1e2]" ) );
+    EXPECT_TRUE( validate_numbers( "[1e-400,-1e-400]" ) );
+    EXPECT_TRUE( numbers.validate( parse_ok( "[1,2]" ) ) );
+    EXPECT_EQ( R"(value at "/1" is greater than the maximum 100)", validate_numbers( "[55,100.5]" ).error() );
+    EXPECT_EQ( R"(value at "/0" is less than the minimum 0)", validate_numbers( "[-1e-9]" ).error() );
+    EXPECT_EQ( R"(value at "/0" is not of type number)", validate_numbers( R"(["1"])" ).error() );
+}
+
+TEST( Simple_json_schema_test, test_empty_schema )
+{
+    // a default constructed or moved from schema accepts everything, like {}
+    check_valid( Schema(), R"({"a":[1,"b",null]})" );
+
+    Schema schema = compile_ok( R"({"type":"string"})" );
+    const Schema moved = std::move( schema );
+    check_invalid( moved, "1", R"(value at "" is not of type string)" );
+    check_valid( schema, "1" );
+    check_valid( compile_ok( "{}" ), "1" );
+}
+
+TEST( Simple_json_schema_test, test_compile_errors )
+{
+    auto check_error = []( const string& schema_str, const string& expected_error ) {
+        auto schema = Schema::compile( parse_ok( schema_str ) );
+        ASSERT_FALSE( schema );
+        EXPECT_EQ( schema.error(), expected_error );
+    };
+
+    check_error( "[]", R"(schema at "" is not an object)" );
+    check_error( R"({"type":"float"})", R"(unknown type "float" in schema at "")" );
+    check_error( R"({"type":1})", R"("type" of schema at "" is not a string or array of strings)" );
+    check_error( R"({"properties":{"a":{"minLength":-1}}})", R"("minLength" of schema at "/properties/a" is not a non-negative integer)" );
+    check_error( R"({"items":{"maximum":"x"}})", R"("maximum" of schema at "/items" is not an integer)" );
+    check_error( R"({"required":["a",1]})", R"("required" of schema at "" contains a value that is not a string)" );
+    check_error( R"({"additionalProperties":{}})", R"("additionalProperties" of schema at "" is not a boolean)" );
+    check_error( R"({"enum":1})", R"("enum" of schema at "" is not an array)" );
+}
+
+TEST( DISABLED_Simple_json_schema_test, test_validate_speed )
+{
+    const Schema schema = compile_ok( R"({"type":"array","items":)" + student_schema + "}" );
+
+    Array students;
+    for ( int i = 0; i < 1000000; ++i )
+    {
+        students.push_back( Object{ { "name", "student " + std::to_string( i ) }, { "age", i % 100 }, { "grades", Array{ 55, 69, 64 } }, { "year", "first" } } );
+    }
+    const Value value = std::move( students );
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = schema.validate( value );
+    const auto end = std::chrono::steady_clock::now();
+
+    ASSERT_TRUE( result ) << result.error();
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>( end - start );
+    cout << "validate time " << ms << ", " << 1000000 / std::max<int64_t>( 1, ms.count() ) << " objects/ms" << endl;
+}
+
+TEST( Simple_json_schema_test, test_validate_ordered_objects )
+{
+    const Schema schema = compile_ok( student_schema );
+
+    auto validate_ordered = [ & ]( const string& json_str ) {
+        const auto value = parse( json_str, ParseOptions{ .ordered_objects = true } );
+        EXPECT_TRUE( holds_alternative<OrderedObject>( *value ) );
+        return schema.validate( *value );
+    };
+
+    EXPECT_TRUE( validate_ordered( R"({"name":"Bob","grades":[55,69,64],"age":21})" ) );
+    EXPECT_EQ( R"(object at "" is missing required field "age")", validate_ordered( R"({"name":"Bob","grades":[]})" ).error() );
+    EXPECT_EQ( R"(value at "/age" is greater than the maximum 150)", validate_ordered( R"({"name":"Bob","grades":[],"age":151})" ).error() );
+    EXPECT_EQ( R"(object at "" has unexpected field "extra")", validate_ordered( R"({"name":"Bob","extra":1,"age":21,"grades":[]})" ).error() );
+}
+
+TEST( Simple_json_schema_test, test_compile_ordered_objects )
+{
+    const auto schema = Schema::compile( *parse( student_schema, ParseOptions{ .ordered_objects = true } ) );
+    ASSERT_TRUE( schema ) << schema.error();
+
+    check_valid( *schema, R"({"name":"Bob","age":21,"grades":[55,69,64]})" );
+    check_invalid( *schema, R"({"name":"Bob","grades":[]})", R"(object at "" is missing required field "age")" );
+    check_invalid( *schema, R"({"name":"Bob","age":21,"grades":[],"year":4})", R"(value at "/year" is not one of the enumerated values)" );
+    check_invalid( *schema, R"({"name":"Bob","age":21,"grades":[],"extra":1})", R"(object at "" has unexpected field "extra")" );
+}
+
+TEST( Simple_json_schema_test, test_compile_packed_arrays )
+{
+    const auto schema = Schema::compile( *parse( R"({"type":"array","items":{"enum":[1,2,3]},"required":[]})", ParseOptions{ .pack_integer_arrays = true } ) );
+    ASSERT_TRUE( schema ) << schema.error();
+
+    check_valid( *schema, "[1,3,2]" );
+    check_invalid( *schema, "[1,4]", R"(value at "/1" is not one of the enumerated values)" );
+}
+
+TEST( Simple_json_schema_test, test_compile_raw_numbers )
+{
+    const auto schema = Schema::compile( *parse( R"({"type":"integer","minimum":0,"maximum":10})", ParseOptions{ .raw_numbers = true } ) );
+    ASSERT_TRUE( schema ) << schema.error();
+
+    check_valid( *schema, "10" );
+    check_invalid( *schema, "11", R"(value at "" is greater than the maximum 10)" );
+
+    const auto not_integer = Schema::compile( *parse( R"({"maxLength":1.5})", ParseOptions{ .raw_numbers = true } ) );
+    ASSERT_FALSE( not_integer );
+    EXPECT_EQ( not_integer.error(), R"("maxLength" of schema at "" is not a non-negative integer)" );
+}
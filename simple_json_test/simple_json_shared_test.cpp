@@ -0,0 +1,135 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "allocation_counter.h"
+#include "simple_json_shared.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    string to_string( const SharedValue& value )
+    {
+        ostringstream os;
+        os << to_value( value );
+        return os.str();
+    }
+
+    SharedValue make_config()
+    {
+        auto value = parse( R"({"servers":[{"host":"a","port":80},{"host":"b","port":81}],"timeouts":{"read":10,"write":20}})" );
+        return to_shared( *value );
+    }
+} // namespace
+
+TEST( Simple_json_shared_test, test_copies_share_structure )
+{
+    const SharedValue config = make_config();
+
+    const AllocationCounts start = AllocationCounts::now();
+    const SharedValue copy = config;
+    EXPECT_EQ( ( AllocationCounts::now() - start ).allocations, 0 );
+
+    EXPECT_TRUE( copy.shares_node_with( config ) );
+    EXPECT_EQ( to_string( copy ), to_string( config ) );
+}
+
+TEST( Simple_json_shared_test, test_set )
+{
+    const SharedValue config = make_config();
+    const string original = to_string( config );
+
+    auto modified = config.set( { "servers", size_t{ 1 }, "port" }, SharedValue( int64_t{ 8081 } ) );
+    ASSERT_TRUE( modified );
+
+    // the original is unchanged
+    EXPECT_EQ( to_string( config ), original );
+
+    const SharedValue* port = modified->find( { "servers", size_t{ 1 }, "port" } );
+    ASSERT_TRUE( port );
+    EXPECT_EQ( *port->get_if<int64_t>(), 8081 );
+
+    // only the containers along the path were copied
+    EXPECT_FALSE( modified->shares_node_with( config ) );
+    EXPECT_FALSE( modified->find( { "servers" } )->shares_node_with( *config.find( { "servers" } ) ) );
+    EXPECT_FALSE( modified->find( { "servers", size_t{ 1 } } )->shares_node_with( *config.find( { "servers", size_t{ 1 } } ) ) );
+    EXPECT_TRUE( modified->find( { "servers", size_t{ 0 } } )->shares_node_with( *config.find( { "servers", size_t{ 0 } } ) ) );
+    EXPECT_TRUE( modified->find( { "timeouts" } )->shares_node_with( *config.find( { "timeouts" } ) ) );
+
+    // adding members and elements
+    auto added = modified->set( { "timeouts", "connect" }, SharedValue( int64_t{ 5 } ) );
+    ASSERT_TRUE( added );
+    added = added->set( { "servers", size_t{ 2 } }, SharedValue( "c" ) );
+    ASSERT_TRUE( added );
+    EXPECT_EQ( to_string( *added ), "{\n"
+                                     "    \"servers\" : [\n"
+                                     "        {\n"
+                                     "            \"host\" : \"a\",\n"
+                                     "            \"port\" : 80\n"
+                                     "        }, {\n"
+                                     "            \"host\" : \"b\",\n"
+                                     "            \"port\" : 8081\n"
+                                     "        }, \"c\"\n"
+                                     "    ],\n"
+                                     "    \"timeouts\" : {\n"
+                                     "        \"connect\" : 5,\n"
+                                     "        \"read\" : 10,\n"
+                                     "        \"write\" : 20\n"
+                                     "    }\n"
+                                     "}" );
+
+    EXPECT_EQ( config.set( { "servers", size_t{ 3 } }, SharedValue() ).error(), "index 3 is out of range" );
+    EXPECT_EQ( config.set( { "missing", "x" }, SharedValue() ).error(), "field \"missing\" not found" );
+    EXPECT_EQ( config.set( { "timeouts", size_t{ 0 } }, SharedValue() ).error(), "cannot get index 0 of a value that is not an array" );
+    EXPECT_EQ( config.set( { "servers", "x" }, SharedValue() ).error(), "cannot get field \"x\" of a value that is not an object" );
+}
+
+TEST( Simple_json_shared_test, test_erase )
+{
+    const SharedValue config = make_config();
+
+    auto erased = config.erase( { "servers", size_t{ 0 } } );
+    ASSERT_TRUE( erased );
+    erased = erased->erase( { "timeouts", "read" } );
+    ASSERT_TRUE( erased );
+
+    EXPECT_EQ( to_string( *erased ), to_string( to_shared( *parse( R"({"servers":[{"host":"b","port":81}],"timeouts":{"write":20}})" ) ) ) );
+    EXPECT_EQ( config.erase( { "timeouts", "connect" } ).error(), "field \"connect\" not found" );
+    EXPECT_EQ( config.erase( {} ).error(), "cannot erase the root value" );
+
+    const auto timeouts = get_value<SharedObject>( *config.get_if<SharedObject>(), "timeouts" );
+    ASSERT_TRUE( timeouts );
+    EXPECT_EQ( timeouts->get().size(), 2 );
+}
+
+TEST( Simple_json_shared_test, test_concurrent_readers )
+{
+    SharedValue config = make_config();
+
+    vector<thread> threads;
+    for ( int i = 0; i < 4; ++i )
+    {
+        threads.emplace_back( [ snapshot = config ]() {
+            for ( int j = 0; j < 1000; ++j )
+            {
+                const SharedValue copy = snapshot;
+                EXPECT_EQ( *copy.find( { "servers", size_t{ 1 }, "port" } )->get_if<int64_t>(), 81 );
+            }
+        } );
+    }
+
+    // new versions can be made while the snapshots are being read
+    for ( int j = 0; j < 1000; ++j )
+    {
+        config = *config.set( { "servers", size_t{ 1 }, "port" }, SharedValue( int64_t{ j } ) );
+    }
+
+    for ( thread& t : threads )
+    {
+        t.join();
+    }
+}
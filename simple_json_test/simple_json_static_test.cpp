@@ -0,0 +1,75 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "simple_json_static.h"
+#include <gtest/gtest.h>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    constexpr auto config = parse_static<R"(
+        {
+            "name" : "server \"one\"",
+            "port" : 8080,
+            "offset" : -9223372036854775808,
+            "secure" : true,
+            "proxy" : null,
+            "hosts" : [ "a", "b", [], {} ],
+            "limits" : { "connections" : 100, "timeout" : 30 },
+            "port" : 1
+        })">();
+
+    // a malformed literal, e.g. parse_static<R"({"a" 1})">(), fails to compile with a call to malformed_json_literal()
+
+    static_assert( get_value<int64_t>( config.object(), "port" ) == 8080 );
+    static_assert( get_value<string_view>( config.object(), "name" ) == "server \"one\"" );
+    static_assert( get_value<int64_t>( config.object(), "offset" ) == numeric_limits<int64_t>::min() );
+    static_assert( get_value<bool>( config.object(), "secure" ) == true );
+    static_assert( get_value<Null>( config.object(), "proxy" ).has_value() );
+    static_assert( !get_value<int64_t>( config.object(), "missing" ) );
+    static_assert( !get_value<bool>( config.object(), "port" ) );
+
+    constexpr StaticArray hosts = *get_value<StaticArray>( config.object(), "hosts" );
+    static_assert( hosts.size() == 4 && hosts[ 1 ].get_if<string_view>() == "b" );
+
+    constexpr StaticObject limits = *get_value<StaticObject>( config.object(), "limits" );
+    static_assert( get_value<int64_t>( limits, "timeout" ) == 30 );
+} // namespace
+
+TEST( Simple_json_static_test, test_get_value )
+{
+    const StaticObject obj = config.object();
+
+    EXPECT_EQ( 8, obj.size() );
+    EXPECT_EQ( "server \"one\"", get_value<string_view>( obj, "name" ) );
+    EXPECT_EQ( 8080, get_value<int64_t>( obj, "port" ) );
+
+    EXPECT_EQ( "field \"missing\" not found", get_value<int64_t>( obj, "missing" ).error() );
+    EXPECT_EQ( "field \"port\" is not the expected type", get_value<string>( Object{ { "port", 1 } }, "port" ).error() );
+    EXPECT_EQ( "field \"port\" is not the expected type", get_value<string_view>( obj, "port" ).error() );
+
+    const StaticArray hosts = *get_value<StaticArray>( obj, "hosts" );
+    EXPECT_EQ( "b", hosts[ 1 ].get_if<string_view>() );
+    EXPECT_TRUE( hosts[ 2 ].get_if<StaticArray>()->empty() );
+    EXPECT_TRUE( hosts[ 3 ].get_if<StaticObject>()->empty() );
+    EXPECT_FALSE( hosts[ 3 ].get_if<StaticArray>() );
+
+    vector<string_view> names;
+    for ( const auto& [ name, value ] : obj )
+    {
+        names.push_back( name );
+    }
+    EXPECT_EQ( ( vector<string_view>{ "name", "port", "offset", "secure", "proxy", "hosts", "limits", "port" } ), names );
+}
+
+TEST( Simple_json_static_test, test_to_value )
+{
+    const auto json = R"({"a":[1,-2,"x\n",true,false,null,[[]],{"b":{}}],"c":"\/\\","a":0})";
+
+    EXPECT_EQ( *parse( json ), to_value( parse_static<R"({"a":[1,-2,"x\n",true,false,null,[[]],{"b":{}}],"c":"\/\\","a":0})">().root() ) );
+    EXPECT_EQ( Value( 42 ), to_value( parse_static<" 42 ">().root() ) );
+    EXPECT_EQ( Value( "" ), to_value( parse_static<R"("")">().root() ) );
+    EXPECT_EQ( Value( Array() ), to_value( parse_static<"[ ]">().root() ) );
+}
@@ -0,0 +1,336 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "allocation_counter.h"
+#include "simple_json_tape.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+using namespace simple_json;
+using namespace std;
+
+namespace
+{
+    const string config_json = R"(
+        {
+            "name" : "server \"one\"",
+            "port" : 8080,
+            "offset" : -9223372036854775808,
+            "secure" : true,
+            "proxy" : null,
+            "hosts" : [ "a", "b", [], {} ],
+            "limits" : { "connections" : 100, "timeout" : 30 },
+            "port" : 1
+        })";
+
+    // sums the integers and string lengths of a value, visiting every value
+    //
+    int64_t sum( const Value& value )
+    {
+        return visit(
+            []( const auto& v ) -> int64_t {
+                using T = decay_t<decltype( v )>;
+                if constexpr ( is_same_v<T, int64_t> )
+                {
+                    return v;
+                }
+                else if constexpr ( is_same_v<T, string> )
+                {
+                    return v.size();
+                }
+                else if constexpr ( is_same_v<T, Array> )
+                {
+                    int64_t total = 0;
+                    for ( const Value& element : v )
+                    {
+                        total += sum( element );
+                    }
+                    return total;
+                }
+                else if constexpr ( is_same_v<T, Object> )
+                {
+                    int64_t total = 0;
+                    for ( const auto& [ name, member_value ] : v )
+                    {
+                        total += name.size() + sum( member_value );
+                    }
+                    return total;
+                }
+                else
+                {
+                    return 0;
+                }
+            },
+            value );
+    }
+
+    int64_t sum( const TapeValue& value )
+    {
+        if ( const auto i = value.get_if<int64_t>() )
+        {
+            return *i;
+        }
+        if ( const auto s = value.get_if<string_view>() )
+        {
+            return s->size();
+        }
+        int64_t total = 0;
+        if ( const auto arr = value.get_if<TapeArray>() )
+        {
+            for ( const TapeValue element : *arr )
+            {
+                total += sum( element );
+            }
+        }
+        else if ( const auto obj = value.get_if<TapeObject>() )
+        {
+            for ( const auto& [ name, member_value ] : *obj )
+            {
+                total += name.size() + sum( member_value );
+            }
+        }
+        return total;
+    }
+} // namespace
+
+TEST( Simple_json_tape_test, test_navigate )
+{
+    const auto document = parse_tape( config_json );
+    ASSERT_TRUE( document ) << document.error();
+
+    const TapeObject obj = *document->root().get_if<TapeObject>();
+
+    EXPECT_EQ( 8, obj.size() );
+    EXPECT_EQ( "server \"one\"", get_value<string_view>( obj, "name" ) );
+    EXPECT_EQ( 8080, get_value<int64_t>( obj, "port" ) ); // the first of the duplicates
+    EXPECT_EQ( numeric_limits<int64_t>::min(), get_value<int64_t>( obj, "offset" ) );
+    EXPECT_EQ( true, get_value<bool>( obj, "secure" ) );
+    EXPECT_TRUE( get_value<Null>( obj, "proxy" ) );
+
+    EXPECT_EQ( "field \"missing\" not found", get_value<int64_t>( obj, "missing" ).error() );
+    EXPECT_EQ( "field \"port\" is not the expected type", get_value<string_view>( obj, "port" ).error() );
+
+    const TapeArray hosts = *get_value<TapeArray>( obj, "hosts" );
+    EXPECT_EQ( 4, hosts.size() );
+    EXPECT_EQ( "b", hosts[ 1 ].get_if<string_view>() );
+    EXPECT_TRUE( hosts[ 2 ].get_if<TapeArray>()->empty() );
+    EXPECT_TRUE( hosts[ 3 ].get_if<TapeObject>()->empty() );
+    EXPECT_FALSE( hosts[ 3 ].get_if<TapeArray>() );
+
+    EXPECT_EQ( 30, get_value<int64_t>( *get_value<TapeObject>( obj, "limits" ), "timeout" ) );
+
+    vector<string_view> names;
+    for ( const auto& [ name, value ] : obj )
+    {
+        names.push_back( name );
+    }
+    EXPECT_EQ( ( vector<string_view>{ "name", "port", "offset", "secure", "proxy", "hosts", "limits", "port" } ), names );
+}
+
+TEST( Simple_json_tape_test, test_to_value )
+{
+    for ( const string& json : { config_json, string( R"({"a":[1,-2,"x\n",true,false,null,[[]],{"b":{}}],"c":"\/\\","a":0})" ), string( " 42 " ),
+                                string( R"("")" ), string( "[ ]" ) } )
+    {
+        const auto document = parse_tape( json );
+        ASSERT_TRUE( document ) << document.error();
+        EXPECT_EQ( *parse( json ), to_value( document->root() ) ) << json;
+    }
+}
+
+TEST( Simple_json_tape_test, test_errors )
+{
+    // the same errors as parse()
+    for ( const string json : { "[1,\n {\"a\" 1}]", "[1,]", "[1", "[\"ab", "[1] x", "[\"\\q\"]", "", "{\"a\":}", "[1.5]", "[tru]", "{\"a\":1", "{1}" } )
+    {
+        EXPECT_EQ( parse( json ).error(), parse_tape( json ).error() ) << json;
+    }
+
+    for ( const ParseOptions& options : { ParseOptions{ .max_depth = 2 }, ParseOptions{ .max_string_bytes = 2 }, ParseOptions{ .max_container_elements = 2 } } )
+    {
+        const string json = R"([1,["abc",[2]],3])";
+        EXPECT_EQ( parse( json, options ).error(), parse_tape( json, options ).error() );
+    }
+
+    // the budget applies to the capacities of the tape and string buffer
+    EXPECT_TRUE( parse_tape( "[1,2,3]", ParseOptions{ .max_memory = 256 } ) );
+    const auto over_budget = parse_tape( "[[1,2,3,4,5,6,7]]", ParseOptions{ .max_memory = 100 } );
+    ASSERT_FALSE( over_budget );
+    EXPECT_TRUE( over_budget.error().starts_with( "memory budget of 100 bytes exceeded at line 1 column " ) ) << over_budget.error();
+
+    // failing as soon as the tape outgrows the budget, not at the end of an array of scalars
+    for ( const string_view scalar : { "1", "true", "null" } )
+    {
+        string json = "[" + string( scalar );
+        for ( int i = 0; i < 100000; ++i )
+        {
+            json.append( "," ).append( scalar );
+        }
+        json += "]";
+        const auto long_array = parse_tape( json, ParseOptions{ .max_memory = 1000 } );
+        ASSERT_FALSE( long_array );
+        EXPECT_LT( stoi( long_array.error().substr( long_array.error().rfind( ' ' ) ) ), 1000 ) << long_array.error();
+    }
+
+    // and a long string or member name fails as it passes the budget, not once it has been read
+    for ( const string& json : { "[\"" + string( 100000, 'x' ) + "\"]", "{\"" + string( 100000, 'x' ) + "\":1}" } )
+    {
+        const auto long_string = parse_tape( json, ParseOptions{ .max_memory = 1000 } );
+        ASSERT_FALSE( long_string );
+        EXPECT_LT( stoi( long_string.error().substr( long_string.error().rfind( ' ' ) ) ), 1000 ) << long_string.error();
+    }
+}
+
+TEST( Simple_json_tape_test, test_buffers_are_recycled )
+{
+    const string json = R"({"id":1,"tags":["a","b"],"ok":true})";
+
+    // on a new thread, whose pool holds nothing left by other tests
+    thread( [ & ]() {
+        ASSERT_TRUE( parse_tape( json ) ); // leaves its buffers in this thread's pool
+
+        AllocationCounts start = AllocationCounts::now();
+        {
+            const auto document = parse_tape( json );
+            ASSERT_TRUE( document );
+        }
+        EXPECT_EQ( 0, ( AllocationCounts::now() - start ).allocations );
+
+        // a document destroyed on another thread gives its buffers back to this thread's pool
+        auto first = parse_tape( json );
+        const auto second = parse_tape( json ); // the pool is empty, so this allocates
+        thread( []( TapeDocument ) {}, std::move( *first ) ).join();
+
+        start = AllocationCounts::now();
+        {
+            const auto document = parse_tape( json );
+            ASSERT_TRUE( document );
+        }
+        EXPECT_EQ( 0, ( AllocationCounts::now() - start ).allocations );
+    } ).join();
+
+    // a document outliving the thread that parsed it
+    optional<TapeDocument> orphan;
+    thread( [ & ]() { orphan.emplace( *parse_tape( json ) ); } ).join();
+    EXPECT_EQ( 1, get_value<int64_t>( *orphan->root().get_if<TapeObject>(), "id" ) );
+    orphan.reset();
+}
+
+TEST( Simple_json_tape_test, test_pool_size_is_limited )
+{
+    thread( []() {
+        // each document's buffers fit in the pool, but not both together
+        const string json = "\"" + string( 5'000'000, 'x' ) + "\"";
+
+        const AllocationCounts start = AllocationCounts::now();
+        {
+            const auto first = parse_tape( json );
+            const auto second = parse_tape( json );
+            ASSERT_TRUE( first && second );
+        }
+        const int64_t held = ( AllocationCounts::now() - start ).live_bytes;
+        EXPECT_LT( 5'000'000, held );
+        EXPECT_GE( 16 * 1024 * 1024, held );
+    } ).join();
+
+    // a thread that has recycling turned off keeps nothing
+    thread( []() {
+        set_recycle_tape_buffers( false );
+        const string json = R"({"id":1,"tags":["a","b"],"ok":true})";
+        ASSERT_TRUE( parse_tape( json ) );
+
+        const AllocationCounts start = AllocationCounts::now();
+        ASSERT_TRUE( parse_tape( json ) );
+        const AllocationCounts counts = AllocationCounts::now() - start;
+        EXPECT_LT( 0, counts.allocations );
+        EXPECT_EQ( 0, counts.live_bytes );
+    } ).join();
+}
+
+// run with --gtest_also_run_disabled_tests to compare parsing, walking and destroying a Value tree with a tape document
+TEST( DISABLED_Simple_json_tape_test, test_tape_speed )
+{
+    Array records;
+    for ( int i = 0; i < 300000; ++i )
+    {
+        records.push_back( Object{ { "active", i % 2 == 0 }, { "id", i }, { "name", "record " + to_string( i ) }, { "scores", Array{ i, i + 1, i + 2 } } } );
+    }
+    ostringstream os;
+    os << Value( std::move( records ) );
+    const string json = os.str();
+
+    auto start = chrono::steady_clock::now();
+    auto value = make_unique<Value>( *parse( json ) );
+    const auto tree_parse = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    const int64_t tree_sum = sum( *value );
+    const auto tree_walk = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    value.reset();
+    const auto tree_destroy = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    auto document = make_unique<TapeDocument>( *parse_tape( json ) );
+    const auto tape_parse = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    const int64_t tape_sum = sum( document->root() );
+    const auto tape_walk = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    document.reset();
+    const auto tape_destroy = chrono::steady_clock::now() - start;
+
+    EXPECT_EQ( tree_sum, tape_sum );
+
+    const auto us = []( auto d ) { return chrono::duration_cast<chrono::microseconds>( d ); };
+    cout << "        parse       walk        destroy\n"
+         << "tree    " << us( tree_parse ) << "  " << us( tree_walk ) << "  " << us( tree_destroy ) << "\n"
+         << "tape    " << us( tape_parse ) << "  " << us( tape_walk ) << "  " << us( tape_destroy ) << "\n";
+}
+
+// run with --gtest_also_run_disabled_tests to compare the throughput of threads parsing small messages into tape
+// documents with and without recycling their buffers through each thread's pool
+TEST( DISABLED_Simple_json_tape_test, test_concurrent_parse_speed )
+{
+    const string json = R"({"type":"order.created","tenant":"tenant-0123456789","id":123456789,"items":[{"sku":"sku-000000000001","quantity":2},)"
+                        R"({"sku":"sku-000000000002","quantity":1}],"address":{"street":"1 Long Street Name","city":"Some City Name"},"paid":true})";
+    const int per_thread = 100000;
+    const unsigned max_threads = std::max( 1u, thread::hardware_concurrency() );
+
+    for ( unsigned num_threads = 1;; num_threads = std::min( num_threads * 2, max_threads ) )
+    {
+        double docs_per_second[ 2 ];
+        for ( const bool recycle : { false, true } )
+        {
+            const auto start = chrono::steady_clock::now();
+            {
+                vector<jthread> threads;
+                for ( unsigned t = 0; t < num_threads; ++t )
+                {
+                    threads.emplace_back( [ & ]() {
+                        set_recycle_tape_buffers( recycle );
+                        for ( int i = 0; i < per_thread; ++i )
+                        {
+                            ASSERT_TRUE( parse_tape( json ) );
+                        }
+                    } );
+                }
+            }
+            const chrono::duration<double> time = chrono::steady_clock::now() - start;
+            docs_per_second[ recycle ] = num_threads * per_thread / time.count();
+        }
+
+        cout << num_threads << " threads: without the pool " << int64_t( docs_per_second[ 0 ] ) << " documents/s, with it "
+             << int64_t( docs_per_second[ 1 ] ) << " documents/s\n";
+
+        if ( num_threads == max_threads )
+        {
+            break;
+        }
+    }
+}
@@ -1,9 +1,12 @@
 // Distributed under the MIT License, see accompanying file LICENSE.txt
 // Copyright John W. Wilkinson 2025
 
+#include "allocation_counter.h"
 #include "simple_json.h"
 #include <gtest/gtest.h>
 #include <chrono>
+#include <cmath>
+#include <unordered_set>
 
 using namespace simple_json;
 using namespace std;
@@ -655,4 +658,824 @@ TEST( DISABLED_Simple_json_test, test_get_value_speed )
 
     cout << "num arrays " << ensure_not_optimised_away << endl;
     cout << "read time " << std::chrono::duration_cast<std::chrono::milliseconds>( end - start ) << endl;
-}
\ No newline at end of file
+}
+
+namespace
+{
+    Array make_large_array( int size )
+    {
+        Array arr;
+        for ( int i = 0; i < size; ++i )
+        {
+            arr.push_back( Object{ { "id", i }, { "name", key_name( i ) }, { "values", Array{ i, true, Null{} } } } );
+        }
+        return arr;
+    }
+
+    Object make_large_object( int size )
+    {
+        Object obj;
+        for ( int i = 0; i < size; ++i )
+        {
+            obj.emplace( key_name( i ), Array{ i, 222, "abc\n", false } );
+        }
+        return obj;
+    }
+
+    string serial_format( const Value& value )
+    {
+        ostringstream os;
+        os << value;
+        return os.str();
+    }
+} // namespace
+
+TEST( Simple_json_test, test_format_parallel )
+{
+    const vector<Value> values{ "hello", 123, Null{}, Array{}, Object{}, make_large_array( 10 ), make_large_array( 10000 ),
+                                make_large_object( 10 ), make_large_object( 10000 ), Array{ make_large_array( 5000 ) } };
+
+    for ( const Value& value : values )
+    {
+        const string expected = serial_format( value );
+
+        for ( unsigned num_threads : { 0, 1, 2, 3, 8 } )
+        {
+            EXPECT_EQ( format_parallel( value, num_threads ), expected );
+        }
+    }
+}
+
+#ifndef _WIN32
+TEST( Simple_json_test, test_write_parallel )
+{
+    const Value value = make_large_object( 20000 );
+
+    FILE* file = tmpfile();
+    ASSERT_TRUE( file );
+
+    ASSERT_TRUE( write_parallel( fileno( file ), value, 4 ) );
+
+    rewind( file );
+    string written;
+    for ( int c; ( c = fgetc( file ) ) != EOF; )
+    {
+        written += static_cast<char>( c );
+    }
+    fclose( file );
+
+    EXPECT_EQ( written, serial_format( value ) );
+
+    EXPECT_FALSE( write_parallel( -1, value, 4 ) );
+}
+#endif
+
+TEST( DISABLED_Simple_json_test, test_format_parallel_speed )
+{
+    const Value value = make_large_array( 2000000 );
+
+    auto start = std::chrono::steady_clock::now();
+    const size_t size = serial_format( value ).size();
+    auto end = std::chrono::steady_clock::now();
+    cout << "serial write time " << std::chrono::duration_cast<std::chrono::milliseconds>( end - start ) << endl;
+
+    for ( unsigned num_threads : { 1, 2, 4, 8, 16 } )
+    {
+        start = std::chrono::steady_clock::now();
+        const string str = format_parallel( value, num_threads );
+        end = std::chrono::steady_clock::now();
+
+        ASSERT_EQ( str.size(), size );
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>( end - start );
+        cout << num_threads << " threads write time " << ms << ", " << size / 1000.0 / std::max<int64_t>( 1, ms.count() ) << " MB/s" << endl;
+    }
+}
+
+TEST( Simple_json_test, test_canonical_string )
+{
+    const auto value = parse( R"({ "b": [ 1, -2, true, null ], "a": "x\"y\n", "c": {} })" );
+    ASSERT_TRUE( value );
+
+    EXPECT_EQ( R"({"a":"x\"y\n","b":[1,-2,true,null],"c":{}})", to_canonical_string( *value ) );
+    EXPECT_EQ( "[]", to_canonical_string( Array{} ) );
+    EXPECT_EQ( "-9223372036854775808", to_canonical_string( std::numeric_limits<int64_t>::min() ) );
+}
+
+TEST( Simple_json_test, test_hash_bytes )
+{
+    EXPECT_EQ( 0xEF46DB3751D8E999ULL, hash_bytes( "" ) );
+    EXPECT_EQ( 0x44BC2CF5AD770999ULL, hash_bytes( "abc" ) );
+    EXPECT_NE( hash_bytes( "abc" ), hash_bytes( "abc", 1 ) );
+}
+
+TEST( Simple_json_test, test_hash_value )
+{
+    // long enough strings to exercise the hasher's 32 byte stripes, split across several appends
+    const auto value = parse( R"({ "name": "a string that is longer than thirty two bytes", "list": [ 1, 2, 3, "four" ], "flag": false })" );
+    ASSERT_TRUE( value );
+
+    EXPECT_EQ( hash_value( *value ), hash_bytes( to_canonical_string( *value ) ) );
+
+    const auto same = parse( R"({"flag":false,"list":[1,2,3,"four"],"name":"a string that is longer than thirty two bytes"})" );
+    ASSERT_TRUE( same );
+    EXPECT_EQ( *value, *same );
+    EXPECT_EQ( hash_value( *value ), hash_value( *same ) );
+
+    EXPECT_NE( hash_value( Value( "1" ) ), hash_value( Value( int64_t( 1 ) ) ) );
+    EXPECT_NE( hash_value( Array{ Value( Array{} ) } ), hash_value( Array{} ) );
+}
+
+TEST( Simple_json_test, test_unordered_set_of_values )
+{
+    std::unordered_set<Value> values;
+
+    for ( const char* json : { R"({"a":1})", R"({ "a" : 1 })", "[1,2]", "[ 1, 2 ]", "null", "\"s\"" } )
+    {
+        values.insert( *parse( json ) );
+    }
+
+    EXPECT_EQ( 4u, values.size() );
+    EXPECT_TRUE( values.contains( Array{ int64_t( 1 ), int64_t( 2 ) } ) );
+    EXPECT_FALSE( values.contains( Array{ int64_t( 2 ), int64_t( 1 ) } ) );
+}
+
+TEST( Simple_json_test, test_values_compare_as_json )
+{
+    // the alternatives parse() chooses with its options equal the default ones, and hash the same
+    const string json = R"({"b":[1,2,3],"a":{"y":-0,"x":[4,"s"]},"c":null})";
+    const Value plain = Array{ int64_t( 1 ), int64_t( 2 ), *parse( json ) };
+    const Value packed = IntArray{ 1, 2 };
+
+    for ( const ParseOptions& options : { ParseOptions{ .pack_integer_arrays = true }, ParseOptions{ .ordered_objects = true },
+                                          ParseOptions{ .raw_numbers = true } } )
+    {
+        const auto value = parse( json, options );
+        ASSERT_TRUE( value ) << value.error();
+        EXPECT_EQ( *parse( json, ParseOptions{ .raw_numbers = true } ), *value );
+        EXPECT_EQ( hash_value( *parse( json, ParseOptions{ .raw_numbers = true } ) ), hash_value( *value ) );
+    }
+
+    EXPECT_EQ( Value( Array{ int64_t( 1 ), int64_t( 2 ) } ), packed );
+    EXPECT_EQ( packed, Value( Array{ RawNumber( "1" ), RawNumber( "2" ) } ) );
+    EXPECT_NE( packed, Value( Array{ int64_t( 1 ), int64_t( 2 ), int64_t( 3 ) } ) );
+    EXPECT_NE( packed, Value( Array{ int64_t( 1 ), "2" } ) );
+    EXPECT_NE( plain, Value( Array{ int64_t( 1 ), int64_t( 2 ) } ) );
+
+    // members in any order, but the same number of them
+    EXPECT_EQ( Value( OrderedObject{ { "b", 1 }, { "a", 2 } } ), Value( OrderedObject{ { "a", 2 }, { "b", 1 } } ) );
+    EXPECT_EQ( Value( Object{ { "a", 2 }, { "b", 1 } } ), Value( OrderedObject{ { "b", 1 }, { "a", 2 } } ) );
+    EXPECT_NE( Value( Object{ { "a", 2 } } ), Value( OrderedObject{ { "a", 2 }, { "a", 2 } } ) );
+    EXPECT_NE( Value( Object{ { "a", 2 } } ), Value( OrderedObject{ { "a", 3 } } ) );
+
+    // a RawNumber equals the integer it is written as, but not a different spelling of a real number
+    EXPECT_EQ( Value( int64_t( 0 ) ), Value( RawNumber( "-0" ) ) );
+    EXPECT_EQ( Value( RawNumber( "12" ) ), Value( int64_t( 12 ) ) );
+    EXPECT_TRUE( Value( RawNumber( "12" ) ) != Value( int64_t( 13 ) ) );
+    EXPECT_NE( Value( RawNumber( "1.0" ) ), Value( int64_t( 1 ) ) );
+    EXPECT_NE( Value( RawNumber( "1.0" ) ), Value( RawNumber( "1.00" ) ) );
+    EXPECT_NE( Value( RawNumber( "12" ) ), Value( "12" ) );
+}
+
+// run with --gtest_also_run_disabled_tests to compare hashing a value directly with hashing its canonical string
+TEST( DISABLED_Simple_json_test, test_hash_speed )
+{
+    const Value value = make_large_object( 100000 );
+    const int runs = 10;
+
+    size_t direct = 0;
+    const auto start_direct = chrono::steady_clock::now();
+    for ( int i = 0; i < runs; ++i )
+    {
+        direct ^= hash_value( value );
+    }
+    const auto direct_time = chrono::steady_clock::now() - start_direct;
+
+    size_t via_string = 0;
+    const auto start_string = chrono::steady_clock::now();
+    for ( int i = 0; i < runs; ++i )
+    {
+        via_string ^= hash_bytes( to_canonical_string( value ) );
+    }
+    const auto string_time = chrono::steady_clock::now() - start_string;
+
+    EXPECT_EQ( direct, via_string );
+
+    cout << "hash_value:              " << chrono::duration_cast<chrono::milliseconds>( direct_time ).count() / runs << " ms\n";
+    cout << "hash of canonical string: " << chrono::duration_cast<chrono::milliseconds>( string_time ).count() / runs << " ms\n";
+}
+
+TEST( Simple_json_test, test_parse_stats )
+{
+    const string json = R"({ "name": "a\tb", "list": [ 1, -2, [ true, false, null ] ], "empty": {} } )";
+
+    ParseStats stats;
+    const auto value = parse( json, stats );
+    ASSERT_TRUE( value );
+    EXPECT_EQ( *value, *parse( json ) );
+
+    EXPECT_EQ( json.size(), stats.bytes_consumed );
+    EXPECT_EQ( 1u, stats.strings );
+    EXPECT_EQ( 3u, stats.member_names );
+    EXPECT_EQ( 2u, stats.booleans );
+    EXPECT_EQ( 2u, stats.integers );
+    EXPECT_EQ( 1u, stats.nulls );
+    EXPECT_EQ( 2u, stats.arrays );
+    EXPECT_EQ( 2u, stats.objects );
+    EXPECT_EQ( 3u, stats.max_depth );
+    EXPECT_EQ( 2u + 4 + 4 + 5, stats.string_bytes_copied );
+    EXPECT_EQ( 1u, stats.string_bytes_escaped );
+    EXPECT_LE( stats.string_time + stats.integer_time, stats.total_time );
+
+    // short strings fit in the std::string, so only the arrays, each growing to capacities 1, 2 and 4, and the object members allocate
+    EXPECT_EQ( 3u + 3 + 3, stats.allocations );
+
+    ParseStats long_string_stats;
+    ASSERT_TRUE( parse( "\"" + string( 100, 'x' ) + "\"", long_string_stats ) );
+    EXPECT_EQ( 0u, long_string_stats.max_depth );
+    EXPECT_GT( long_string_stats.allocations, 0u );
+    EXPECT_GT( long_string_stats.allocated_bytes, 100u );
+
+    // a raw number allocates only when its text is too long to fit in the std::string
+    ParseStats raw_number_stats;
+    ASSERT_TRUE( parse( "[ 12, 123456789012345678901234567890 ]", ParseOptions{ .raw_numbers = true }, raw_number_stats ) );
+    EXPECT_EQ( 2u + 1, raw_number_stats.allocations ); // the array grows to capacities 1 and 2
+}
+
+TEST( Simple_json_test, test_parse_stats_on_error )
+{
+    ParseStats stats;
+    EXPECT_FALSE( parse( "[1, 2, x]", stats ) );
+    EXPECT_EQ( 7u, stats.bytes_consumed );
+    EXPECT_EQ( 2u, stats.integers );
+
+    EXPECT_FALSE( parse( "[1] 2", stats ) );
+    EXPECT_EQ( 4u, stats.bytes_consumed );
+}
+
+// run with --gtest_also_run_disabled_tests to see the cost of collecting parse statistics
+TEST( DISABLED_Simple_json_test, test_parse_stats_speed )
+{
+    ostringstream os;
+    os << make_large_object( 100000 );
+    const string json = os.str();
+
+    auto start = chrono::steady_clock::now();
+    ASSERT_TRUE( parse( json ) );
+    const auto without_stats = chrono::steady_clock::now() - start;
+
+    ParseStats stats;
+    start = chrono::steady_clock::now();
+    ASSERT_TRUE( parse( json, stats ) );
+    const auto with_stats = chrono::steady_clock::now() - start;
+
+    cout << "without stats: " << chrono::duration_cast<chrono::milliseconds>( without_stats ) << "\n";
+    cout << "with stats:    " << chrono::duration_cast<chrono::milliseconds>( with_stats ) << ", " << stats.allocations << " allocations, "
+         << stats.allocated_bytes << " bytes, string time " << chrono::duration_cast<chrono::milliseconds>( stats.string_time ) << "\n";
+}
+
+TEST( Simple_json_test, test_parse_does_not_copy )
+{
+    // long enough that every string and member name allocates, so a copy of any part of the tree would be an extra allocation
+    const string long_name( 40, 'n' );
+    const string long_string( 100, 's' );
+    const string json = "{ \"" + long_name + "\": [ \"" + long_string + "\", [ { \"" + long_name + "\": \"" + long_string +
+                        "\" } ], 1, true ], \"" + long_name + "2\": { \"" + long_name + "\": [ [ [ \"" + long_string + "\" ] ] ] } }";
+
+    for ( const ParseOptions& options : { ParseOptions(), ParseOptions{ .ordered_objects = true } } )
+    {
+        ParseStats stats;
+        const AllocationCounts start = AllocationCounts::now();
+        const auto value = parse( json, options, stats );
+        const AllocationCounts used = AllocationCounts::now() - start;
+
+        ASSERT_TRUE( value ) << value.error();
+        EXPECT_EQ( stats.allocations, used.allocations ); // the stats count each string, array and member once
+        EXPECT_EQ( *parse( json, options ), *value );
+    }
+}
+
+// run with --gtest_also_run_disabled_tests to see the time and allocations of parsing a large document
+TEST( DISABLED_Simple_json_test, test_parse_allocations_speed )
+{
+    ostringstream os;
+    os << make_large_object( 100000 );
+    const string json = os.str();
+
+    ParseStats stats;
+    ASSERT_TRUE( parse( json, stats ) );
+
+    const AllocationCounts start_counts = AllocationCounts::now();
+    const auto start = chrono::steady_clock::now();
+    const auto value = parse( json );
+    const auto parse_time = chrono::steady_clock::now() - start;
+    const AllocationCounts used = AllocationCounts::now() - start_counts;
+
+    ASSERT_TRUE( value );
+    EXPECT_EQ( stats.allocations, used.allocations );
+    cout << "parse " << json.size() / 1000000 << " MB: " << chrono::duration_cast<chrono::milliseconds>( parse_time ) << ", "
+         << used.allocations << " allocations, " << used.bytes / 1000000 << " MB allocated\n";
+}
+
+TEST( Simple_json_test, test_get_value_does_not_allocate )
+{
+    const Object obj{ { "a_member_name_too_long_for_small_strings", int64_t( 1 ) }, { "b", true } };
+
+    const AllocationCounts start = AllocationCounts::now();
+
+    const auto a = get_value<int64_t>( obj, "a_member_name_too_long_for_small_strings" );
+    const auto b = get_value<bool>( obj, std::string_view( "b" ) );
+    const bool found = obj.contains( "a_member_name_too_long_for_small_strings" );
+
+    EXPECT_EQ( 0u, ( AllocationCounts::now() - start ).allocations );
+
+    ASSERT_TRUE( a );
+    EXPECT_EQ( 1, a->get() );
+    ASSERT_TRUE( b );
+    EXPECT_TRUE( b->get() );
+    EXPECT_TRUE( found );
+}
+
+TEST( Simple_json_test, test_find_members )
+{
+    const auto value = parse( R"({ "age": 20, "grades": [ 85, 90 ], "name": "Alice", "zip": null })" );
+    ASSERT_TRUE( value );
+    const Object& obj = get<Object>( *value );
+
+    const auto members = find_members<4>( obj, { "name", "missing", "age", "zip" } );
+    ASSERT_TRUE( members[ 0 ] );
+    EXPECT_EQ( Value( "Alice" ), *members[ 0 ] );
+    EXPECT_FALSE( members[ 1 ] );
+    ASSERT_TRUE( members[ 2 ] );
+    EXPECT_EQ( Value( int64_t( 20 ) ), *members[ 2 ] );
+    ASSERT_TRUE( members[ 3 ] );
+    EXPECT_EQ( Value( Null() ), *members[ 3 ] );
+
+    // far apart members are found by a lookup instead of stepping
+    Object large;
+    for ( int i = 0; i < 100; ++i )
+    {
+        large[ key_name( i ) ] = int64_t( i );
+    }
+    const auto far = find_members<3>( large, { key_name( 90 ), key_name( 2 ), "not there" } );
+    ASSERT_TRUE( far[ 0 ] && far[ 1 ] );
+    EXPECT_EQ( Value( int64_t( 90 ) ), *far[ 0 ] );
+    EXPECT_EQ( Value( int64_t( 2 ) ), *far[ 1 ] );
+    EXPECT_FALSE( far[ 2 ] );
+}
+
+TEST( Simple_json_test, test_get_values )
+{
+    const auto value = parse( R"({ "age": 20, "grades": [ 85, 90 ], "name": "Alice" })" );
+    ASSERT_TRUE( value );
+    const Object& obj = get<Object>( *value );
+
+    const auto fields = get_values<string, int64_t, Array>( obj, { "name", "age", "grades" } );
+    ASSERT_TRUE( fields );
+    const auto [ name, age, grades ] = *fields;
+    EXPECT_EQ( "Alice", name.get() );
+    EXPECT_EQ( 20, age.get() );
+    EXPECT_EQ( 2u, grades.get().size() );
+
+    const auto missing = get_values<string, int64_t>( obj, { "name", "height" } );
+    ASSERT_FALSE( missing );
+    EXPECT_EQ( "field \"height\" not found", missing.error() );
+
+    const auto wrong_type = get_values<string, string, string>( obj, { "name", "age", "grades" } );
+    ASSERT_FALSE( wrong_type );
+    EXPECT_EQ( "field \"age\" is not the expected type", wrong_type.error() );
+}
+
+// run with --gtest_also_run_disabled_tests to compare looking up members one at a time and in one pass
+TEST( DISABLED_Simple_json_test, test_lookup_speed )
+{
+    const Object obj = make_large_object( 1000 );
+    const std::array<std::string_view, 4> keys = { "test_100", "test_101", "test_102", "test_103" };
+    ASSERT_TRUE( obj.contains( keys[ 0 ] ) );
+    const int runs = 1000000;
+
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for ( int i = 0; i < runs; ++i )
+    {
+        for ( const auto key : keys )
+        {
+            found += obj.find( string( key ) ) != obj.end();
+        }
+    }
+    const auto with_strings = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for ( int i = 0; i < runs; ++i )
+    {
+        for ( const auto key : keys )
+        {
+            found += obj.find( key ) != obj.end();
+        }
+    }
+    const auto with_views = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for ( int i = 0; i < runs; ++i )
+    {
+        for ( const Value* value : find_members( obj, keys ) )
+        {
+            found += value != nullptr;
+        }
+    }
+    const auto one_pass = chrono::steady_clock::now() - start;
+
+    EXPECT_EQ( 3u * runs * keys.size(), found );
+
+    cout << "std::string keys:   " << chrono::duration_cast<chrono::nanoseconds>( with_strings ).count() / runs << " ns\n";
+    cout << "string_view keys:   " << chrono::duration_cast<chrono::nanoseconds>( with_views ).count() / runs << " ns\n";
+    cout << "find_members:       " << chrono::duration_cast<chrono::nanoseconds>( one_pass ).count() / runs << " ns\n";
+}
+
+TEST( Simple_json_test, test_to_vector )
+{
+    const Array arr{ int64_t( 1 ), int64_t( -2 ), int64_t( 300 ) };
+
+    const auto ints = to_vector<int>( arr );
+    ASSERT_TRUE( ints );
+    EXPECT_EQ( ( vector<int>{ 1, -2, 300 } ), *ints );
+
+    const auto bytes = to_vector<int8_t>( arr );
+    ASSERT_FALSE( bytes );
+    EXPECT_EQ( "element 2 is out of range", bytes.error() );
+
+    const auto unsigned_ints = to_vector<unsigned>( arr );
+    ASSERT_FALSE( unsigned_ints );
+    EXPECT_EQ( "element 1 is out of range", unsigned_ints.error() );
+
+    const auto strings = to_vector<string>( Array{ "a", "b", int64_t( 3 ) } );
+    ASSERT_FALSE( strings );
+    EXPECT_EQ( "element 2 is not the expected type", strings.error() );
+
+    const auto bools = to_vector<bool>( Array{ true, false } );
+    ASSERT_TRUE( bools );
+    EXPECT_EQ( ( vector<bool>{ true, false } ), *bools );
+
+    const auto packed = to_vector<int64_t>( IntArray{ 5, 6 } );
+    ASSERT_TRUE( packed );
+    EXPECT_EQ( ( vector<int64_t>{ 5, 6 } ), *packed );
+
+    EXPECT_FALSE( to_vector<bool>( IntArray{ 5 } ) );
+}
+
+TEST( Simple_json_test, test_get_array_as )
+{
+    for ( const bool pack : { false, true } )
+    {
+        const auto value = parse( R"({ "grades": [ 85, 90, 78 ], "names": [ "a", 1 ], "age": 20 })", ParseOptions{ .pack_integer_arrays = pack } );
+        ASSERT_TRUE( value );
+        const Object& obj = get<Object>( *value );
+
+        EXPECT_EQ( pack, holds_alternative<IntArray>( obj.at( "grades" ) ) );
+
+        const auto grades = get_array_as<int>( obj, "grades" );
+        ASSERT_TRUE( grades );
+        EXPECT_EQ( ( vector<int>{ 85, 90, 78 } ), *grades );
+
+        EXPECT_EQ( "field \"names\" element 1 is not the expected type", get_array_as<string>( obj, "names" ).error() );
+        EXPECT_EQ( "field \"age\" is not an array", get_array_as<int>( obj, "age" ).error() );
+        EXPECT_EQ( "field \"height\" not found", get_array_as<int>( obj, "height" ).error() );
+    }
+}
+
+TEST( Simple_json_test, test_pack_integer_arrays )
+{
+    const ParseOptions options{ .pack_integer_arrays = true };
+
+    const string json = "{\n"
+                        "    \"empty\" : [\n"
+                        "        \n"
+                        "    ],\n"
+                        "    \"ints\" : [\n"
+                        "        1, -2, 3\n"
+                        "    ],\n"
+                        "    \"mixed\" : [\n"
+                        "        1, 2, \"three\", 4\n"
+                        "    ],\n"
+                        "    \"nested\" : [\n"
+                        "        [\n"
+                        "            5, 6\n"
+                        "        ]\n"
+                        "    ]\n"
+                        "}";
+
+    const auto value = parse( json, options );
+    ASSERT_TRUE( value );
+    const Object& obj = get<Object>( *value );
+
+    EXPECT_TRUE( holds_alternative<Array>( obj.at( "empty" ) ) );
+    EXPECT_EQ( Value( IntArray{ 1, -2, 3 } ), obj.at( "ints" ) );
+    EXPECT_EQ( Value( Array{ int64_t( 1 ), int64_t( 2 ), "three", int64_t( 4 ) } ), obj.at( "mixed" ) );
+    EXPECT_EQ( Value( Array{ IntArray{ 5, 6 } } ), obj.at( "nested" ) );
+
+    // a packed array formats and hashes the same as the unpacked one
+    ostringstream os;
+    os << *value;
+    EXPECT_EQ( json, os.str() );
+    EXPECT_EQ( to_canonical_string( *parse( json ) ), to_canonical_string( *value ) );
+    EXPECT_EQ( hash_value( *parse( json ) ), hash_value( *value ) );
+
+    EXPECT_EQ( parse( "[1, 2" ).error(), parse( "[1, 2", options ).error() );
+    EXPECT_EQ( parse( "[1, 2,]" ).error(), parse( "[1, 2,]", options ).error() );
+    EXPECT_EQ( parse( "[1 2]" ).error(), parse( "[1 2]", options ).error() );
+    EXPECT_EQ( parse( "[1, 99999999999999999999]" ).error(), parse( "[1, 99999999999999999999]", options ).error() );
+}
+
+// run with --gtest_also_run_disabled_tests to compare parsing and converting a large integer array, packed or not
+TEST( DISABLED_Simple_json_test, test_pack_integer_arrays_speed )
+{
+    string json = "[";
+    for ( int i = 0; i < 2000000; ++i )
+    {
+        json += ( i ? ", " : "" ) + to_string( i * 7 );
+    }
+    json += "]";
+
+    for ( const bool pack : { false, true } )
+    {
+        const AllocationCounts start_counts = AllocationCounts::now();
+        auto start = chrono::steady_clock::now();
+        const auto value = parse( json, ParseOptions{ .pack_integer_arrays = pack } );
+        const auto parse_time = chrono::steady_clock::now() - start;
+        const AllocationCounts counts = AllocationCounts::now() - start_counts;
+        ASSERT_TRUE( value );
+
+        start = chrono::steady_clock::now();
+        const auto ints = pack ? to_vector<int>( get<IntArray>( *value ) ) : to_vector<int>( get<Array>( *value ) );
+        const auto convert_time = chrono::steady_clock::now() - start;
+        ASSERT_TRUE( ints );
+
+        cout << ( pack ? "packed:   " : "unpacked: " ) << "parse " << chrono::duration_cast<chrono::milliseconds>( parse_time ) << ", "
+             << counts.live_bytes / 1000000 << " MB, to_vector " << chrono::duration_cast<chrono::milliseconds>( convert_time ) << "\n";
+    }
+}
+
+TEST( Simple_json_test, test_ordered_objects )
+{
+    const ParseOptions options{ .ordered_objects = true };
+
+    const string json = "{\n"
+                        "    \"b\" : 1,\n"
+                        "    \"a\" : {\n"
+                        "        \"z\" : true,\n"
+                        "        \"y\" : null\n"
+                        "    },\n"
+                        "    \"c\" : [\n"
+                        "        \"x\"\n"
+                        "    ]\n"
+                        "}";
+
+    const auto value = parse( json, options );
+    ASSERT_TRUE( value ) << value.error();
+    const OrderedObject& obj = get<OrderedObject>( *value );
+
+    EXPECT_EQ( Value( OrderedObject{ { "b", 1 }, { "a", OrderedObject{ { "z", true }, { "y", Null() } } }, { "c", Array{ "x" } } } ), *value );
+    EXPECT_EQ( Value( int64_t( 1 ) ), obj.find( "b" )->second );
+    EXPECT_EQ( obj.end(), obj.find( "d" ) );
+    EXPECT_EQ( 1, get_value<int64_t>( obj, "b" )->get() );
+
+    // formats in document order, and canonically the same as an Object
+    ostringstream os;
+    os << *value;
+    EXPECT_EQ( json, os.str() );
+    EXPECT_EQ( to_canonical_string( *parse( json ) ), to_canonical_string( *value ) );
+    EXPECT_EQ( hash_value( *parse( json ) ), hash_value( *value ) );
+    EXPECT_EQ( *parse( json ), *value );
+}
+
+TEST( Simple_json_test, test_duplicate_keys )
+{
+    const string json = R"({"b":1,"a":2,"b":3})";
+
+    auto check = [ & ]( DuplicateKeys duplicate_keys, const Value& expected_object, const Value& expected_ordered ) {
+        const auto value = parse( json, ParseOptions{ .duplicate_keys = duplicate_keys } );
+        ASSERT_TRUE( value ) << value.error();
+        EXPECT_EQ( expected_object, *value );
+
+        const auto ordered = parse( json, ParseOptions{ .ordered_objects = true, .duplicate_keys = duplicate_keys } );
+        ASSERT_TRUE( ordered ) << ordered.error();
+        EXPECT_EQ( expected_ordered, *ordered );
+    };
+
+    check( DuplicateKeys::keep_first, Object{ { "a", 2 }, { "b", 1 } }, OrderedObject{ { "b", 1 }, { "a", 2 } } );
+    check( DuplicateKeys::keep_last, Object{ { "a", 2 }, { "b", 3 } }, OrderedObject{ { "b", 3 }, { "a", 2 } } );
+
+    for ( const bool ordered : { false, true } )
+    {
+        const auto value = parse( json, ParseOptions{ .ordered_objects = ordered, .duplicate_keys = DuplicateKeys::error } );
+        ASSERT_FALSE( value );
+        EXPECT_EQ( "duplicate member \"b\" at line 1 column 14", value.error() );
+    }
+
+    // the later members of a large ordered object are checked once it is complete
+    const string large = R"({"m0":0,"m1":1,"m2":2,"m3":3,"m4":4,"m5":5,"m6":6,"m7":7,"m8":8,"m1":-1,"m9":9,"m8":-8,"m1":-2})";
+    const auto members = []( const Value& value ) {
+        const OrderedObject& obj = get<OrderedObject>( value );
+        return vector<OrderedObject::value_type>( obj.begin(), obj.end() );
+    };
+
+    const auto first = parse( large, ParseOptions{ .ordered_objects = true } );
+    ASSERT_TRUE( first ) << first.error();
+    EXPECT_EQ( members( *parse( R"({"m0":0,"m1":1,"m2":2,"m3":3,"m4":4,"m5":5,"m6":6,"m7":7,"m8":8,"m9":9})", ParseOptions{ .ordered_objects = true } ) ),
+               members( *first ) );
+
+    const auto last = parse( large, ParseOptions{ .ordered_objects = true, .duplicate_keys = DuplicateKeys::keep_last } );
+    ASSERT_TRUE( last ) << last.error();
+    EXPECT_EQ( members( *parse( R"({"m0":0,"m1":-2,"m2":2,"m3":3,"m4":4,"m5":5,"m6":6,"m7":7,"m8":-8,"m9":9})", ParseOptions{ .ordered_objects = true } ) ),
+               members( *last ) );
+    EXPECT_EQ( Value( -2 ), get<OrderedObject>( *last ).find( "m1" )->second );
+
+    const auto error = parse( "[1,\n" + large + "]", ParseOptions{ .ordered_objects = true, .duplicate_keys = DuplicateKeys::error } );
+    ASSERT_FALSE( error );
+    EXPECT_EQ( "duplicate member \"m1\" at line 2 column 65", error.error() );
+}
+
+TEST( Simple_json_test, test_ordered_object_index )
+{
+    // enough members for find() to use the hash index, which must follow appends and erases
+    OrderedObject obj;
+    for ( int i = 99; i >= 0; --i )
+    {
+        obj.emplace_back( "m" + to_string( i ), i );
+    }
+    EXPECT_EQ( Value( 42 ), obj.find( "m42" )->second );
+
+    obj.emplace_back( "m42", -1 ); // a duplicate, find() still gives the first
+    obj.emplace_back( "new", 100 );
+    EXPECT_EQ( Value( 42 ), obj.find( "m42" )->second );
+    EXPECT_EQ( Value( 100 ), obj.find( "new" )->second );
+
+    obj.erase( obj.find( "m42" ) );
+    EXPECT_EQ( Value( -1 ), obj.find( "m42" )->second );
+    EXPECT_EQ( Value( 0 ), obj.find( "m0" )->second );
+    EXPECT_EQ( obj.end(), obj.find( "m100" ) );
+
+    EXPECT_FALSE( obj.insert_or_assign( "m0", 7 ).second );
+    EXPECT_EQ( Value( 7 ), obj.find( "m0" )->second );
+
+    const OrderedObject copy = obj;
+    EXPECT_EQ( copy, obj );
+    EXPECT_EQ( Value( 7 ), copy.find( "m0" )->second );
+}
+
+// run with --gtest_also_run_disabled_tests to compare parsing objects into maps and into ordered objects
+TEST( DISABLED_Simple_json_test, test_ordered_objects_speed )
+{
+    string json = "[";
+    for ( int i = 0; i < 100000; ++i )
+    {
+        json += ( i ? "," : "" ) + string( R"({"id":)" ) + to_string( i ) + R"(,"name":"n","kind":"k","tags":[],"size":1,"owner":"o"})";
+    }
+    json += "]";
+
+    for ( const bool ordered : { false, true } )
+    {
+        const AllocationCounts start_counts = AllocationCounts::now();
+        const auto start = chrono::steady_clock::now();
+        const auto value = parse( json, ParseOptions{ .ordered_objects = ordered } );
+        const auto parse_time = chrono::steady_clock::now() - start;
+        const AllocationCounts counts = AllocationCounts::now() - start_counts;
+        ASSERT_TRUE( value );
+
+        cout << ( ordered ? "ordered: " : "map:     " ) << chrono::duration_cast<chrono::milliseconds>( parse_time ) << ", " << counts.allocations
+             << " allocations, " << counts.live_bytes / 1000000 << " MB\n";
+    }
+}
+
+TEST( Simple_json_test, test_raw_numbers )
+{
+    const ParseOptions options{ .pack_integer_arrays = true, .raw_numbers = true };
+
+    const string json = R"({"big":123456789012345678901234567890,"e":-1.5E+3,"list":[1,2.50,0e0],"max":18446744073709551615,"small":-5})";
+
+    const auto value = parse( json, options );
+    ASSERT_TRUE( value ) << value.error();
+    const Object& obj = get<Object>( *value );
+
+    // the text is kept exactly, so the value writes back unchanged
+    EXPECT_EQ( json, to_canonical_string( *value ) );
+    EXPECT_EQ( Value( Array{ RawNumber( "1" ), RawNumber( "2.50" ), RawNumber( "0e0" ) } ), obj.at( "list" ) );
+    EXPECT_NE( Value( RawNumber( "2.5" ) ), get<Array>( obj.at( "list" ) )[ 1 ] );
+    EXPECT_EQ( Value( RawNumber( "-0" ) ), Value( RawNumber( "0" ) ) ); // both equal the integer 0, so equal each other
+    EXPECT_NE( Value( RawNumber( "1.0" ) ), Value( RawNumber( "1" ) ) );
+
+    const RawNumber& small = get<RawNumber>( obj.at( "small" ) );
+    EXPECT_EQ( -5, small.to_int64() );
+    EXPECT_EQ( "\"-5\" is out of range for a uint64_t", small.to_uint64().error() );
+    EXPECT_EQ( -5.0, small.to_double() );
+
+    const RawNumber& big = get<RawNumber>( obj.at( "big" ) );
+    EXPECT_EQ( "\"123456789012345678901234567890\" is out of range for an int64_t", big.to_int64().error() );
+    EXPECT_DOUBLE_EQ( 1.2345678901234568e29, *big.to_double() );
+
+    EXPECT_EQ( 18446744073709551615u, get<RawNumber>( obj.at( "max" ) ).to_uint64() );
+
+    const RawNumber& e = get<RawNumber>( obj.at( "e" ) );
+    EXPECT_EQ( -1500.0, e.to_double() );
+    EXPECT_EQ( "\"-1.5E+3\" is not an integer", e.to_int64().error() );
+    EXPECT_EQ( "\"1e999\" is out of range for a double", RawNumber( "1e999" ).to_double().error() );
+    EXPECT_EQ( "\"-123.4e307\" is out of range for a double", RawNumber( "-123.4e307" ).to_double().error() );
+    EXPECT_EQ( "\"0.1e99999999999999999999\" is out of range for a double", RawNumber( "0.1e99999999999999999999" ).to_double().error() );
+    EXPECT_EQ( 0.0, RawNumber( "1e-400" ).to_double() );
+    EXPECT_TRUE( std::signbit( *RawNumber( "-0.001E-99999999999999999999" ).to_double() ) );
+    EXPECT_EQ( 0.0, RawNumber( "12345e-99999" ).to_double() );
+
+    EXPECT_EQ( ( vector<double>{ 1, 2.5, 0 } ), get_array_as<double>( obj, "list" ) );
+    EXPECT_EQ( "field \"list\" element 1 is not the expected type", get_array_as<int>( obj, "list" ).error() );
+    EXPECT_EQ( ( vector<uint64_t>{ 18446744073709551615u } ), to_vector<uint64_t>( Array{ obj.at( "max" ) } ) );
+    EXPECT_EQ( "element 0 is out of range", to_vector<int64_t>( Array{ obj.at( "max" ) } ).error() );
+
+    // invalid numbers are errors, as they are without the option
+    EXPECT_EQ( "invalid number \"1.\" at line 1 column 4", parse( "[1.]", options ).error() );
+    EXPECT_EQ( "invalid number \"-\" at line 1 column 2", parse( "-", options ).error() );
+    EXPECT_EQ( "invalid number \"2e+\" at line 1 column 4", parse( "2e+", options ).error() );
+    EXPECT_EQ( "invalid number \"01\" at line 1 column 3", parse( "01", options ).error() );
+    EXPECT_EQ( "invalid number \"-00\" at line 1 column 5", parse( "[-00.5]", options ).error() );
+    EXPECT_EQ( Value( Array{ RawNumber( "0" ), RawNumber( "-0.01" ), RawNumber( "0e05" ), RawNumber( "10" ) } ), *parse( "[0,-0.01,0e05,10]", options ) );
+    EXPECT_EQ( "unprocessed data at line 1 column 2", parse( "1.5" ).error() );
+}
+
+// run with --gtest_also_run_disabled_tests to compare parsing numbers as integers with keeping their text
+TEST( DISABLED_Simple_json_test, test_raw_numbers_speed )
+{
+    string json = "[";
+    for ( int i = 0; i < 200000; ++i )
+    {
+        json += ( i ? "," : "" ) + string( R"({"id":)" ) + to_string( i * 7919LL ) + R"(,"size":)" + to_string( i ) + R"(,"offset":-)" +
+                to_string( i * 31 ) + R"(,"count":12345678})";
+    }
+    json += "]";
+
+    for ( const bool raw : { false, true } )
+    {
+        const auto start = chrono::steady_clock::now();
+        const auto value = parse( json, ParseOptions{ .raw_numbers = raw } );
+        const auto parse_time = chrono::steady_clock::now() - start;
+        ASSERT_TRUE( value );
+
+        cout << ( raw ? "raw numbers: " : "integers:    " ) << chrono::duration_cast<chrono::milliseconds>( parse_time ) << "\n";
+    }
+}
+
+TEST( Simple_json_test, test_parse_limits )
+{
+    // each limit allows exactly its maximum
+    EXPECT_TRUE( parse( "[[{}]]", ParseOptions{ .max_depth = 3 } ) );
+    EXPECT_EQ( "nesting deeper than the maximum depth of 2 at line 1 column 3", parse( "[[{}]]", ParseOptions{ .max_depth = 2 } ).error() );
+    EXPECT_EQ( "nesting deeper than the maximum depth of 1 at line 1 column 12", parse( R"({"a":1,"b":{}})", ParseOptions{ .max_depth = 1 } ).error() );
+    EXPECT_TRUE( parse( "1", ParseOptions{ .max_depth = 1 } ) );
+
+    EXPECT_TRUE( parse( R"({"abc":"a\"c"})", ParseOptions{ .max_string_bytes = 3 } ) );
+    EXPECT_EQ( "string longer than the maximum of 3 bytes at line 1 column 7", parse( R"(["a\"cd"])", ParseOptions{ .max_string_bytes = 3 } ).error() );
+    EXPECT_EQ( "string longer than the maximum of 3 bytes at line 1 column 6", parse( R"({"abcd":1})", ParseOptions{ .max_string_bytes = 3 } ).error() );
+
+    for ( const ParseOptions& options : { ParseOptions{ .max_container_elements = 3 }, ParseOptions{ .pack_integer_arrays = true, .max_container_elements = 3 } } )
+    {
+        EXPECT_TRUE( parse( "[1,2,3]", options ) );
+        EXPECT_TRUE( parse( R"([1,"b",3])", options ) );
+        EXPECT_EQ( "array with more than the maximum of 3 elements at line 1 column 8", parse( "[1,2,3,4]", options ).error() );
+        EXPECT_EQ( "array with more than the maximum of 3 elements at line 1 column 10", parse( R"([1,2,"c",4])", options ).error() );
+    }
+    EXPECT_TRUE( parse( R"({"a":1,"b":2,"c":3})", ParseOptions{ .max_container_elements = 3 } ) );
+    EXPECT_EQ( "object with more than the maximum of 3 members at line 1 column 20",
+               parse( R"({"a":1,"b":2,"a":3,"d":4})", ParseOptions{ .duplicate_keys = DuplicateKeys::keep_last, .max_container_elements = 3 } ).error() );
+
+    // a deeply nested document is rejected before it can exhaust the stack
+    const string deep = string( 1000000, '[' ) + string( 1000000, ']' );
+    EXPECT_EQ( "nesting deeper than the maximum depth of 100 at line 1 column 101", parse( deep, ParseOptions{ .max_depth = 100 } ).error() );
+
+    // limits are enforced the same way while collecting statistics
+    ParseStats stats;
+    EXPECT_EQ( "nesting deeper than the maximum depth of 2 at line 1 column 3", parse( "[[{}]]", ParseOptions{ .max_depth = 2 }, stats ).error() );
+}
+
+TEST( Simple_json_test, test_parse_memory_budget )
+{
+    ostringstream os;
+    os << make_large_object( 100 );
+    const string json = os.str();
+
+    for ( const ParseOptions& options : { ParseOptions(), ParseOptions{ .ordered_objects = true }, ParseOptions{ .raw_numbers = true } } )
+    {
+        const AllocationCounts start = AllocationCounts::now();
+        const auto value = parse( json, options );
+        const AllocationCounts used = AllocationCounts::now() - start;
+        ASSERT_TRUE( value ) << value.error();
+
+        // the budget is charged with the memory the value holds, not with what the parse uses in passing
+        ParseOptions limited = options;
+        limited.max_memory = 2 * used.live_bytes;
+        EXPECT_TRUE( parse( json, limited ) );
+
+        limited.max_memory = used.live_bytes / 2;
+        const auto over = parse( json, limited );
+        ASSERT_FALSE( over );
+        EXPECT_TRUE( over.error().starts_with( "memory budget of " + to_string( limited.max_memory ) + " bytes exceeded at line " ) ) << over.error();
+    }
+
+    EXPECT_EQ( "memory budget of 100 bytes exceeded at line 1 column 102", parse( '"' + string( 101, 'x' ) + '"', ParseOptions{ .max_memory = 100 } ).error() );
+}
@@ -0,0 +1,133 @@
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+// Copyright John W. Wilkinson 2025
+
+#include "allocation_counter.h"
+#include "simple_json_writer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+
+using namespace simple_json;
+using namespace std;
+
+TEST( Simple_json_writer_test, test_write )
+{
+    string json;
+    Writer writer( json );
+
+    writer.begin_object()
+        .key( "id" )
+        .value( 42 )
+        .key( "name" )
+        .value( "Bob \"the\" builder\n" )
+        .key( "tags" )
+        .begin_array()
+        .value( true )
+        .value( Null() )
+        .value( int64_t( -7 ) )
+        .begin_object()
+        .end_object()
+        .end_array()
+        .key( "empty" )
+        .begin_array()
+        .end_array()
+        .end_object();
+
+    EXPECT_TRUE( writer.complete() );
+    EXPECT_EQ( R"({"id":42,"name":"Bob \"the\" builder\n","tags":[true,null,-7,{}],"empty":[]})", json );
+
+    const auto value = parse( json );
+    ASSERT_TRUE( value ) << value.error();
+    EXPECT_EQ( Value( Object{ { "id", 42 }, { "name", "Bob \"the\" builder\n" }, { "tags", Array{ true, Null(), -7, Object() } }, { "empty", Array() } } ),
+               *value );
+}
+
+TEST( Simple_json_writer_test, test_write_value )
+{
+    const auto value = parse( R"({"b":[1,2,{"c":"\/"}],"a":[3,4]})", ParseOptions{ .pack_integer_arrays = true } );
+    ASSERT_TRUE( value );
+
+    string json;
+    Writer( json ).value( *value );
+    EXPECT_EQ( to_canonical_string( *value ), json );
+
+    // an ordered object is written in order, embedded in other output
+    json.clear();
+    Writer writer( json );
+    writer.begin_array().value( *parse( R"({"b":1,"a":2})", ParseOptions{ .ordered_objects = true } ) ).value( "x" ).end_array();
+    EXPECT_EQ( R"([{"b":1,"a":2},"x"])", json );
+
+    json.clear();
+    Writer( json ).value( 5 );
+    EXPECT_EQ( "5", json );
+
+    json.clear();
+    Writer( json ).value( *parse( "[1.50, 2e10]", ParseOptions{ .raw_numbers = true } ) );
+    EXPECT_EQ( "[1.50,2e10]", json );
+}
+
+TEST( Simple_json_writer_test, test_write_does_not_allocate )
+{
+    string json;
+    json.reserve( 1000 );
+
+    const AllocationCounts start = AllocationCounts::now();
+    {
+        Writer writer( json );
+        writer.begin_array();
+        for ( int i = 0; i < 20; ++i )
+        {
+            writer.value( i ).value( "s" );
+        }
+        writer.end_array();
+    }
+    const AllocationCounts used = AllocationCounts::now() - start;
+
+    EXPECT_EQ( 1u, used.allocations ); // the stack of one open array
+    EXPECT_TRUE( holds_alternative<Array>( *parse( json ) ) );
+}
+
+TEST( Simple_json_writer_test, test_misuse_is_caught_in_debug_builds )
+{
+    string json;
+    EXPECT_DEBUG_DEATH( Writer( json ).begin_object().value( 1 ), "without a key" );
+    EXPECT_DEBUG_DEATH( Writer( json ).begin_array().key( "a" ), "outside an object" );
+    EXPECT_DEBUG_DEATH( Writer( json ).begin_array().end_object(), "without begin_object" );
+    EXPECT_DEBUG_DEATH( Writer( json ).begin_object().key( "a" ).end_object(), "without a value" );
+    EXPECT_DEBUG_DEATH( Writer( json ).value( 1 ).value( 2 ), "more than one value" );
+}
+
+// run with --gtest_also_run_disabled_tests to compare building and formatting a Value with writing directly
+TEST( DISABLED_Simple_json_writer_test, test_write_speed )
+{
+    const int num_records = 500000;
+
+    const AllocationCounts build_counts = AllocationCounts::now();
+    auto start = chrono::steady_clock::now();
+    Array records;
+    for ( int i = 0; i < num_records; ++i )
+    {
+        records.push_back( Object{ { "id", i }, { "name", "record" }, { "active", i % 2 == 0 }, { "scores", Array{ i, i + 1, i + 2 } } } );
+    }
+    const string formatted = to_canonical_string( records );
+    const auto build_time = chrono::steady_clock::now() - start;
+    const AllocationCounts build_used = AllocationCounts::now() - build_counts;
+
+    const AllocationCounts write_counts = AllocationCounts::now();
+    start = chrono::steady_clock::now();
+    string written;
+    Writer writer( written );
+    writer.begin_array();
+    for ( int i = 0; i < num_records; ++i )
+    {
+        writer.begin_object().key( "active" ).value( i % 2 == 0 ).key( "id" ).value( i ).key( "name" ).value( "record" );
+        writer.key( "scores" ).begin_array().value( i ).value( i + 1 ).value( i + 2 ).end_array().end_object();
+    }
+    writer.end_array();
+    const auto write_time = chrono::steady_clock::now() - start;
+    const AllocationCounts write_used = AllocationCounts::now() - write_counts;
+
+    EXPECT_EQ( formatted, written );
+    cout << "build and format " << chrono::duration_cast<chrono::milliseconds>( build_time ) << ", " << build_used.allocations << " allocations\n"
+         << "writer           " << chrono::duration_cast<chrono::milliseconds>( write_time ) << ", " << write_used.allocations << " allocations\n";
+}